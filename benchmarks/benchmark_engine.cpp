@@ -3,10 +3,14 @@
 #include <catch2/catch_all.hpp>
 #include <fstream>
 #include <iostream>
+#include <random>
 
 #include "do-verify/interval_set.hpp"
 #include "do-verify/MTLEngine.hpp"
 #include "do-verify/binary_row_reader.hpp"
+#include "do-verify/lane_engine.hpp"
+#include "do-verify/spec_compiler.hpp"
+#include "do-verify/static_monitor.hpp"
 // wallgrind memory leak memcheck
 //scanbuild
 
@@ -566,4 +570,132 @@ TEST_CASE("Dense RespondGLB", "[dense_benchmarks][RespondGLB]") {
         });
         destroyHolder(holder);
     };
-}
\ No newline at end of file
+}
+TEST_CASE("Discrete Lanes", "[discrete_benchmarks][lanes]") {
+    using namespace db_interval_set;
+    using namespace do_verify;
+
+    // --- 1. SETUP DATA ---
+    // 64 traces on one timestamp grid, one bit per trace
+    const int STEPS = 10000;
+    spec_compiler::CompiledSpec spec = spec_compiler::compile("historically(({r} && !{q} && once{q}) -> ({p} since[3:40] {q}))");
+    std::vector<std::vector<uint64_t>> inputs(STEPS, std::vector<uint64_t>(spec.nodes.size(), 0));
+    std::mt19937_64 rng(7);
+    for (auto &step : inputs) {
+        for (size_t i = 0; i < spec.propositions.size(); i++) {
+            step[i] = rng();
+        }
+    }
+
+    // --- 2. RUN BENCHMARKS ---
+    BENCHMARK("64 scalar programs: " + std::to_string(STEPS) + " steps") {
+        IntervalSetHolder holder = newHolder(spec_compiler::holderSizeHint(spec));
+        int violations = 0;
+        for (int lane = 0; lane < 64; lane++) {
+            DiscreteProgram program = spec_compiler::makeDiscreteProgram(spec, holder);
+            std::vector<bool> laneInputs(spec.nodes.size(), false);
+            for (int time = 0; time < STEPS; time++) {
+                for (size_t i = 0; i < spec.propositions.size(); i++) laneInputs[i] = (inputs[time][i] >> lane) & 1;
+                violations += !run_evaluation(program, holder, time, laneInputs);
+                swapBuffers(holder);
+            }
+        }
+        destroyHolder(holder);
+        return violations;
+    };
+
+    BENCHMARK("One lane program: " + std::to_string(STEPS) + " steps") {
+        LaneProgram program = spec_compiler::makeLaneProgram(spec);
+        uint64_t violated = 0;
+        for (int time = 0; time < STEPS; time++) {
+            violated |= ~run_evaluation(program, time, inputs[time]);
+        }
+        return violated;
+    };
+}
+
+TEST_CASE("Discrete Blocks", "[discrete_benchmarks][blocks]") {
+    using namespace db_interval_set;
+    using namespace do_verify;
+
+    // --- 1. SETUP DATA ---
+    // One trace sampled at every integer time, as 64-step bit columns
+    const int BLOCKS = 10000;
+    spec_compiler::CompiledSpec spec = spec_compiler::compile("historically[:10]{p} -> once[1:20]{q}");
+    std::vector<std::vector<uint64_t>> columns(BLOCKS, std::vector<uint64_t>(spec.nodes.size(), 0));
+    std::mt19937_64 rng(7);
+    for (auto &block : columns) {
+        for (size_t i = 0; i < spec.propositions.size(); i++) {
+            const uint64_t bits = rng();
+            block[i] = bits | (bits << 1);
+        }
+    }
+
+    // --- 2. RUN BENCHMARKS ---
+    BENCHMARK("Scalar program: " + std::to_string(BLOCKS * 64) + " steps") {
+        IntervalSetHolder holder = newHolder(spec_compiler::holderSizeHint(spec));
+        DiscreteProgram program = spec_compiler::makeDiscreteProgram(spec, holder);
+        std::vector<bool> inputs(spec.nodes.size(), false);
+        int violations = 0;
+        for (int block = 0; block < BLOCKS; block++) {
+            for (int k = 0; k < 64; k++) {
+                for (size_t i = 0; i < spec.propositions.size(); i++) inputs[i] = (columns[block][i] >> k) & 1;
+                violations += !run_evaluation(program, holder, block * 64 + k, inputs);
+                swapBuffers(holder);
+            }
+        }
+        destroyHolder(holder);
+        return violations;
+    };
+
+    BENCHMARK("Block program: " + std::to_string(BLOCKS * 64) + " steps") {
+        BlockProgram program = spec_compiler::makeBlockProgram(spec);
+        int violations = 0;
+        for (int block = 0; block < BLOCKS; block++) {
+            violations += __builtin_popcountll(~run_evaluation(program, columns[block], 64));
+        }
+        return violations;
+    };
+}
+
+TEST_CASE("Discrete Static Monitors", "[discrete_benchmarks][static]") {
+    using namespace db_interval_set;
+    using namespace do_verify;
+    using namespace static_monitor;
+
+    // --- 1. SETUP DATA ---
+    const int STEPS = 1000000;
+    const std::string SPEC = "historically((once[:10]{q}) -> ((not{p}) since {q}))";
+    using AbsentAQ = Historically<0, INF, Implies<Once<0, 10, P<0>>, Since<0, INF, Not<P<1>>, P<0>>>>;
+
+    spec_compiler::CompiledSpec spec = spec_compiler::compile(SPEC);
+    std::vector<std::vector<bool>> inputs(STEPS, std::vector<bool>(spec.nodes.size(), false));
+    std::mt19937_64 rng(7);
+    for (auto &step : inputs) {
+        const uint64_t bits = rng();
+        step[0] = (bits & 15) == 0;
+        step[1] = (bits & 48) != 0;
+    }
+
+    // --- 2. RUN BENCHMARKS ---
+    BENCHMARK("Interpreter: " + std::to_string(STEPS) + " steps") {
+        IntervalSetHolder holder = newHolder(spec_compiler::holderSizeHint(spec));
+        DiscreteProgram program = spec_compiler::makeDiscreteProgram(spec, holder);
+        int violations = 0;
+        for (int time = 0; time < STEPS; time++) {
+            violations += !run_evaluation(program, holder, time, inputs[time]);
+            swapBuffers(holder);
+        }
+        destroyHolder(holder);
+        return violations;
+    };
+
+    BENCHMARK("Static monitor: " + std::to_string(STEPS) + " steps") {
+        AbsentAQ monitor{};
+        int violations = 0;
+        for (int time = 0; time < STEPS; time++) {
+            violations += !monitor.step(time, inputs[time]);
+        }
+        return violations;
+    };
+}
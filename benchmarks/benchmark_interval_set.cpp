@@ -12,6 +12,7 @@
 #include <boost/icl/interval_set.hpp>
 #include <boost/icl/right_open_interval.hpp> // For [start, end)
 #include "do-verify/interval_set.hpp"
+#include "do-verify/compact_set.hpp"
 
 
 // --- Our code to test ---
@@ -41,6 +42,26 @@ std::vector<Interval> generateRandomIntervals(int count, int maxStart, int maxDu
     return intervals;
 }
 
+/**
+ * @brief Generates 'count' disjoint intervals with random gaps and lengths in
+ * [1, maxGap]. Unlike generateRandomIntervals, the set keeps all of them, so
+ * set operations see 2 * count transitions per set.
+ */
+std::vector<Interval> generateDisjointIntervals(int count, int maxGap, unsigned seed) {
+    std::mt19937 gen(seed);
+    std::uniform_int_distribution<> gapDist(1, maxGap);
+
+    std::vector<Interval> intervals;
+    intervals.reserve(count);
+    int t = 0;
+    for (int i = 0; i < count; ++i) {
+        int start = t + gapDist(gen);
+        t = start + gapDist(gen);
+        intervals.push_back({start, t});
+    }
+    return intervals;
+}
+
 BoostSet createBoostSetFromIntervals(const std::vector<Interval>& intervals) {
     BoostSet set;
     for (const auto& iv : intervals) {
@@ -60,6 +81,10 @@ TEST_CASE("Performance Benchmarks", "[interval_set][basic]") {
     
     auto intervalsA = generateRandomIntervals(N_A, 50000, 100);
     auto intervalsB = generateRandomIntervals(N_B, 50000, 100);
+    // These overlap so much that A and B normalise to a handful of
+    // intervals, the disjoint ones keep all N_A and N_B
+    auto disjointA = generateDisjointIntervals(N_A, 20, 1);
+    auto disjointB = generateDisjointIntervals(N_B, 20, 2);
     
     // Create a very large holder for your library
     // Buffer needs to hold 2*N transitions (start/end) per set
@@ -73,15 +98,26 @@ TEST_CASE("Performance Benchmarks", "[interval_set][basic]") {
     // Build DBSet A and B
     auto dbSetA_t = createSetFromIntervals(holder, intervalsA);
     auto dbSetB_t = createSetFromIntervals(holder, intervalsB);
-    swapBuffers(holder); // Move both sets to readBuffer
+    auto dbDisjointA_t = createSetFromIntervals(holder, disjointA);
+    auto dbDisjointB_t = createSetFromIntervals(holder, disjointB);
+    swapBuffers(holder); // Move all sets to readBuffer
     
     // Create read-only handles to them
     IntervalSet dbSetA = {holder.readBuffer, dbSetA_t.startIndex, dbSetA_t.endIndex};
     IntervalSet dbSetB = {holder.readBuffer, dbSetB_t.startIndex, dbSetB_t.endIndex};
+    IntervalSet dbDisjointA = {holder.readBuffer, dbDisjointA_t.startIndex, dbDisjointA_t.endIndex};
+    IntervalSet dbDisjointB = {holder.readBuffer, dbDisjointB_t.startIndex, dbDisjointB_t.endIndex};
+
+    // Compact copies, and an output that keeps its capacity between runs
+    CompactSet compactA = toCompactSet(dbSetA);
+    CompactSet compactB = toCompactSet(dbSetB);
+    CompactSet compactOut;
 
     // Build BoostSet A and B
     BoostSet boostSetA = createBoostSetFromIntervals(intervalsA);
     BoostSet boostSetB = createBoostSetFromIntervals(intervalsB);
+    BoostSet boostDisjointA = createBoostSetFromIntervals(disjointA);
+    BoostSet boostDisjointB = createBoostSetFromIntervals(disjointB);
 
 
     // --- 3. RUN BENCHMARKS ---
@@ -107,6 +143,11 @@ TEST_CASE("Performance Benchmarks", "[interval_set][basic]") {
             holder.writeIndex = 0; // Reset output buffer
             return unionSets(holder, dbSetA, dbSetB);
         };
+
+        BENCHMARK("CompactSet: Union (N=" + std::to_string(N_A) + ", M=" + std::to_string(N_B) + ")") {
+            unionSets(compactA, compactB, compactOut);
+            return compactOut.times.size();
+        };
         
         BENCHMARK("Boost: Union (N=" + std::to_string(N_A) + ", M=" + std::to_string(N_B) + ")") {
             return boostSetA | boostSetB;
@@ -120,12 +161,67 @@ TEST_CASE("Performance Benchmarks", "[interval_set][basic]") {
             holder.writeIndex = 0; // Reset output buffer
             return intersectSets(holder, dbSetA, dbSetB);
         };
+
+        BENCHMARK("CompactSet: Intersect (N=" + std::to_string(N_A) + ", M=" + std::to_string(N_B) + ")") {
+            intersectSets(compactA, compactB, compactOut);
+            return compactOut.times.size();
+        };
         
         BENCHMARK("Boost: Intersect (N=" + std::to_string(N_A) + ", M=" + std::to_string(N_B) + ")") {
             return boostSetA & boostSetB;
         };
     }
 
+    SECTION("Union of disjoint sets") {
+        BENCHMARK("DBSet: Union of disjoint sets (N=" + std::to_string(N_A) + ", M=" + std::to_string(N_B) + ")") {
+            holder.writeIndex = 0;
+            return unionSets(holder, dbDisjointA, dbDisjointB);
+        };
+
+        BENCHMARK("Boost: Union of disjoint sets (N=" + std::to_string(N_A) + ", M=" + std::to_string(N_B) + ")") {
+            return boostDisjointA | boostDisjointB;
+        };
+    }
+
+    SECTION("Intersection of disjoint sets") {
+        BENCHMARK("DBSet: Intersect disjoint sets (N=" + std::to_string(N_A) + ", M=" + std::to_string(N_B) + ")") {
+            holder.writeIndex = 0;
+            return intersectSets(holder, dbDisjointA, dbDisjointB);
+        };
+
+        BENCHMARK("Boost: Intersect disjoint sets (N=" + std::to_string(N_A) + ", M=" + std::to_string(N_B) + ")") {
+            return boostDisjointA & boostDisjointB;
+        };
+    }
+
+    SECTION("Point queries") {
+        // Every 7th time point across the disjoint set, about 2 per interval
+        std::vector<Time> queryTimes;
+        for (Time t = 0; t < disjointA.back().end; t += 7) {
+            queryTimes.push_back(t);
+        }
+
+        BENCHMARK("DBSet: includes at " + std::to_string(queryTimes.size()) + " points") {
+            int hits = 0;
+            for (Time t : queryTimes) {
+                hits += includes(dbDisjointA, t);
+            }
+            return hits;
+        };
+
+        BENCHMARK("DBSet: includesEach at " + std::to_string(queryTimes.size()) + " points") {
+            return includesEach(dbDisjointA, queryTimes);
+        };
+
+        BENCHMARK("Boost: contains at " + std::to_string(queryTimes.size()) + " points") {
+            int hits = 0;
+            for (Time t : queryTimes) {
+                hits += boost::icl::contains(boostDisjointA, t);
+            }
+            return hits;
+        };
+    }
+
     // --- 4. CLEANUP ---
     destroyHolder(holder);
 }
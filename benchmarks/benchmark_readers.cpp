@@ -0,0 +1,46 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_all.hpp>
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "do-verify/json_reader.hpp"
+
+
+TEST_CASE("JSONL Parsing", "[readers][jsonl]") {
+    // --- 1. SETUP DATA ---
+    const int LINES = 100000;
+    std::string text;
+    for (int i = 0; i < LINES; i++) {
+        text += "{\"time\": " + std::to_string(i * 3) + ", \"q\": " + (i % 3 == 0 ? "true" : "false") +
+                ", \"p\": " + (i % 5 == 0 ? "true" : "false") + "}\n";
+    }
+
+    // --- 2. RUN BENCHMARKS ---
+    BENCHMARK("read_line: " + std::to_string(LINES) + " lines") {
+        std::istringstream input(text);
+        int sum = 0;
+        for (std::string line; std::getline(input, line);) {
+            sum += json_reader::read_line(line).time;
+        }
+        return sum;
+    };
+
+    BENCHMARK_ADVANCED("parseRows: " + std::to_string(LINES) + " lines")(Catch::Benchmark::Chronometer meter) {
+        auto parser = json_reader::newJsonlParser({"q", "p"});
+        std::vector<char> rows(parser.rowBytes * 4096);
+        meter.measure([&] {
+            size_t offset = 0;
+            size_t total = 0;
+            while (offset < text.size()) {
+                size_t consumed = 0;
+                total += json_reader::parseRows(parser, text.data() + offset, text.size() - offset, true,
+                                                rows.data(), 4096, consumed);
+                offset += consumed;
+            }
+            return total;
+        });
+    };
+}
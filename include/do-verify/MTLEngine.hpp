@@ -1,14 +1,17 @@
 #pragma once
 
+#include <cstdint>
 #include <vector>
 #include <algorithm>
 #include "do-verify/interval_set.hpp"
 #include <limits>
 
-#define B_INFINITY std::numeric_limits<int>::max()
+#define B_INFINITY std::numeric_limits<db_interval_set::Time>::max()
 
 namespace do_verify {
 
+using db_interval_set::Time;
+
 enum class NodeType {
     PROPOSITION,
     AND,
@@ -19,6 +22,40 @@ enum class NodeType {
     ALWAYS,
     SINCE,
     TEST,
+    // Kernels for once/historically backed by an IntervalWindow instead of
+    // the holder. The spec compiler picks them for both time models.
+    EVENTUALLY_WINDOW,
+    ALWAYS_WINDOW,
+    // Bounded future operators. The spec compiler rewrites eventually and
+    // always into once and historically over a delayed timeline, so only
+    // UNTIL reaches an interpreter, and only the dense ones.
+    FUTURE_EVENTUALLY,
+    FUTURE_ALWAYS,
+    UNTIL,
+    // Step operators, discrete time only. 'a' is how many steps back they
+    // look: 1 for PREVIOUS, RISE and FALL, k for DELAY[k].
+    PREVIOUS,
+    RISE,
+    FALL,
+    DELAY,
+};
+
+// Ring buffer of sorted, disjoint intervals. New intervals are only appended
+// at the back (merging with the last one when they touch) and expired ones
+// dropped from the front, which is all a once/historically state needs when
+// time only moves forward.
+struct IntervalWindow {
+    std::vector<db_interval_set::Interval> buffer;
+    unsigned int head;
+    unsigned int size;
+};
+
+// The last 'size' values of a discrete operand, one bit each, for the step
+// operators. Bit 'position' holds the oldest, which is the next to go.
+struct BitRing {
+    std::vector<uint64_t> words;
+    unsigned int size;
+    unsigned int position;
 };
 
 struct DenseNode {
@@ -27,13 +64,24 @@ struct DenseNode {
     NodeType type;
     unsigned int leftOperandIndex;
     unsigned int rightOperandIndex;
-    int a;
-    int b;
+    Time a;
+    Time b;
+    IntervalWindow window{}; // Only used by EVENTUALLY_WINDOW / ALWAYS_WINDOW / UNTIL
 };
 
-int add_with_inf(int a, int b);
+// a + b, where either being B_INFINITY or the sum overflowing gives B_INFINITY.
+// Inline and constexpr so the static monitors can saturate without a call.
+constexpr Time add_with_inf(Time a, Time b) {
+    Time sum = 0;
+    if (a == B_INFINITY || b == B_INFINITY || __builtin_add_overflow(a, b, &sum)) {
+        return B_INFINITY;
+    }
+    else {
+        return sum;
+    }
+}
 
-db_interval_set::IntervalSet run_evaluation(std::vector<DenseNode> &nodes, db_interval_set::IntervalSetHolder &setHolder, const int startTime, const int endTime, const std::vector<bool> &propositionInputs);
+db_interval_set::IntervalSet run_evaluation(std::vector<DenseNode> &nodes, db_interval_set::IntervalSetHolder &setHolder, const Time startTime, const Time endTime, const std::vector<bool> &propositionInputs);
 
 
 struct DiscreteNode {
@@ -42,11 +90,107 @@ struct DiscreteNode {
     NodeType type;
     unsigned int leftOperandIndex;
     unsigned int rightOperandIndex;
-    int a;
-    int b;
+    Time a;
+    Time b;
+    IntervalWindow window{}; // Only used by EVENTUALLY_WINDOW / ALWAYS_WINDOW
+    BitRing ring{};          // Only used by the step operators
+};
+
+IntervalWindow newWindow(unsigned int capacity);
+
+/**
+ * @brief Number of intervals a discrete once/historically[a:b] window can
+ * hold at once. The shifted intervals are b-a+1 long and only those ending
+ * after the current time are kept, so at most b/(b-a+2)+1 are disjoint.
+ * Dense windows obey the same bound: an operand interval [s, e) has e > s,
+ * so its shifted copy [s+a, e+b) is at least as long.
+ */
+constexpr unsigned int discreteWindowCapacity(Time a, Time b) {
+    if (b == B_INFINITY) {
+        return 1; // Every [t + a, inf) overlaps the previous one
+    }
+    // Unsigned 64-bit, so b - a + 2 can't overflow for b up to B_INFINITY - 1
+    const uint64_t capacity = static_cast<uint64_t>(b) / (static_cast<uint64_t>(b) - static_cast<uint64_t>(a) + 2) + 2;
+    return capacity < std::numeric_limits<unsigned int>::max() ? static_cast<unsigned int>(capacity)
+                                                               : std::numeric_limits<unsigned int>::max();
+}
+
+/**
+ * @brief Appends an interval whose start is not before any stored start.
+ * Grows the buffer if it is full, which a window made with
+ * discreteWindowCapacity() never is.
+ */
+void pushInterval(IntervalWindow &window, db_interval_set::Interval interval);
+
+/**
+ * @brief Drops every interval ending at or before 'time' and reports whether
+ * 'time' is covered by what is left.
+ */
+bool advanceWindow(IntervalWindow &window, Time time);
+
+BitRing newBitRing(unsigned int size);
+
+/**
+ * @brief Stores 'bit' as the newest value and returns the one stored 'size'
+ * steps earlier, 0 while fewer than 'size' have been stored.
+ */
+uint64_t shiftRing(BitRing &ring, uint64_t bit);
+
+bool run_evaluation(std::vector<DiscreteNode> &nodes, db_interval_set::IntervalSetHolder &setHolder, const Time time, const std::vector<bool> &propositionInputs);
+
+/**
+ * @brief Structure-of-arrays form of a dense node array. The interpreter's
+ * dispatch loop only streams through the opcode and operand arrays; bounds
+ * and states are touched by the temporal nodes alone. 'windows' is only
+ * sized for EVENTUALLY_WINDOW / ALWAYS_WINDOW / UNTIL nodes.
+ *
+ * UNTIL is evaluated b late: its output at t is left until[a:b] right at
+ * t - b, which only needs the operands up to t. Its window holds the
+ * verdicts worked out ahead of time, at most b - a past the step, and its
+ * state the run of the left operand still open at the end of the step.
+ */
+struct DenseProgram {
+    std::vector<NodeType> opcodes;
+    std::vector<unsigned int> leftOperands;
+    std::vector<unsigned int> rightOperands;
+    std::vector<Time> lowerBounds;
+    std::vector<Time> upperBounds;
+    std::vector<db_interval_set::IntervalSet> states;
+    std::vector<db_interval_set::IntervalSet> outputs;
+    std::vector<IntervalWindow> windows;
 };
 
+/**
+ * @brief Structure-of-arrays form of a discrete node array. Node outputs are
+ * packed one bit per node, so a whole step's verdicts fit in a few words.
+ * 'windows' is only sized for EVENTUALLY_WINDOW / ALWAYS_WINDOW nodes and
+ * 'rings' for the step operators.
+ */
+struct DiscreteProgram {
+    std::vector<NodeType> opcodes;
+    std::vector<unsigned int> leftOperands;
+    std::vector<unsigned int> rightOperands;
+    std::vector<Time> lowerBounds;
+    std::vector<Time> upperBounds;
+    std::vector<uint64_t> outputs; // Bit i of word i/64 is node i's output
+    std::vector<db_interval_set::IntervalSet> states;
+    std::vector<IntervalWindow> windows;
+    std::vector<BitRing> rings;
+};
+
+/**
+ * @brief A program of 'nodeCount' TEST nodes with empty states, to be filled
+ * in by the spec compiler.
+ */
+DenseProgram newDenseProgram(size_t nodeCount, db_interval_set::IntervalSetHolder &setHolder);
+DiscreteProgram newDiscreteProgram(size_t nodeCount, db_interval_set::IntervalSetHolder &setHolder);
+
+inline bool nodeOutput(const DiscreteProgram &program, unsigned int node) {
+    return (program.outputs[node >> 6] >> (node & 63)) & 1;
+}
+
+db_interval_set::IntervalSet run_evaluation(DenseProgram &program, db_interval_set::IntervalSetHolder &setHolder, const Time startTime, const Time endTime, const std::vector<bool> &propositionInputs);
 
-bool run_evaluation(std::vector<DiscreteNode> &nodes, db_interval_set::IntervalSetHolder &setHolder, const int time, const std::vector<bool> &propositionInputs);
+bool run_evaluation(DiscreteProgram &program, db_interval_set::IntervalSetHolder &setHolder, const Time time, const std::vector<bool> &propositionInputs);
 
 } // namespace do_verify
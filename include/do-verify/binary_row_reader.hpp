@@ -1,9 +1,13 @@
 #pragma once
 
+#include <algorithm>
 #include <iostream>
 #include <fstream>
 #include <vector>
+#include <cstddef>
 #include <cstdint> // For fixed width types (int32_t, etc.)
+#include <span>
+#include <stdexcept>
 #include <string>
 
 namespace binary_row_reader {
@@ -20,4 +24,177 @@ struct TimescalesInput {
 
 std::vector<TimescalesInput> readInputFile(std::string fileName);
 
+// A read-only, shared mapping of a .row.bin file. 'rows' points straight
+// into the page cache, so nothing is copied and pages are only faulted in
+// as evaluation reaches them.
+struct MappedInputFile {
+    std::span<const TimescalesInput> rows;
+    void *mapping;
+    size_t mappingLength;
+};
+
+/**
+ * @brief Maps a .row.bin file instead of reading it. The mapping is advised
+ * for sequential access (and huge pages where the kernel supports them for
+ * file mappings), and is shared with every other process mapping the file.
+ * Like readInputFile, a file that can't be opened yields no rows; a file
+ * shorter than its header count yields only the complete rows it holds.
+ */
+MappedInputFile mapInputFile(const std::string &fileName);
+
+void unmapInputFile(MappedInputFile &file);
+
+// --- Self-describing traces ---
+//
+// Version 1 layout, all integers in native (little-endian) byte order:
+//   char     magic[4]         "DVTR"
+//   uint16_t version          1
+//   uint16_t propositionCount
+//   uint32_t rowCount         0 when unknown, e.g. a live producer
+//   per proposition: uint8_t nameLength, then the name bytes
+//   rows: int32_t time, then ceil(propositionCount / 8) bytes holding
+//         proposition i in bit (i % 8) of byte (i / 8)
+//
+// Version 2 is the same with an int64_t time, so raw epoch timestamps in
+// microseconds or nanoseconds can be stored without rebasing them.
+//
+// Files without the magic are read as the original .row.bin layout, i.e.
+// a uint32_t count followed by TimescalesInput rows with propositions
+// p, q, r and s.
+
+constexpr char TRACE_MAGIC[4] = {'D', 'V', 'T', 'R'};
+constexpr uint16_t TRACE_VERSION = 1;
+constexpr uint16_t TRACE_VERSION_TIME64 = 2;
+
+/**
+ * @brief Thrown when a trace header is malformed or can't be bound to a spec.
+ */
+struct TraceFormatError : public std::runtime_error {
+    explicit TraceFormatError(const std::string &message);
+};
+
+// Where a proposition lives inside a row: it holds when
+// (row[byteOffset] & mask) != 0.
+struct PropositionSlot {
+    uint32_t byteOffset;
+    uint8_t mask;
+};
+
+struct TraceHeader {
+    std::vector<std::string> propositions;
+    std::vector<PropositionSlot> slots; // slots[i] belongs to propositions[i]
+    size_t rowBytes;   // Every row starts with its time
+    size_t timeBytes;  // sizeof(int32_t), or sizeof(int64_t) for version 2
+    uint32_t rowCount; // 0 when the header doesn't know
+    size_t dataOffset; // Where the first row starts
+};
+
+/**
+ * @brief Parses the header at the start of 'bytes'.
+ * @return false if 'length' bytes are not enough to hold the whole header.
+ * @throws TraceFormatError on an unknown version or malformed header.
+ */
+bool parseTraceHeader(const char *bytes, size_t length, TraceHeader &header);
+
+/**
+ * @brief Serialises a header for the given proposition names: version 1
+ * for 4-byte times, version 2 for 8-byte ones.
+ */
+std::string encodeTraceHeader(const std::vector<std::string> &propositions, uint32_t rowCount,
+                              size_t timeBytes = sizeof(int32_t));
+
+/**
+ * @brief Writes one row for a header with values.size() propositions and
+ * 'timeBytes' wide times. 'out' must have room for rowBytes of that header.
+ */
+void encodeRow(int64_t time, const std::vector<bool> &values, char *out, size_t timeBytes = sizeof(int32_t));
+
+/**
+ * @brief Looks up each name in the trace header, so rows can be decoded
+ * straight into the proposition order a compiled spec expects.
+ * @throws TraceFormatError if the trace lacks one of the names.
+ */
+std::vector<PropositionSlot> bindPropositions(const TraceHeader &header, const std::vector<std::string> &names);
+
+inline int64_t rowTime(const char *row, size_t timeBytes = sizeof(int32_t)) {
+    if (timeBytes == sizeof(int64_t)) {
+        int64_t time;
+        std::copy(row, row + sizeof(time), reinterpret_cast<char *>(&time));
+        return time;
+    }
+    int32_t time;
+    std::copy(row, row + sizeof(time), reinterpret_cast<char *>(&time));
+    return time;
+}
+
+inline bool rowValue(const char *row, PropositionSlot slot) {
+    return (static_cast<uint8_t>(row[slot.byteOffset]) & slot.mask) != 0;
+}
+
+// Consecutive rows of 'rowBytes' each.
+struct RowBatch {
+    const char *data;
+    size_t count;
+    size_t rowBytes;
+    size_t timeBytes = sizeof(int32_t);
+
+    const char *row(size_t index) const { return data + index * rowBytes; }
+    int64_t time(size_t index) const { return rowTime(row(index), timeBytes); }
+};
+
+// A mapped trace in either format, see mapInputFile for the mapping itself.
+struct MappedTrace {
+    TraceHeader header;
+    RowBatch rows;
+    void *mapping;
+    size_t mappingLength;
+};
+
+/**
+ * @brief Maps a trace file and parses its header. A file that can't be
+ * opened yields no rows; a truncated file yields its complete rows.
+ * @throws TraceFormatError on a malformed header.
+ */
+MappedTrace mapTraceFile(const std::string &fileName);
+
+void unmapTraceFile(MappedTrace &trace);
+
+// Incremental reader for trace data arriving on a file descriptor
+// (stdin, a FIFO, a socket or a plain file). Rows are read into one
+// reusable batch buffer, so memory stays constant however long the trace.
+struct RowStream {
+    int fd;
+    size_t batchRows;
+    std::vector<char> buffer;
+    TraceHeader header;
+    bool headerParsed;
+    size_t tailOffset;   // Where the bytes left over by the last read start
+    size_t tailBytes;    // How many there are
+    bool finished;
+    bool failed;         // Set when read() failed with something other than EINTR
+};
+
+/**
+ * @brief Starts reading rows from 'fd', which stays owned by the caller.
+ * A .row.bin count header is skipped rather than trusted, since a live
+ * producer can't know it; the stream ends at end of file.
+ */
+RowStream openRowStream(int fd, size_t batchRows);
+
+/**
+ * @brief Blocks until the trace header has arrived and parses it.
+ * @return false if the stream ended or failed first.
+ * @throws TraceFormatError on a malformed header.
+ */
+bool readStreamHeader(RowStream &stream);
+
+/**
+ * @brief Returns the next rows, at most batchRows of them, reading the
+ * header first if needed. Blocks only until at least one complete row is
+ * available, so a slow producer's rows are evaluated as soon as they
+ * arrive. An empty batch means the stream ended; a trailing partial row is
+ * dropped. The batch is valid until the next call.
+ */
+RowBatch readBatch(RowStream &stream);
+
 } // namespace binary_row_reader
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <vector>
+#include "do-verify/MTLEngine.hpp"
+
+namespace do_verify {
+
+/**
+ * Discrete evaluation of one trace 64 time steps at a time. Inputs and
+ * outputs are bit columns: bit k of a block's word is step k of the block.
+ * The trace must have a row at every integer time, so a step is one time
+ * unit and the bounds of once/historically/since count steps.
+ */
+
+/**
+ * Per-node state carried from one block to the next.
+ * once/historically: 'history' is a ring of the operand's last words, to
+ * delay it by the lower bound, and 'lastOne' the latest step at which the
+ * delayed operand held. The step operators only use 'history'. since[0:inf): 'carry' is the previous block's last
+ * verdict. Other since bounds step through the block one bit at a time and
+ * keep the right operand steps still in reach in 'candidates'.
+ */
+struct BlockState {
+    std::vector<uint64_t> history;
+    unsigned int head;
+    long long lastOne;
+    uint64_t carry;
+    std::deque<long long> candidates;
+};
+
+struct BlockProgram {
+    std::vector<NodeType> opcodes;
+    std::vector<unsigned int> leftOperands;
+    std::vector<unsigned int> rightOperands;
+    std::vector<Time> lowerBounds;
+    std::vector<Time> upperBounds;
+    std::vector<uint64_t> outputs; // One column word per node
+    std::vector<BlockState> states;
+    long long position;            // Step index of the next block's bit 0
+};
+
+/**
+ * @brief A program of 'nodeCount' TEST nodes, to be filled in by the spec
+ * compiler. Call resetBlockStates() after setting the bounds.
+ */
+BlockProgram newBlockProgram(size_t nodeCount);
+
+/**
+ * @brief Sizes every temporal node's state for its bounds and rewinds the
+ * program to the start of a trace.
+ */
+void resetBlockStates(BlockProgram &program);
+
+/**
+ * @brief Evaluates the next 'steps' (1 to 64) steps. propositionColumns[i]
+ * holds proposition node i's values for them. Only the last block of a trace
+ * may be shorter than 64; bits at and above 'steps' in the returned verdict
+ * column are undefined.
+ */
+uint64_t run_evaluation(BlockProgram &program, const std::vector<uint64_t> &propositionColumns, const unsigned int steps);
+
+} // namespace do_verify
@@ -0,0 +1,106 @@
+#pragma once
+
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "do-verify/interval_set.hpp"
+#include "do-verify/MTLEngine.hpp"
+#include "do-verify/spec_compiler.hpp"
+
+namespace checkpoint {
+
+// A monitor's live state between two rows: the temporal nodes' states, how
+// far into the trace it got and what it has reported so far. Restoring it
+// costs O(state) instead of replaying the trace.
+//
+// Binary layout, native byte order:
+//   char magic[4] "DVCK", uint16_t version 2, uint16_t mode (0 dense, 1 discrete)
+//   uint64_t spec fingerprint, uint64_t rows
+//   uint8_t violated, int64_t firstViolation
+//   int64_t previousTime, uint8_t hasPrevious, uint32_t n, uint8_t previousInputs[n]
+//   uint8_t hasRun, int64_t runStart, int64_t runEnd, uint8_t runValue
+//   int64_t outputOffset
+//   uint32_t nodes, then per node:
+//     uint32_t n, int64_t state[n][2], uint32_t m, int64_t window[m][2]
+//
+// Times are stored as int64_t whatever the build's Time, so a checkpoint
+// doesn't depend on DO_VERIFY_TIME64.
+
+constexpr char CHECKPOINT_MAGIC[4] = {'D', 'V', 'C', 'K'};
+constexpr uint16_t CHECKPOINT_VERSION = 2;
+
+/**
+ * @brief Thrown when a checkpoint can't be written, read, or doesn't belong
+ * to the spec and time model it is resumed with.
+ */
+struct CheckpointError : public std::runtime_error {
+    explicit CheckpointError(const std::string &message);
+};
+
+struct Snapshot {
+    uint16_t mode;           // Same values as verdict_writer::VerdictMode
+    uint64_t fingerprint;    // specFingerprint() of the spec being monitored
+    uint64_t rows;           // Rows consumed from the trace
+    bool violated;
+    db_interval_set::Time firstViolation;
+
+    // Dense only: the open segment, the rows since the inputs last changed,
+    // which holds until a row with other inputs arrives
+    db_interval_set::Time previousTime;
+    bool hasPrevious;
+    std::vector<bool> previousInputs;
+
+    // The verdict run still open, see verdict_writer::VerdictWriter
+    bool hasRun;
+    db_interval_set::Time runStart;
+    db_interval_set::Time runEnd;
+    bool runValue;
+    int64_t outputOffset;    // Verdict bytes already written, -1 if the sink can't seek
+
+    // Per node. A step operator's state is the set of ages, 1 being the
+    // last row, at which its operand held.
+    std::vector<std::vector<db_interval_set::Interval>> states;
+    std::vector<std::vector<db_interval_set::Interval>> windows; // Per node, window kernels only
+};
+
+/**
+ * @brief Hash of the compiled node array, so a snapshot is never resumed
+ * against a different spec.
+ */
+uint64_t specFingerprint(const spec_compiler::CompiledSpec &spec);
+
+std::vector<char> encodeSnapshot(const Snapshot &snapshot);
+
+/**
+ * @throws CheckpointError on a bad magic, unknown version or truncated data.
+ */
+Snapshot decodeSnapshot(const char *bytes, size_t length);
+
+/**
+ * @brief Writes the snapshot next to 'path' and renames it into place, so
+ * a crash mid-write leaves the previous checkpoint intact.
+ * @throws CheckpointError on I/O errors.
+ */
+void saveSnapshot(const std::string &path, const Snapshot &snapshot);
+
+/**
+ * @throws CheckpointError if the file can't be read or decoded.
+ */
+Snapshot loadSnapshot(const std::string &path);
+
+/**
+ * @brief Copies the node states of a program into 'snapshot'.
+ */
+void captureProgram(const do_verify::DiscreteProgram &program, Snapshot &snapshot);
+void captureProgram(const do_verify::DenseProgram &program, Snapshot &snapshot);
+
+/**
+ * @brief Rebuilds the node states of a freshly made program from 'snapshot'.
+ * The states are written into the holder's current step.
+ * @throws CheckpointError if the snapshot has a different number of nodes.
+ */
+void restoreProgram(do_verify::DiscreteProgram &program, db_interval_set::IntervalSetHolder &holder, const Snapshot &snapshot);
+void restoreProgram(do_verify::DenseProgram &program, db_interval_set::IntervalSetHolder &holder, const Snapshot &snapshot);
+
+} // namespace checkpoint
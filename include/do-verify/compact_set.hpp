@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include "do-verify/interval_set.hpp"
+
+namespace db_interval_set {
+
+// A normalised set as its sorted transition times alone. In a normalised
+// set starts and ends alternate, so times[2k] starts an interval and
+// times[2k + 1] ends it; dropping isStart halves a Transition, 8 bytes to 4
+// with 32-bit times and a padded 16 to 8 with 64-bit ones. Meant for sets
+// that outlive a holder step, e.g. large history states, where the
+// holder's copy-per-step would cost more than the vector.
+struct CompactSet {
+    std::vector<Time> times;
+};
+
+CompactSet toCompactSet(const IntervalSet &set);
+
+/**
+ * @brief Writes the set into the holder's current step as transitions.
+ */
+IntervalSet fromCompactSet(IntervalSetHolder &holder, const CompactSet &set);
+
+std::vector<Interval> toVectorIntervals(const CompactSet &set);
+
+bool includes(const CompactSet &set, Time time);
+
+/**
+ * @brief The same sweeps as the IntervalSet versions, reading and writing
+ * times only. 'out' is overwritten and keeps its capacity, so a long-lived
+ * output doesn't allocate once it is large enough. It must not alias
+ * either input.
+ */
+void unionSets(const CompactSet &setA, const CompactSet &setB, CompactSet &out);
+void intersectSets(const CompactSet &setA, const CompactSet &setB, CompactSet &out);
+void negateSet(const CompactSet &setA, Interval domain, CompactSet &out);
+
+// A CompactSet with the first time zigzag encoded and every later one as
+// the (positive) gap to the previous, each as a LEB128 varint. Gaps in
+// monitor states are mostly small, so a time takes one or two bytes
+// instead of four or eight.
+struct PackedSet {
+    std::vector<uint8_t> bytes;
+    uint32_t count; // Number of times
+};
+
+PackedSet packSet(const CompactSet &set);
+
+/**
+ * @brief Decodes 'packed' into 'out', overwriting it.
+ */
+void unpackSet(const PackedSet &packed, CompactSet &out);
+
+} // namespace db_interval_set
@@ -1,23 +1,33 @@
 #pragma once
 
 #include <algorithm>
+#include <cstdint>
 #include <vector>
 #include <limits>
 #include <iostream> // Included for operator<< helper
 
 namespace db_interval_set {
 
+// A time point. 32-bit by default, which keeps a Transition at 8 bytes.
+// Build with DO_VERIFY_TIME64 (the CMake option of the same name) for raw
+// microsecond or nanosecond epoch timestamps.
+#ifdef DO_VERIFY_TIME64
+using Time = int64_t;
+#else
+using Time = int32_t;
+#endif
+
 // The 'Interval' struct is just a plain data structure for the API.
 // It is NOT the internal storage format.
 struct Interval {
-    int start;
-    int end;
+    Time start;
+    Time end;
 };
 
 // This is the core internal data structure.
 // Represents a "half-interval" or a "transition point".
 struct Transition {
-    int time;
+    Time time;
     bool isStart; // true = start of an interval, false = end of an interval
 };
 
@@ -31,7 +41,17 @@ struct IntervalSetHolder {
     Transition *readBuffer;
     Transition *writeBuffer;
     int writeIndex;
-    int bufferSize;
+    int bufferSize;     // Capacity of writeBuffer
+    int readBufferSize; // Capacity of readBuffer
+
+    // Usage accounting. A step is everything written between two swapBuffers().
+    int retiredUsage;   // Transitions written this step into buffers that were outgrown
+    int peakUsage;      // Most transitions written in a single step so far
+
+    // Buffers outgrown during the current/previous step. Sets written into
+    // them stay readable until the buffer side is reused two swaps later.
+    std::vector<Transition*> retiredWriteBuffers;
+    std::vector<Transition*> retiredReadBuffers;
 };
 
 // --- THIS IS THE STRUCT YOU PROPOSED ---
@@ -56,7 +76,7 @@ struct SegmentIterator {
     // This holds the start time and state *for the next segment*.
     // The 'result' fields (leftTruthy, rightTruthy, interval) will
     // hold the data for the *completed* segment.
-    int currentSegmentStart;
+    Time currentSegmentStart;
     bool currentLeftTruthy;
     bool currentRightTruthy;
 };
@@ -64,19 +84,55 @@ struct SegmentIterator {
 
 IntervalSetHolder newHolder(int bufferSize);
 
+/**
+ * @brief Ends a step: the write buffer becomes the read buffer and writing
+ * restarts at index 0 of the other one. If the holder grew during the step,
+ * the new write buffer is resized to match here, while it holds no live sets.
+ */
 void swapBuffers(IntervalSetHolder &holder);
 
+/**
+ * @brief Makes room for 'count' more transitions in the write buffer.
+ * Every function that writes into the holder calls this first with an upper
+ * bound of what it writes. When the buffer is full, writing moves on to a
+ * buffer at least twice as large; the old one is kept alive so sets already
+ * written this step stay valid.
+ */
+void reserveTransitions(IntervalSetHolder &holder, int count);
+
+/**
+ * @brief Most transitions written in a single step since newHolder() or the
+ * last resetPeakUsage(), including the step in progress.
+ */
+int peakUsage(const IntervalSetHolder &holder);
+
+void resetPeakUsage(IntervalSetHolder &holder);
+
 IntervalSet empty(IntervalSetHolder &holder);
 
 /**
  * @brief Checks if a single time point is contained within the interval set.
  * Since intervals are [start, end), start is inclusive and end is exclusive.
+ * Costs O(log d) for an answer d transitions into the set.
  *
  * @param set The interval set to check.
  * @param time The time point to query.
  * @return true if the time point is in the set, false otherwise.
  */
-bool includes(const IntervalSet& set, int time);
+bool includes(const IntervalSet& set, Time time);
+
+/**
+ * @brief includes() for every time in 'times', which must be sorted
+ * ascending. One forward pass over the set answers all of them.
+ */
+std::vector<bool> includesEach(const IntervalSet& set, const std::vector<Time>& times);
+
+/**
+ * @brief The first time after 'time' at which membership in the set differs
+ * from membership at 'time', or std::numeric_limits<Time>::max() if it
+ * never does.
+ */
+Time nextChange(const IntervalSet& set, Time time);
 
 /**
  * @brief Creates a new set from a single [start, end) interval.
@@ -93,14 +149,56 @@ IntervalSet copySet(IntervalSetHolder& holder, IntervalSet set);
 
 /**
  * @brief Computes the union (OR) of two sets using a plane-sweep algorithm.
+ * When one set has at most 1/8 the transitions of the other, the sweep
+ * gallops through the larger one between the smaller one's intervals and
+ * copies the rest in bulk.
  */
 IntervalSet unionSets(IntervalSetHolder &holder, IntervalSet setA, IntervalSet setB);
 
 /**
- * @brief Computes the intersection (AND) of two sets.
+ * @brief Computes the intersection (AND) of two sets. Gallops like unionSets.
  */
 IntervalSet intersectSets(IntervalSetHolder &holder, IntervalSet setA, IntervalSet setB);
 
+/**
+ * @brief setA AND [interval.start, interval.end), without building the
+ * interval as a set. The cut points are found by binary search, so apart
+ * from copying the transitions it keeps this costs O(log n).
+ */
+IntervalSet clipToInterval(IntervalSetHolder &holder, IntervalSet setA, Interval interval);
+
+/**
+ * @brief setA OR [interval.start, interval.end), the same way as
+ * clipToInterval.
+ */
+IntervalSet unionWithInterval(IntervalSetHolder &holder, IntervalSet setA, Interval interval);
+
+// In-place variants. They edit the set where it lies when that is safe and
+// fall back to writing a new copy otherwise, so the caller must own the set
+// outright: no other live set may share its transitions.
+
+/**
+ * @brief set = set OR interval. In place when 'set' is the last thing
+ * written into the holder; an interval at the set's end then costs
+ * O(log n) and writes at most two transitions.
+ */
+void unionWithIntervalInPlace(IntervalSetHolder &holder, IntervalSet &set, Interval interval);
+
+/**
+ * @brief set = set AND interval. In place, without writing anything new,
+ * when 'set' lies in the current write buffer.
+ */
+void clipToIntervalInPlace(IntervalSetHolder &holder, IntervalSet &set, Interval interval);
+
+/**
+ * @brief output = output OR (set AND interval), where 'output' lies entirely
+ * at or before interval.start. Appends to 'output' when it is the last thing
+ * written, and copies it once otherwise. When 'set' is the last thing
+ * written and directly follows 'output', the result overwrites 'set', which
+ * must not be used afterwards.
+ */
+void appendClipped(IntervalSetHolder &holder, IntervalSet &output, IntervalSet set, Interval interval);
+
 /**
  * @brief Computes the negation of a set within a given domain.
  * This is (domain AND (NOT setA)).
@@ -6,6 +6,10 @@
 #include <fstream>
 #include <iostream>
 #include <cctype>
+#include <stdexcept>
+
+#include "do-verify/binary_row_reader.hpp"
+#include "do-verify/interval_set.hpp"
 
 namespace json_reader {
 
@@ -16,4 +20,87 @@ struct TimescalesInput {
 
 TimescalesInput read_line(std::string &line);
 
+/**
+ * @brief Thrown by parseRows on a line it can't parse. 'offset' is the byte
+ * offset into the buffer handed to parseRows.
+ */
+struct JsonlParseError : public std::runtime_error {
+    size_t offset;
+    JsonlParseError(const std::string &message, size_t offset);
+};
+
+// Parses JSONL traces straight into packed trace rows (see
+// binary_row_reader: a time as wide as db_interval_set::Time, then bit i
+// for propositions[i]).
+// Lines are flat objects with string keys and number, boolean or string
+// values; keys may come in any order and unknown keys are ignored. Every
+// line needs the time key, and propositions must be true or false; a
+// proposition a line leaves out is false, and a key a line repeats takes
+// its last value. Only whitespace may surround keys, colons and objects.
+struct JsonlParser {
+    std::vector<std::string> propositions;
+    std::string timeKey;
+    size_t timeBytes;
+    size_t rowBytes;
+
+    // The key of every field seen so far by position within a line, and the
+    // slot it maps to. Traces repeat their key order, so a key is normally
+    // matched with one compare against the cache instead of a lookup.
+    std::vector<std::string> fieldKeys;
+    std::vector<int> fieldSlots;
+    std::vector<bool> seen;  // Whether each proposition was a key in any line so far
+};
+
+JsonlParser newJsonlParser(const std::vector<std::string> &propositions, const std::string &timeKey = "time");
+
+/**
+ * @brief The propositions that no line parsed so far had as a key. They
+ * read as false throughout, which for a misspelled name is rarely intended.
+ */
+std::vector<std::string> missingPropositions(const JsonlParser &parser);
+
+/**
+ * @brief The packed trace header describing the rows parseRows writes.
+ */
+binary_row_reader::TraceHeader jsonlHeader(const JsonlParser &parser);
+
+/**
+ * @brief Parses complete lines of 'data' into 'rows', which has room for
+ * 'maxRows' rows of parser.rowBytes each. Structural characters are found
+ * 32 or 16 bytes at a time with AVX2 or SSE2 (picked at runtime), and
+ * nothing is allocated once the key cache is warm.
+ *
+ * @param atEnd Also parse a final line that has no trailing newline.
+ * @param consumed Set to the bytes of the lines that were parsed; the rest
+ * (a partial line, or lines past maxRows) should be passed in again.
+ * @return The number of rows written.
+ * @throws JsonlParseError on a malformed line.
+ */
+size_t parseRows(JsonlParser &parser, const char *data, size_t length, bool atEnd,
+                 char *rows, size_t maxRows, size_t &consumed);
+
+// Reads JSONL from a file descriptor and hands out packed rows, the JSONL
+// counterpart of binary_row_reader::RowStream. Both buffers are reused,
+// so memory stays constant however long the trace.
+struct JsonlStream {
+    int fd;
+    JsonlParser parser;
+    std::vector<char> text;  // Bytes read but not parsed yet start at textOffset
+    size_t textOffset;
+    size_t textBytes;
+    std::vector<char> rows;  // Room for batchRows parsed rows
+    size_t batchRows;
+    bool finished;
+    bool failed;
+};
+
+JsonlStream openJsonlStream(int fd, JsonlParser parser, size_t batchRows);
+
+/**
+ * @brief Returns the next parsed rows, at most batchRows of them. An empty
+ * batch means the stream ended. The batch is valid until the next call.
+ * @throws JsonlParseError on a malformed line.
+ */
+binary_row_reader::RowBatch readBatch(JsonlStream &stream);
+
 } // namespace json_reader
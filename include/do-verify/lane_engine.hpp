@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <vector>
+#include "do-verify/MTLEngine.hpp"
+
+namespace do_verify {
+
+/**
+ * Discrete evaluation of up to 64 traces at once. Every node's output is a
+ * word whose bit i is the verdict for trace (lane) i, so the boolean nodes
+ * are a single AND/OR/NOT for all lanes. The traces must share a timestamp
+ * grid: each step is one time for every lane. Lanes that carry no trace are
+ * don't-care bits.
+ */
+
+// Lanes in which an operand held at 'time'
+struct LaneEntry {
+    Time time;
+    uint64_t lanes;
+};
+
+/**
+ * Per-lane state of a once/historically/since[a:b] node, shared by all
+ * lanes because they step through the same times. Steps younger than a are
+ * 'pending'. Admitted steps are kept in a two-stack sliding window so the OR
+ * over the last b-a time units is amortised O(1). With an infinite b they
+ * are folded into 'sticky' instead. The step operators keep their
+ * operand's last k steps in 'pending'.
+ */
+struct LaneWindow {
+    std::deque<LaneEntry> pending;
+    std::vector<LaneEntry> front; // Oldest last, lanes = OR of it and every newer front entry
+    std::vector<LaneEntry> back;  // Newest last
+    uint64_t backLanes;           // OR of 'back'
+    uint64_t sticky;
+};
+
+struct LaneProgram {
+    std::vector<NodeType> opcodes;
+    std::vector<unsigned int> leftOperands;
+    std::vector<unsigned int> rightOperands;
+    std::vector<Time> lowerBounds;
+    std::vector<Time> upperBounds;
+    std::vector<uint64_t> outputs; // One word of lanes per node
+    std::vector<LaneWindow> windows;
+};
+
+/**
+ * @brief A program of 'nodeCount' TEST nodes with empty windows, to be
+ * filled in by the spec compiler.
+ */
+LaneProgram newLaneProgram(size_t nodeCount);
+
+/**
+ * @brief Evaluates one step for every lane. propositionLanes[i] holds the
+ * lanes in which proposition node i is true. Returns the root's lanes.
+ */
+uint64_t run_evaluation(LaneProgram &program, const Time time, const std::vector<uint64_t> &propositionLanes);
+
+} // namespace do_verify
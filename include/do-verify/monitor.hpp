@@ -0,0 +1,101 @@
+#pragma once
+
+#include <functional>
+#include <ostream>
+#include <string>
+#include <vector>
+#include "do-verify/binary_row_reader.hpp"
+#include "do-verify/checkpoint.hpp"
+#include "do-verify/interval_set.hpp"
+#include "do-verify/spec_compiler.hpp"
+#include "do-verify/verdict_writer.hpp"
+
+namespace monitor {
+
+// Hands out a trace one batch of rows at a time, an empty batch ends it.
+using RowSource = std::function<binary_row_reader::RowBatch()>;
+using InputSlots = std::vector<binary_row_reader::PropositionSlot>;
+
+struct TraceSummary {
+    size_t events;
+    bool violated;
+    db_interval_set::Time firstViolation; // Earliest time the spec doesn't hold, if violated
+};
+
+// Periodic checkpoints of a single monitored trace, see checkpoint.hpp
+struct Checkpointing {
+    size_t every;                       // Rows between checkpoints, 0 for none
+    std::string path;                   // Where checkpoints are stored
+    const checkpoint::Snapshot *resume; // State to continue from, or null
+};
+
+/**
+ * @brief Evaluates a whole trace in discrete time. The spec's propositions
+ * are read from each row through 'slots'. Verdicts go to 'verdicts' unless
+ * it is null. 'holder' is reused as is, so one holder can serve many traces.
+ *
+ * With 'checkpointing', the state is saved every 'every' rows, flushing the
+ * verdicts written so far first. When resuming, the rows the snapshot has
+ * already consumed are skipped without being evaluated, so 'nextBatch'
+ * must hand out the same trace from its start.
+ * @throws checkpoint::CheckpointError if a checkpoint can't be saved or
+ * doesn't match the spec and time model.
+ * @throws binary_row_reader::TraceFormatError if a row's time is not after
+ * the previous row's.
+ * @throws std::invalid_argument if spec_compiler::needsDenseTime(spec).
+ */
+TraceSummary runDiscrete(const spec_compiler::CompiledSpec &spec, const InputSlots &slots, const RowSource &nextBatch,
+                         db_interval_set::IntervalSetHolder &holder, verdict_writer::VerdictWriter *verdicts,
+                         const Checkpointing *checkpointing = nullptr);
+
+/**
+ * @brief Evaluates a whole trace in dense time, each row holding until the
+ * next one starts. Otherwise the same as runDiscrete.
+ *
+ * Rows that repeat the previous row's values are merged into one segment,
+ * so the engine steps once per input change, not once per row.
+ *
+ * A spec with future operators has its verdicts written spec.delay late,
+ * once the rows they depend on have arrived, so the verdicts for the
+ * trace's last spec.delay time units are never written.
+ * @throws binary_row_reader::TraceFormatError if a row's time is before the
+ * previous row's; rows may share a time.
+ * @throws std::invalid_argument if spec_compiler::needsDiscreteTime(spec).
+ */
+TraceSummary runDense(const spec_compiler::CompiledSpec &spec, const InputSlots &slots, const RowSource &nextBatch,
+                      db_interval_set::IntervalSetHolder &holder, verdict_writer::VerdictWriter *verdicts,
+                      const Checkpointing *checkpointing = nullptr);
+
+struct TraceReport {
+    std::string path;
+    TraceSummary summary;
+    int peakUsage;     // Holder peak for this trace alone
+    std::string error; // Empty when the trace was monitored successfully
+};
+
+/**
+ * @brief Replaces every directory in 'paths' by the regular files directly
+ * inside it, in name order. Other paths are kept as they are.
+ */
+std::vector<std::string> expandTracePaths(const std::vector<std::string> &paths);
+
+/**
+ * @brief Monitors independent traces against one spec on 'threads' workers.
+ * Traces are dealt out to per-worker queues up front. A worker that runs
+ * out steals from the others, so a few long traces don't leave the other
+ * cores idle. Each worker owns one IntervalSetHolder for all its traces.
+ * Files ending in .jsonl are parsed as JSONL, anything else as a binary
+ * trace. A trace that fails to load gets an error in its report and
+ * doesn't affect the others.
+ *
+ * @return One report per path, in the order of 'paths'.
+ */
+std::vector<TraceReport> monitorTraces(const spec_compiler::CompiledSpec &spec, const std::vector<std::string> &paths,
+                                       bool discrete, unsigned int threads);
+
+/**
+ * @brief Writes one tab-separated line per trace and a closing summary.
+ */
+void writeReport(std::ostream &out, const std::vector<TraceReport> &reports);
+
+} // namespace monitor
@@ -0,0 +1,153 @@
+#pragma once
+
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "do-verify/interval_set.hpp"
+#include "do-verify/MTLEngine.hpp"
+#include "do-verify/lane_engine.hpp"
+#include "do-verify/block_engine.hpp"
+
+namespace spec_compiler {
+
+/**
+ * @brief Thrown when a specification string cannot be parsed.
+ * 'position' is the character offset at which parsing failed.
+ */
+struct SpecParseError : public std::runtime_error {
+    size_t position;
+    SpecParseError(const std::string &message, size_t position);
+};
+
+// One node of the parsed formula tree. Operands are indices into
+// Formula::nodes, -1 when unused (NOT and the unary temporal operators only
+// use 'right', mirroring how run_evaluation reads them).
+struct FormulaNode {
+    do_verify::NodeType type;
+    std::string name; // Only set for PROPOSITION
+    int left;
+    int right;
+    db_interval_set::Time a;
+    db_interval_set::Time b;
+};
+
+struct Formula {
+    std::vector<FormulaNode> nodes;
+    int root;
+};
+
+// One node of a compiled program. Operand indices always point to earlier
+// entries, so the array can be handed to run_evaluation in order.
+struct SpecNode {
+    do_verify::NodeType type;
+    unsigned int leftOperandIndex;
+    unsigned int rightOperandIndex;
+    db_interval_set::Time a;
+    db_interval_set::Time b;
+};
+
+struct CompiledSpec {
+    std::vector<SpecNode> nodes;
+    // propositions[i] is the name read by node i. All PROPOSITION nodes come
+    // first because run_evaluation indexes propositionInputs by node index.
+    std::vector<std::string> propositions;
+    // How far the verdicts lag behind the trace: the last node's output at
+    // t is the verdict for t - delay. Zero unless the spec looks ahead.
+    db_interval_set::Time delay;
+};
+
+/**
+ * @brief Parses a reelay-style past MTL specification, e.g.
+ * "historically((once[:10]{q}) -> ((not{p}) since {q}))".
+ *
+ * Precedence from loosest to tightest: '->' (right associative), 'or'/'||',
+ * 'and'/'&&', 'since[a:b]' and 'until[a:b]', then the prefix operators
+ * 'not'/'!', 'once[a:b]', 'historically[a:b]', 'eventually[a:b]',
+ * 'always[a:b]' and the step operators 'pre', 'rise', 'fall' and
+ * 'delay[k]'. Bounds default to [0:inf), except that the future operators
+ * until, eventually and always need a finite upper bound.
+ *
+ * The step operators count rows: pre p held at the previous row, rise p
+ * holds where p does but not at the previous row, fall p the other way
+ * round, and delay[k] p held k rows back. Before the trace has that many
+ * rows they see p as false.
+ *
+ * @throws SpecParseError on malformed input.
+ */
+Formula parse(const std::string &spec);
+
+/**
+ * @brief Lowers a formula tree into a topologically ordered node array.
+ * Identical subtrees are hash-consed into a single node, so the result is a
+ * DAG in which e.g. every occurrence of once{q} is evaluated once per step.
+ *
+ * Future operators become past ones over a delayed timeline, see
+ * CompiledSpec::delay: eventually[a:b] and always[a:b] turn into
+ * once[0:b-a] and historically[0:b-a] b later, and until into an UNTIL
+ * node that runs b late.
+ * @throws SpecParseError if the delays add up past the largest Time.
+ */
+CompiledSpec lower(const Formula &formula);
+
+/**
+ * @brief parse() followed by lower().
+ */
+CompiledSpec compile(const std::string &spec);
+
+/**
+ * @brief Whether the spec can only be monitored in dense time: its verdicts
+ * are delayed, which would need a row at every time unit in discrete time,
+ * or it uses until.
+ */
+bool needsDenseTime(const CompiledSpec &spec);
+
+/**
+ * @brief Whether the spec can only be monitored in discrete time: the step
+ * operators have no meaning between rows.
+ */
+bool needsDiscreteTime(const CompiledSpec &spec);
+
+/**
+ * @brief Initial IntervalSetHolder size for a compiled spec: a few
+ * transitions per boolean node and more per temporal node, whose states
+ * are rewritten every step. The holder grows from there if a trace needs it.
+ */
+int holderSizeHint(const CompiledSpec &spec);
+
+/**
+ * @brief Instantiates fresh dense-time nodes for a compiled spec.
+ * once/historically are specialised to the EVENTUALLY_WINDOW/ALWAYS_WINDOW
+ * kernels, as for discrete time.
+ */
+std::vector<do_verify::DenseNode> makeDenseNodes(const CompiledSpec &spec, db_interval_set::IntervalSetHolder &holder);
+
+/**
+ * @brief Instantiates fresh discrete-time nodes for a compiled spec.
+ * once/historically are specialised to the EVENTUALLY_WINDOW/ALWAYS_WINDOW
+ * sliding-window kernels.
+ */
+std::vector<do_verify::DiscreteNode> makeDiscreteNodes(const CompiledSpec &spec, db_interval_set::IntervalSetHolder &holder);
+
+/**
+ * @brief makeDenseNodes() laid out as a structure-of-arrays program, with
+ * the same sliding-window specialisation.
+ */
+do_verify::DenseProgram makeDenseProgram(const CompiledSpec &spec, db_interval_set::IntervalSetHolder &holder);
+
+/**
+ * @brief makeDiscreteNodes() laid out as a structure-of-arrays program,
+ * with the same sliding-window specialisation.
+ */
+do_verify::DiscreteProgram makeDiscreteProgram(const CompiledSpec &spec, db_interval_set::IntervalSetHolder &holder);
+
+/**
+ * @brief Instantiates a fresh 64-lane discrete program for a compiled spec.
+ */
+do_verify::LaneProgram makeLaneProgram(const CompiledSpec &spec);
+
+/**
+ * @brief Instantiates a fresh 64-step block program for a compiled spec.
+ */
+do_verify::BlockProgram makeBlockProgram(const CompiledSpec &spec);
+
+} // namespace spec_compiler
@@ -0,0 +1,179 @@
+#pragma once
+
+#include <array>
+#include "do-verify/MTLEngine.hpp"
+
+/**
+ * Discrete monitors for specs known at build time. A formula is spelled as
+ * a type, e.g. historically((once[:10]{q}) -> ((not{p}) since {q})) is
+ *
+ *     Historically<0, INF, Implies<Once<0, 10, P<0>>, Since<0, INF, Not<P<1>>, P<0>>>>
+ *
+ * where P<i> reads input i. Each node holds its operands and its state by
+ * value, so a monitor is one object of fixed size and step() inlines into
+ * straight-line code with no dispatch. Verdicts match run_evaluation() over
+ * the interpreted DiscreteNode array; like the IntervalWindow kernels, time
+ * must strictly increase from step to step.
+ */
+namespace static_monitor {
+
+using db_interval_set::Time;
+
+constexpr Time INF = B_INFINITY;
+
+/**
+ * @brief IntervalWindow with its capacity fixed at compile time. The
+ * discrete kernels never hold more than discreteWindowCapacity() intervals.
+ */
+template <Time A, Time B>
+struct FixedWindow {
+    static constexpr unsigned int CAPACITY = do_verify::discreteWindowCapacity(A, B);
+
+    std::array<db_interval_set::Interval, CAPACITY> buffer{};
+    unsigned int head = 0;
+    unsigned int size = 0;
+
+    // Adds [time + A, time + B + 1), merging with the last interval if they
+    // touch. Both ends saturate at INF like the interpreter's windows.
+    void push(Time time) {
+        const Time start = do_verify::add_with_inf(time, A);
+        const Time end = do_verify::add_with_inf(time + 1, B);
+        if (size > 0) {
+            db_interval_set::Interval &last = buffer[(head + size - 1) % CAPACITY];
+            if (last.end >= start) {
+                last.end = std::max(last.end, end);
+                return;
+            }
+        }
+        buffer[(head + size) % CAPACITY] = {start, end};
+        size++;
+    }
+
+    void clear() {
+        size = 0;
+    }
+
+    // Drops the intervals ending at or before 'time' and reports whether it is covered.
+    bool advance(Time time) {
+        while (size > 0 && buffer[head].end <= time) {
+            head = head + 1 == CAPACITY ? 0 : head + 1;
+            size--;
+        }
+        return size > 0 && buffer[head].start <= time;
+    }
+};
+
+template <unsigned int Index>
+struct P {
+    template <class Inputs>
+    bool step(Time, const Inputs &inputs) {
+        return inputs[Index];
+    }
+};
+
+template <class X>
+struct Not {
+    X operand;
+
+    template <class Inputs>
+    bool step(Time time, const Inputs &inputs) {
+        return !operand.step(time, inputs);
+    }
+};
+
+// Both operands always step, their states have to see every time point.
+template <class L, class R>
+struct And {
+    L left;
+    R right;
+
+    template <class Inputs>
+    bool step(Time time, const Inputs &inputs) {
+        bool l = left.step(time, inputs);
+        bool r = right.step(time, inputs);
+        return l && r;
+    }
+};
+
+template <class L, class R>
+struct Or {
+    L left;
+    R right;
+
+    template <class Inputs>
+    bool step(Time time, const Inputs &inputs) {
+        bool l = left.step(time, inputs);
+        bool r = right.step(time, inputs);
+        return l || r;
+    }
+};
+
+template <class L, class R>
+struct Implies {
+    L left;
+    R right;
+
+    template <class Inputs>
+    bool step(Time time, const Inputs &inputs) {
+        bool l = left.step(time, inputs);
+        bool r = right.step(time, inputs);
+        return !l || r;
+    }
+};
+
+// once[A:B] X
+template <Time A, Time B, class X>
+struct Once {
+    static_assert(0 <= A && A <= B, "once needs 0 <= a <= b");
+    X operand;
+    FixedWindow<A, B> window;
+
+    template <class Inputs>
+    bool step(Time time, const Inputs &inputs) {
+        if (operand.step(time, inputs)) {
+            window.push(time);
+        }
+        return window.advance(time);
+    }
+};
+
+// historically[A:B] X, i.e. not once[A:B] not X
+template <Time A, Time B, class X>
+struct Historically {
+    static_assert(0 <= A && A <= B, "historically needs 0 <= a <= b");
+    X operand;
+    FixedWindow<A, B> window;
+
+    template <class Inputs>
+    bool step(Time time, const Inputs &inputs) {
+        if (!operand.step(time, inputs)) {
+            window.push(time);
+        }
+        return !window.advance(time);
+    }
+};
+
+// L since[A:B] R. A failing L forgets every earlier R, so the state is the
+// same window as once over R, cleared whenever L fails.
+template <Time A, Time B, class L, class R>
+struct Since {
+    static_assert(0 <= A && A <= B, "since needs 0 <= a <= b");
+    L left;
+    R right;
+    FixedWindow<A, B> window;
+
+    template <class Inputs>
+    bool step(Time time, const Inputs &inputs) {
+        bool l = left.step(time, inputs);
+        bool r = right.step(time, inputs);
+        if (!l) {
+            window.clear();
+        }
+        if (r) {
+            window.push(time);
+        }
+        return window.advance(time);
+    }
+};
+
+} // namespace static_monitor
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "do-verify/interval_set.hpp"
+
+namespace verdict_writer {
+
+// Verdicts are written as runs, so output grows with the number of verdict
+// changes rather than with the number of events.
+//
+// Text sinks get one run per line:
+//   dense:    "[start, end)"            an interval where the spec holds
+//   discrete: "[first, last] true"      consecutive events with one verdict
+//
+// Binary sinks get a header, then packed records in native byte order:
+//   char magic[4] "DVVD", uint16_t version 1, uint16_t mode (0 dense, 1 discrete)
+//   dense:    int32_t start, int32_t end
+//   discrete: int32_t first, int32_t last, uint8_t verdict
+// Builds with DO_VERIFY_TIME64 write version 2, whose times are int64_t.
+
+enum class VerdictFormat {
+    TEXT,
+    BINARY,
+};
+
+enum class VerdictMode : uint16_t {
+    DENSE = 0,
+    DISCRETE = 1,
+};
+
+constexpr char VERDICT_MAGIC[4] = {'D', 'V', 'V', 'D'};
+constexpr uint16_t VERDICT_VERSION = 1;
+constexpr uint16_t VERDICT_VERSION_TIME64 = 2;
+
+struct VerdictWriter {
+    int fd;
+    VerdictFormat format;
+    VerdictMode mode;
+    std::vector<char> buffer; // Flushed to fd whenever the next record doesn't fit
+    size_t used;
+
+    // The run still being extended. Dense: [runStart, runEnd). Discrete:
+    // events from runStart to runEnd inclusive, all with verdict runValue.
+    bool hasRun;
+    db_interval_set::Time runStart;
+    db_interval_set::Time runEnd;
+    bool runValue;
+
+    bool failed; // Set when write() failed; later output is dropped
+};
+
+/**
+ * @brief Creates a writer for 'fd', which stays owned by the caller.
+ * Binary sinks get their header right away.
+ */
+VerdictWriter newVerdictWriter(int fd, VerdictFormat format, VerdictMode mode, size_t bufferBytes);
+
+/**
+ * @brief Like newVerdictWriter, but for a sink that already holds the start
+ * of this output, e.g. when resuming from a checkpoint: no header is written.
+ */
+VerdictWriter continueVerdictWriter(int fd, VerdictFormat format, VerdictMode mode, size_t bufferBytes);
+
+/**
+ * @brief Adds the verdict of one dense step. Intervals touching the open
+ * run extend it instead of producing a new record.
+ */
+void writeDense(VerdictWriter &writer, const db_interval_set::IntervalSet &output);
+
+/**
+ * @brief Adds the verdict of one discrete event.
+ */
+void writeDiscrete(VerdictWriter &writer, db_interval_set::Time time, bool verdict);
+
+/**
+ * @brief Writes out every closed run. The open run stays in the writer, so
+ * later verdicts can still extend it.
+ */
+void flushVerdicts(VerdictWriter &writer);
+
+/**
+ * @brief Writes the open run and flushes the buffer.
+ */
+void finishVerdicts(VerdictWriter &writer);
+
+} // namespace verdict_writer
@@ -2,16 +2,277 @@
 
 namespace do_verify {
 
-int add_with_inf(int a, int b) {
-    if (a == B_INFINITY || b == B_INFINITY) {
-        return B_INFINITY;
+IntervalWindow newWindow(unsigned int capacity) {
+    return IntervalWindow{std::vector<db_interval_set::Interval>(std::max(capacity, 1u)), 0, 0};
+}
+
+void pushInterval(IntervalWindow &window, db_interval_set::Interval interval) {
+    unsigned int capacity = static_cast<unsigned int>(window.buffer.size());
+    if (window.size > 0) {
+        db_interval_set::Interval &last = window.buffer[(window.head + window.size - 1) % capacity];
+        if (last.end >= interval.start) {
+            last.end = std::max(last.end, interval.end);
+            return;
+        }
+    }
+    if (window.size == capacity) {
+        // Unroll the ring into a buffer twice as large
+        std::vector<db_interval_set::Interval> grown(capacity * 2);
+        for (unsigned int i = 0; i < window.size; i++) {
+            grown[i] = window.buffer[(window.head + i) % capacity];
+        }
+        window.buffer.swap(grown);
+        window.head = 0;
+        capacity *= 2;
+    }
+    window.buffer[(window.head + window.size) % capacity] = interval;
+    window.size++;
+}
+
+bool advanceWindow(IntervalWindow &window, Time time) {
+    unsigned int capacity = static_cast<unsigned int>(window.buffer.size());
+    while (window.size > 0 && window.buffer[window.head].end <= time) {
+        window.head = window.head + 1 == capacity ? 0 : window.head + 1;
+        window.size--;
+    }
+    return window.size > 0 && window.buffer[window.head].start <= time;
+}
+
+BitRing newBitRing(unsigned int size) {
+    return BitRing{std::vector<uint64_t>((size + 63) / 64, 0), size, 0};
+}
+
+uint64_t shiftRing(BitRing &ring, uint64_t bit) {
+    uint64_t &word = ring.words[ring.position >> 6];
+    const unsigned int shift = ring.position & 63;
+    const uint64_t oldest = (word >> shift) & 1;
+    word ^= (oldest ^ bit) << shift;
+    ring.position = ring.position + 1 == ring.size ? 0 : ring.position + 1;
+    return oldest;
+}
+
+namespace {
+
+// --- Operator steps shared by the node-array and program interpreters ---
+
+// EVENTUALLY and ALWAYS only add [t + a, t' + b) to the state in a segment
+// [t, t'), which lies at or after the segment since a >= 0. So the state
+// never changes over a segment once the sweep has passed it, and the
+// outputs of all segments can be read off the final state at once.
+
+db_interval_set::IntervalSet denseEventually(db_interval_set::IntervalSetHolder &setHolder, db_interval_set::IntervalSet &state,
+                                             db_interval_set::IntervalSet rightOutput, Time a, Time b, Time startTime, Time endTime) {
+    auto iterator = db_interval_set::createSegmentIterator(db_interval_set::empty(setHolder), rightOutput, {startTime, endTime});
+    while (db_interval_set::getNextSegment(iterator)) {
+        if (iterator.interval.end == iterator.interval.start) continue;
+        if (iterator.rightTruthy) {
+            db_interval_set::unionWithIntervalInPlace(setHolder, state,
+                {add_with_inf(iterator.interval.start, a), add_with_inf(iterator.interval.end, b)});
+        }
+    }
+    auto output = db_interval_set::clipToInterval(setHolder, state, {startTime, endTime});
+    db_interval_set::clipToIntervalInPlace(setHolder, state, {endTime, B_INFINITY});
+    return output;
+}
+
+db_interval_set::IntervalSet denseAlways(db_interval_set::IntervalSetHolder &setHolder, db_interval_set::IntervalSet &state,
+                                         db_interval_set::IntervalSet rightOutput, Time a, Time b, Time startTime, Time endTime) {
+    auto iterator = db_interval_set::createSegmentIterator(db_interval_set::empty(setHolder), rightOutput, {startTime, endTime});
+    while (db_interval_set::getNextSegment(iterator)) {
+        if (iterator.interval.end == iterator.interval.start) continue;
+        if (!iterator.rightTruthy) {
+            db_interval_set::unionWithIntervalInPlace(setHolder, state,
+                {add_with_inf(iterator.interval.start, a), add_with_inf(iterator.interval.end, b)});
+        }
+    }
+    auto output = startTime < endTime ? db_interval_set::negateSet(setHolder, state, {startTime, endTime})
+                                      : db_interval_set::empty(setHolder);
+    db_interval_set::clipToIntervalInPlace(setHolder, state, {endTime, B_INFINITY});
+    return output;
+}
+
+// SINCE also resets the state, which ends what it says about the segments
+// since the last reset. Each such run of segments is appended to the output
+// when it ends instead of once per segment.
+db_interval_set::IntervalSet denseSince(db_interval_set::IntervalSetHolder &setHolder, db_interval_set::IntervalSet &state,
+                                        db_interval_set::IntervalSet leftOutput, db_interval_set::IntervalSet rightOutput,
+                                        Time a, Time b, Time startTime, Time endTime) {
+    auto output = db_interval_set::empty(setHolder);
+    Time runStart = startTime;
+
+    auto iterator = db_interval_set::createSegmentIterator(leftOutput, rightOutput, {startTime, endTime});
+    while (db_interval_set::getNextSegment(iterator)) {
+        if (iterator.interval.end == iterator.interval.start) continue;
+        if (iterator.leftTruthy && iterator.rightTruthy) {
+            db_interval_set::unionWithIntervalInPlace(setHolder, state,
+                {add_with_inf(iterator.interval.start, a), add_with_inf(iterator.interval.end, b)});
+        }
+        else if (!iterator.leftTruthy && iterator.rightTruthy) {
+            // The new state starts after this segment, so it adds nothing here
+            db_interval_set::appendClipped(setHolder, output, state, {runStart, iterator.interval.start});
+            state = db_interval_set::fromInterval(setHolder, {add_with_inf(iterator.interval.end, a), add_with_inf(iterator.interval.end, b)});
+            runStart = iterator.interval.start;
+        }
+        else if (iterator.leftTruthy && !iterator.rightTruthy) {
+        }
+        else {
+            db_interval_set::appendClipped(setHolder, output, state, {runStart, iterator.interval.start});
+            state = db_interval_set::empty(setHolder);
+            runStart = iterator.interval.start;
+        }
+    }
+    // The state outlives the step, so it is clipped first and the last run
+    // is appended without overwriting it
+    auto remaining = db_interval_set::clipToInterval(setHolder, state, {endTime, B_INFINITY});
+    db_interval_set::appendClipped(setHolder, output, state, {runStart, endTime});
+    state = remaining;
+    return output;
+}
+
+bool discreteEventually(db_interval_set::IntervalSetHolder &setHolder, db_interval_set::IntervalSet &state,
+                        bool rightOutput, Time a, Time b, Time time) {
+    if (rightOutput) {
+        db_interval_set::unionWithIntervalInPlace(setHolder, state,
+            {add_with_inf(time, a), add_with_inf(time + 1, b)});
+    }
+    bool output = db_interval_set::includes(state, time);
+    db_interval_set::clipToIntervalInPlace(setHolder, state, {time + 1, B_INFINITY});
+    return output;
+}
+
+bool discreteSince(db_interval_set::IntervalSetHolder &setHolder, db_interval_set::IntervalSet &state,
+                   bool leftOutput, bool rightOutput, Time a, Time b, Time time) {
+    if (leftOutput && rightOutput) {
+        db_interval_set::unionWithIntervalInPlace(setHolder, state,
+            {add_with_inf(time, a), add_with_inf(time + 1, b)});
+    }
+    else if (!leftOutput && rightOutput) {
+        state = db_interval_set::fromInterval(setHolder, {add_with_inf(time, a), add_with_inf(time + 1, b)});
+    }
+    else if (leftOutput && !rightOutput) {
+
     }
     else {
-        return a + b;
+        state = db_interval_set::empty(setHolder);
+    }
+    bool output = db_interval_set::includes(state, time);
+    db_interval_set::clipToIntervalInPlace(setHolder, state, {time + 1, B_INFINITY});
+    return output;
+}
+
+// Same verdict as the EVENTUALLY step: the window holds the union of
+// [t + a, t + b + 1) over every t where the operand held.
+bool windowEventually(IntervalWindow &window, bool rightOutput, Time a, Time b, Time time) {
+    if (rightOutput) {
+        pushInterval(window, {add_with_inf(time, a), add_with_inf(time + 1, b)});
+    }
+    return advanceWindow(window, time);
+}
+
+// Writes the part of the window inside [startTime, endTime), or with
+// 'negated' the part of [startTime, endTime) it leaves uncovered, then drops
+// the intervals the step has passed.
+db_interval_set::IntervalSet writeWindow(db_interval_set::IntervalSetHolder &setHolder, IntervalWindow &window,
+                                         bool negated, Time startTime, Time endTime) {
+    db_interval_set::reserveTransitions(setHolder, 2 * static_cast<int>(window.size) + 2);
+    const int newStartIndex = setHolder.writeIndex;
+    db_interval_set::Transition *written = setHolder.writeBuffer + newStartIndex;
+    const unsigned int capacity = static_cast<unsigned int>(window.buffer.size());
+    Time uncovered = startTime;
+    for (unsigned int i = 0, slot = window.head; i < window.size; i++, slot = slot + 1 == capacity ? 0 : slot + 1) {
+        const db_interval_set::Interval &interval = window.buffer[slot];
+        if (interval.start >= endTime) break;
+        const Time from = std::max(interval.start, startTime);
+        const Time to = std::min(interval.end, endTime);
+        if (from >= to) continue;
+        if (!negated) {
+            *written++ = db_interval_set::Transition{from, true};
+            *written++ = db_interval_set::Transition{to, false};
+        } else {
+            if (uncovered < from) {
+                *written++ = db_interval_set::Transition{uncovered, true};
+                *written++ = db_interval_set::Transition{from, false};
+            }
+            uncovered = to;
+        }
+    }
+    if (negated && uncovered < endTime) {
+        *written++ = db_interval_set::Transition{uncovered, true};
+        *written++ = db_interval_set::Transition{endTime, false};
+    }
+    setHolder.writeIndex = static_cast<int>(written - setHolder.writeBuffer);
+
+    advanceWindow(window, endTime);
+    return db_interval_set::IntervalSet{setHolder.writeBuffer, newStartIndex, setHolder.writeIndex - 1};
+}
+
+// Dense EVENTUALLY (or, negated, ALWAYS) over an IntervalWindow. The
+// shifted operand intervals arrive in time order, so each one merges with
+// the back of the window or is appended, and the step's end drops the
+// intervals it has passed from the front.
+db_interval_set::IntervalSet windowDense(db_interval_set::IntervalSetHolder &setHolder, IntervalWindow &window,
+                                         db_interval_set::IntervalSet rightOutput, bool negated,
+                                         Time a, Time b, Time startTime, Time endTime) {
+    auto iterator = db_interval_set::createSegmentIterator(db_interval_set::empty(setHolder), rightOutput, {startTime, endTime});
+    while (db_interval_set::getNextSegment(iterator)) {
+        if (iterator.interval.end == iterator.interval.start) continue;
+        if (iterator.rightTruthy != negated) {
+            pushInterval(window, {add_with_inf(iterator.interval.start, a), add_with_inf(iterator.interval.end, b)});
+        }
+    }
+    return writeWindow(setHolder, window, negated, startTime, endTime);
+}
+
+// Dense UNTIL, b late. left until[a:b] right holds at t when right holds at
+// some s in [t + a, t + b] and left holds over [t, s). For a right segment
+// [s, e) inside a left run that started at runStart, that is every t in
+// [max(runStart, s - b), e - a), so the output gets [max(runStart + b, s),
+// e + b - a). A right segment that starts just as the run ends still counts
+// at its first point, and with a = 0 right alone is enough. Every interval
+// pushed starts at or after the segment it came from, so the window holds
+// the final output up to endTime, and the pushes arrive in time order.
+db_interval_set::IntervalSet denseUntil(db_interval_set::IntervalSetHolder &setHolder, db_interval_set::IntervalSet &state,
+                                        IntervalWindow &window, db_interval_set::IntervalSet leftOutput,
+                                        db_interval_set::IntervalSet rightOutput, Time a, Time b, Time startTime, Time endTime) {
+    auto push = [&window](Time from, Time to) {
+        if (from < to) pushInterval(window, {from, to});
+    };
+    // The state is the left run still open at the end of the last step
+    bool inRun = state.startIndex <= state.endIndex && state.buffer[state.endIndex].time == startTime;
+    Time runStart = inRun ? state.buffer[state.startIndex].time : startTime;
+
+    auto iterator = db_interval_set::createSegmentIterator(leftOutput, rightOutput, {startTime, endTime});
+    while (db_interval_set::getNextSegment(iterator)) {
+        const Time start = iterator.interval.start;
+        const Time end = iterator.interval.end;
+        if (end == start) continue;
+        if (iterator.leftTruthy) {
+            if (!inRun) {
+                runStart = start;
+                inRun = true;
+            }
+            if (iterator.rightTruthy) {
+                push(std::max(add_with_inf(runStart, b), start), add_with_inf(end, b - a));
+            }
+            continue;
+        }
+        if (iterator.rightTruthy) {
+            if (inRun) {
+                push(std::max(add_with_inf(runStart, b), start), add_with_inf(start, b - a));
+            }
+            if (a == 0) {
+                push(add_with_inf(start, b), add_with_inf(end, b));
+            }
+        }
+        inRun = false;
     }
+    state = inRun ? db_interval_set::fromInterval(setHolder, {runStart, endTime}) : db_interval_set::empty(setHolder);
+    return writeWindow(setHolder, window, false, startTime, endTime);
 }
 
-db_interval_set::IntervalSet run_evaluation(std::vector<DenseNode> &nodes, db_interval_set::IntervalSetHolder &setHolder, const int startTime, const int endTime, const std::vector<bool> &propositionInputs) {
+} // namespace
+
+db_interval_set::IntervalSet run_evaluation(std::vector<DenseNode> &nodes, db_interval_set::IntervalSetHolder &setHolder, const Time startTime, const Time endTime, const std::vector<bool> &propositionInputs) {
     for(size_t node_index = 0; node_index < nodes.size(); node_index++) {
         DenseNode &curNode = nodes[node_index];
         switch (curNode.type)
@@ -45,92 +306,34 @@ db_interval_set::IntervalSet run_evaluation(std::vector<DenseNode> &nodes, db_in
             curNode.output = db_interval_set::unionSets(setHolder, notLeft, right);
             break;
         } 
-        
         case NodeType::EVENTUALLY:
-            {
-            auto rightOutput = nodes[curNode.rightOperandIndex].output;
-
-            curNode.output = db_interval_set::empty(setHolder);
-
-            auto iterator = db_interval_set::createSegmentIterator(db_interval_set::empty(setHolder), rightOutput, {startTime, endTime});
-            int i = 0;
-            while (db_interval_set::getNextSegment(iterator)) {
-                if (iterator.interval.end == iterator.interval.start) continue;
-                if (iterator.rightTruthy) {
-                    curNode.state = db_interval_set::unionSets(setHolder, curNode.state,
-                        db_interval_set::fromInterval(setHolder, {iterator.interval.start + curNode.a, add_with_inf(iterator.interval.end, curNode.b)}));
-                    int a = 0;
-                    (void)a; // Suppress unused variable warning
-                }
-                i++;
-                
-
-                auto segmentOutput = db_interval_set::intersectSets(setHolder, curNode.state,
-                    db_interval_set::fromInterval(setHolder, {iterator.interval.start, iterator.interval.end}));
-                curNode.output = db_interval_set::unionSets(setHolder, curNode.output, segmentOutput);
-                
-            }
-            curNode.state = db_interval_set::intersectSets(setHolder, curNode.state,
-                db_interval_set::fromInterval(setHolder, {endTime, B_INFINITY}));
+            curNode.output = denseEventually(setHolder, curNode.state, nodes[curNode.rightOperandIndex].output,
+                                             curNode.a, curNode.b, startTime, endTime);
             break;
-        }
         case NodeType::ALWAYS:
-            {
-            auto rightOutput = nodes[curNode.rightOperandIndex].output;
-
-            curNode.output = db_interval_set::empty(setHolder);
-
-            auto iterator = db_interval_set::createSegmentIterator(db_interval_set::empty(setHolder), rightOutput, {startTime, endTime});
-            
-            while (db_interval_set::getNextSegment(iterator)) {
-                if (iterator.interval.end == iterator.interval.start) continue;
-                if (!iterator.rightTruthy) {
-                    curNode.state = db_interval_set::unionSets(setHolder, curNode.state,
-                        db_interval_set::fromInterval(setHolder, {iterator.interval.start + curNode.a, add_with_inf(iterator.interval.end, curNode.b)}));
-                }
-
-                auto segmentOutput = db_interval_set::negateSet(setHolder, curNode.state, {iterator.interval.start, iterator.interval.end});
-                curNode.output = db_interval_set::unionSets(setHolder, curNode.output, segmentOutput);
-                
-            }
-            curNode.state = db_interval_set::intersectSets(setHolder, curNode.state,
-                db_interval_set::fromInterval(setHolder, {endTime, B_INFINITY}));
+            curNode.output = denseAlways(setHolder, curNode.state, nodes[curNode.rightOperandIndex].output,
+                                         curNode.a, curNode.b, startTime, endTime);
             break;
-        }
         case NodeType::SINCE:
-            {
-            auto leftOutput = nodes[curNode.leftOperandIndex].output;
-            auto rightOutput = nodes[curNode.rightOperandIndex].output;
-            curNode.output = db_interval_set::empty(setHolder);
-
-            auto iterator = db_interval_set::createSegmentIterator(leftOutput, rightOutput, {startTime, endTime});
-            
-            while (db_interval_set::getNextSegment(iterator)) {
-                if (iterator.interval.end == iterator.interval.start) continue;
-                if (iterator.leftTruthy && iterator.rightTruthy) {
-                    curNode.state = db_interval_set::unionSets(setHolder, curNode.state,
-                        db_interval_set::fromInterval(setHolder, {iterator.interval.start + curNode.a, add_with_inf(iterator.interval.end, curNode.b)}));
-                }
-                else if (!iterator.leftTruthy && iterator.rightTruthy) {
-                    curNode.state = db_interval_set::fromInterval(setHolder, {iterator.interval.end + curNode.a, add_with_inf(iterator.interval.end, curNode.b)});
-                }
-                else if (iterator.leftTruthy && !iterator.rightTruthy) {
-                }
-                else {
-                    curNode.state = db_interval_set::empty(setHolder);
-                }
-
-                auto segmentOutput = db_interval_set::intersectSets(setHolder, curNode.state,
-                    db_interval_set::fromInterval(setHolder, {iterator.interval.start, iterator.interval.end}));
-                curNode.output = db_interval_set::unionSets(setHolder, curNode.output, segmentOutput);
-                
-            }
-            curNode.state = db_interval_set::intersectSets(setHolder, curNode.state,
-                db_interval_set::fromInterval(setHolder, {endTime, B_INFINITY}));
+            curNode.output = denseSince(setHolder, curNode.state, nodes[curNode.leftOperandIndex].output,
+                                        nodes[curNode.rightOperandIndex].output, curNode.a, curNode.b, startTime, endTime);
             break;
-            }
         case NodeType::TEST:
             break;
+        case NodeType::EVENTUALLY_WINDOW:
+            curNode.output = windowDense(setHolder, curNode.window, nodes[curNode.rightOperandIndex].output, false,
+                                         curNode.a, curNode.b, startTime, endTime);
+            break;
+        case NodeType::ALWAYS_WINDOW:
+            curNode.output = windowDense(setHolder, curNode.window, nodes[curNode.rightOperandIndex].output, true,
+                                         curNode.a, curNode.b, startTime, endTime);
+            break;
+        case NodeType::UNTIL:
+            curNode.output = denseUntil(setHolder, curNode.state, curNode.window, nodes[curNode.leftOperandIndex].output,
+                                        nodes[curNode.rightOperandIndex].output, curNode.a, curNode.b, startTime, endTime);
+            break;
+        default:
+            break;
         }
     
     }
@@ -138,7 +341,7 @@ db_interval_set::IntervalSet run_evaluation(std::vector<DenseNode> &nodes, db_in
 }
 
 
-bool run_evaluation(std::vector<DiscreteNode> &nodes, db_interval_set::IntervalSetHolder &setHolder, const int time, const std::vector<bool> &propositionInputs) {
+bool run_evaluation(std::vector<DiscreteNode> &nodes, db_interval_set::IntervalSetHolder &setHolder, const Time time, const std::vector<bool> &propositionInputs) {
     for (unsigned int node_index = 0; node_index < nodes.size(); node_index++) {
         DiscreteNode &curNode = nodes[node_index];
         switch (curNode.type)
@@ -159,51 +362,38 @@ bool run_evaluation(std::vector<DiscreteNode> &nodes, db_interval_set::IntervalS
             curNode.output = !(nodes[curNode.leftOperandIndex].output && !nodes[curNode.rightOperandIndex].output);
             break; 
         case NodeType::EVENTUALLY:
-        {
-            if (nodes[curNode.rightOperandIndex].output) {
-                curNode.state = db_interval_set::unionSets(setHolder, curNode.state,
-                    db_interval_set::fromInterval(setHolder, {time + curNode.a, add_with_inf(time + 1, curNode.b)}));
-            }
-            curNode.output = db_interval_set::includes(curNode.state, time);
-            curNode.state = db_interval_set::intersectSets(setHolder, curNode.state,
-                db_interval_set::fromInterval(setHolder, {time + 1, B_INFINITY}));
+            curNode.output = discreteEventually(setHolder, curNode.state, nodes[curNode.rightOperandIndex].output,
+                                                curNode.a, curNode.b, time);
             break;
-
-        }   
         case NodeType::ALWAYS:
-        {
-            if (!nodes[curNode.rightOperandIndex].output) {
-                curNode.state = db_interval_set::unionSets(setHolder, curNode.state,
-                    db_interval_set::fromInterval(setHolder, {time + curNode.a, add_with_inf(time + 1, curNode.b)}));
-            }
-            curNode.output = !db_interval_set::includes(curNode.state, time);
-            curNode.state = db_interval_set::intersectSets(setHolder, curNode.state,
-                db_interval_set::fromInterval(setHolder, {time + 1, B_INFINITY}));
+            // historically p is !once !p
+            curNode.output = !discreteEventually(setHolder, curNode.state, !nodes[curNode.rightOperandIndex].output,
+                                                 curNode.a, curNode.b, time);
             break;
-        }
         case NodeType::SINCE:
+            curNode.output = discreteSince(setHolder, curNode.state, nodes[curNode.leftOperandIndex].output,
+                                           nodes[curNode.rightOperandIndex].output, curNode.a, curNode.b, time);
+            break;
+        case NodeType::EVENTUALLY_WINDOW:
+            curNode.output = windowEventually(curNode.window, nodes[curNode.rightOperandIndex].output, curNode.a, curNode.b, time);
+            break;
+        case NodeType::ALWAYS_WINDOW:
+            curNode.output = !windowEventually(curNode.window, !nodes[curNode.rightOperandIndex].output, curNode.a, curNode.b, time);
+            break;
+        case NodeType::PREVIOUS:
+        case NodeType::DELAY:
+            curNode.output = shiftRing(curNode.ring, nodes[curNode.rightOperandIndex].output);
+            break;
+        case NodeType::RISE:
+        case NodeType::FALL:
         {
-            bool leftOutput = nodes[curNode.leftOperandIndex].output;
-            bool rightOutput = nodes[curNode.rightOperandIndex].output;
-            if (leftOutput && rightOutput) {
-                curNode.state = db_interval_set::unionSets(setHolder, curNode.state,
-                    db_interval_set::fromInterval(setHolder, {time + curNode.a, add_with_inf(time + 1, curNode.b)}));
-            }
-            else if (!leftOutput && rightOutput) {
-                curNode.state = db_interval_set::fromInterval(setHolder, {time + curNode.a, add_with_inf(time + 1, curNode.b)});
-            }
-            else if (leftOutput && !rightOutput) {
-
-            }
-            else {
-                curNode.state = db_interval_set::empty(setHolder);
-            }
-            curNode.output = db_interval_set::includes(curNode.state, time);
-            curNode.state = db_interval_set::intersectSets(setHolder, curNode.state,
-                db_interval_set::fromInterval(setHolder, {time + 1, B_INFINITY}));
+            // The ring is shifted every step, whatever the operand
+            const bool now = nodes[curNode.rightOperandIndex].output;
+            const bool before = shiftRing(curNode.ring, now);
+            curNode.output = curNode.type == NodeType::RISE ? now && !before : !now && before;
             break;
         }
-        case NodeType::TEST:
+        default:
             break;
         }
     }
@@ -211,4 +401,153 @@ bool run_evaluation(std::vector<DiscreteNode> &nodes, db_interval_set::IntervalS
     
 }
 
+DenseProgram newDenseProgram(size_t nodeCount, db_interval_set::IntervalSetHolder &setHolder) {
+    DenseProgram program;
+    program.opcodes.resize(nodeCount, NodeType::TEST);
+    program.leftOperands.resize(nodeCount, 0);
+    program.rightOperands.resize(nodeCount, 0);
+    program.lowerBounds.resize(nodeCount, 0);
+    program.upperBounds.resize(nodeCount, 0);
+    program.states.resize(nodeCount, db_interval_set::empty(setHolder));
+    program.outputs.resize(nodeCount, db_interval_set::empty(setHolder));
+    program.windows.resize(nodeCount, IntervalWindow{{}, 0, 0});
+    return program;
+}
+
+db_interval_set::IntervalSet run_evaluation(DenseProgram &program, db_interval_set::IntervalSetHolder &setHolder, const Time startTime, const Time endTime, const std::vector<bool> &propositionInputs) {
+    const NodeType *opcodes = program.opcodes.data();
+    const unsigned int *left = program.leftOperands.data();
+    const unsigned int *right = program.rightOperands.data();
+    db_interval_set::IntervalSet *outputs = program.outputs.data();
+    const size_t nodeCount = program.opcodes.size();
+
+    for (size_t i = 0; i < nodeCount; i++) {
+        switch (opcodes[i]) {
+        case NodeType::PROPOSITION:
+            outputs[i] = propositionInputs[i] ? db_interval_set::fromInterval(setHolder, {startTime, endTime})
+                                              : db_interval_set::empty(setHolder);
+            break;
+        case NodeType::AND:
+            outputs[i] = db_interval_set::intersectSets(setHolder, outputs[left[i]], outputs[right[i]]);
+            break;
+        case NodeType::OR:
+            outputs[i] = db_interval_set::unionSets(setHolder, outputs[left[i]], outputs[right[i]]);
+            break;
+        case NodeType::NOT:
+            outputs[i] = db_interval_set::negateSet(setHolder, outputs[right[i]], {startTime, endTime});
+            break;
+        case NodeType::IMPLIES:
+            outputs[i] = db_interval_set::unionSets(setHolder,
+                db_interval_set::negateSet(setHolder, outputs[left[i]], {startTime, endTime}), outputs[right[i]]);
+            break;
+        case NodeType::EVENTUALLY:
+            outputs[i] = denseEventually(setHolder, program.states[i], outputs[right[i]],
+                                         program.lowerBounds[i], program.upperBounds[i], startTime, endTime);
+            break;
+        case NodeType::ALWAYS:
+            outputs[i] = denseAlways(setHolder, program.states[i], outputs[right[i]],
+                                     program.lowerBounds[i], program.upperBounds[i], startTime, endTime);
+            break;
+        case NodeType::SINCE:
+            outputs[i] = denseSince(setHolder, program.states[i], outputs[left[i]], outputs[right[i]],
+                                    program.lowerBounds[i], program.upperBounds[i], startTime, endTime);
+            break;
+        case NodeType::EVENTUALLY_WINDOW:
+            outputs[i] = windowDense(setHolder, program.windows[i], outputs[right[i]], false,
+                                     program.lowerBounds[i], program.upperBounds[i], startTime, endTime);
+            break;
+        case NodeType::ALWAYS_WINDOW:
+            outputs[i] = windowDense(setHolder, program.windows[i], outputs[right[i]], true,
+                                     program.lowerBounds[i], program.upperBounds[i], startTime, endTime);
+            break;
+        case NodeType::UNTIL:
+            outputs[i] = denseUntil(setHolder, program.states[i], program.windows[i], outputs[left[i]], outputs[right[i]],
+                                    program.lowerBounds[i], program.upperBounds[i], startTime, endTime);
+            break;
+        default:
+            break;
+        }
+    }
+    return outputs[nodeCount - 1];
+}
+
+DiscreteProgram newDiscreteProgram(size_t nodeCount, db_interval_set::IntervalSetHolder &setHolder) {
+    DiscreteProgram program;
+    program.opcodes.resize(nodeCount, NodeType::TEST);
+    program.leftOperands.resize(nodeCount, 0);
+    program.rightOperands.resize(nodeCount, 0);
+    program.lowerBounds.resize(nodeCount, 0);
+    program.upperBounds.resize(nodeCount, 0);
+    program.outputs.resize((nodeCount + 63) / 64, 0);
+    program.states.resize(nodeCount, db_interval_set::empty(setHolder));
+    program.windows.resize(nodeCount, IntervalWindow{{}, 0, 0});
+    program.rings.resize(nodeCount, BitRing{{}, 0, 0});
+    return program;
+}
+
+bool run_evaluation(DiscreteProgram &program, db_interval_set::IntervalSetHolder &setHolder, const Time time, const std::vector<bool> &propositionInputs) {
+    const NodeType *opcodes = program.opcodes.data();
+    const unsigned int *left = program.leftOperands.data();
+    const unsigned int *right = program.rightOperands.data();
+    uint64_t *outputs = program.outputs.data();
+    const size_t nodeCount = program.opcodes.size();
+
+    auto get = [outputs](unsigned int index) { return (outputs[index >> 6] >> (index & 63)) & 1; };
+
+    for (size_t i = 0; i < nodeCount; i++) {
+        uint64_t bit;
+        switch (opcodes[i]) {
+        case NodeType::PROPOSITION:
+            bit = propositionInputs[i];
+            break;
+        case NodeType::AND:
+            bit = get(left[i]) & get(right[i]);
+            break;
+        case NodeType::OR:
+            bit = get(left[i]) | get(right[i]);
+            break;
+        case NodeType::NOT:
+            bit = get(right[i]) ^ 1;
+            break;
+        case NodeType::IMPLIES:
+            bit = (get(left[i]) ^ 1) | get(right[i]);
+            break;
+        case NodeType::EVENTUALLY:
+            bit = discreteEventually(setHolder, program.states[i], get(right[i]),
+                                     program.lowerBounds[i], program.upperBounds[i], time);
+            break;
+        case NodeType::ALWAYS:
+            bit = !discreteEventually(setHolder, program.states[i], !get(right[i]),
+                                      program.lowerBounds[i], program.upperBounds[i], time);
+            break;
+        case NodeType::SINCE:
+            bit = discreteSince(setHolder, program.states[i], get(left[i]), get(right[i]),
+                                program.lowerBounds[i], program.upperBounds[i], time);
+            break;
+        case NodeType::EVENTUALLY_WINDOW:
+            bit = windowEventually(program.windows[i], get(right[i]), program.lowerBounds[i], program.upperBounds[i], time);
+            break;
+        case NodeType::ALWAYS_WINDOW:
+            bit = !windowEventually(program.windows[i], !get(right[i]), program.lowerBounds[i], program.upperBounds[i], time);
+            break;
+        case NodeType::PREVIOUS:
+        case NodeType::DELAY:
+            bit = shiftRing(program.rings[i], get(right[i]));
+            break;
+        case NodeType::RISE:
+            bit = get(right[i]) & (shiftRing(program.rings[i], get(right[i])) ^ 1);
+            break;
+        case NodeType::FALL:
+            bit = (get(right[i]) ^ 1) & shiftRing(program.rings[i], get(right[i]));
+            break;
+        default:
+            bit = 0;
+            break;
+        }
+        uint64_t mask = uint64_t(1) << (i & 63);
+        outputs[i >> 6] = (outputs[i >> 6] & ~mask) | (bit << (i & 63));
+    }
+    return get(static_cast<unsigned int>(nodeCount - 1));
+}
+
 } // namespace do_verify
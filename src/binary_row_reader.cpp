@@ -1,5 +1,13 @@
 #include "do-verify/binary_row_reader.hpp"
 
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
 namespace binary_row_reader {
 
 std::vector<TimescalesInput> readInputFile(std::string fileName) {
@@ -30,4 +38,299 @@ std::vector<TimescalesInput> readInputFile(std::string fileName) {
     return data;
 }
 
+namespace {
+
+// Maps a whole file read-only and shared, advised for a sequential scan.
+// Returns nullptr if the file can't be opened or mapped.
+void *mapFile(const std::string &fileName, size_t &length) {
+    int fd = open(fileName.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return nullptr;
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size == 0) {
+        close(fd);
+        return nullptr;
+    }
+
+    length = static_cast<size_t>(info.st_size);
+    void *mapping = mmap(nullptr, length, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd); // The mapping keeps its own reference to the file
+    if (mapping == MAP_FAILED) {
+        return nullptr;
+    }
+
+    madvise(mapping, length, MADV_SEQUENTIAL);
+#ifdef MADV_HUGEPAGE
+    madvise(mapping, length, MADV_HUGEPAGE); // Only a hint, fails harmlessly on most filesystems
+#endif
+    return mapping;
+}
+
+template <typename T>
+T readValue(const char *bytes) {
+    T value;
+    std::memcpy(&value, bytes, sizeof(value));
+    return value;
+}
+
+} // namespace
+
+MappedInputFile mapInputFile(const std::string &fileName) {
+    MappedInputFile file{{}, nullptr, 0};
+    size_t length = 0;
+    void *mapping = mapFile(fileName, length);
+    if (mapping == nullptr) {
+        return file;
+    }
+    if (length < sizeof(uint32_t)) {
+        munmap(mapping, length);
+        return file;
+    }
+
+    // Same layout readInputFile expects: a uint32_t count, then packed rows
+    const char *bytes = static_cast<const char *>(mapping);
+    uint32_t total_lines = readValue<uint32_t>(bytes);
+    size_t available = (length - sizeof(total_lines)) / sizeof(TimescalesInput);
+
+    file.rows = std::span<const TimescalesInput>(
+        reinterpret_cast<const TimescalesInput *>(bytes + sizeof(total_lines)),
+        std::min<size_t>(total_lines, available));
+    file.mapping = mapping;
+    file.mappingLength = length;
+    return file;
+}
+
+void unmapInputFile(MappedInputFile &file) {
+    if (file.mapping != nullptr) {
+        munmap(file.mapping, file.mappingLength);
+    }
+    file = MappedInputFile{{}, nullptr, 0};
+}
+
+TraceFormatError::TraceFormatError(const std::string &message)
+    : std::runtime_error(message) {}
+
+bool parseTraceHeader(const char *bytes, size_t length, TraceHeader &header) {
+    if (length < sizeof(TRACE_MAGIC)) {
+        return false;
+    }
+
+    if (std::memcmp(bytes, TRACE_MAGIC, sizeof(TRACE_MAGIC)) != 0) {
+        // Original .row.bin: a count, then TimescalesInput rows
+        header.propositions = {"p", "q", "r", "s"};
+        header.slots.clear();
+        for (uint32_t i = 0; i < 4; i++) {
+            header.slots.push_back(PropositionSlot{static_cast<uint32_t>(sizeof(int32_t)) + i, 0xFF});
+        }
+        header.rowBytes = sizeof(TimescalesInput);
+        header.timeBytes = sizeof(int32_t);
+        header.rowCount = readValue<uint32_t>(bytes);
+        header.dataOffset = sizeof(uint32_t);
+        return true;
+    }
+
+    const size_t fixedBytes = sizeof(TRACE_MAGIC) + 2 * sizeof(uint16_t) + sizeof(uint32_t);
+    if (length < fixedBytes) {
+        return false;
+    }
+    uint16_t version = readValue<uint16_t>(bytes + 4);
+    if (version != TRACE_VERSION && version != TRACE_VERSION_TIME64) {
+        throw TraceFormatError("Unsupported trace version " + std::to_string(version));
+    }
+    uint16_t count = readValue<uint16_t>(bytes + 6);
+    uint32_t rowCount = readValue<uint32_t>(bytes + 8);
+
+    std::vector<std::string> names;
+    size_t pos = fixedBytes;
+    for (uint16_t i = 0; i < count; i++) {
+        if (pos >= length) {
+            return false;
+        }
+        size_t nameLength = static_cast<uint8_t>(bytes[pos]);
+        if (nameLength == 0) {
+            throw TraceFormatError("Empty proposition name in trace header");
+        }
+        if (pos + 1 + nameLength > length) {
+            return false;
+        }
+        names.emplace_back(bytes + pos + 1, nameLength);
+        pos += 1 + nameLength;
+    }
+
+    const size_t timeBytes = version == TRACE_VERSION_TIME64 ? sizeof(int64_t) : sizeof(int32_t);
+    header.propositions = std::move(names);
+    header.slots.clear();
+    for (uint32_t i = 0; i < count; i++) {
+        header.slots.push_back(PropositionSlot{static_cast<uint32_t>(timeBytes) + i / 8, static_cast<uint8_t>(1u << (i % 8))});
+    }
+    header.rowBytes = timeBytes + (count + 7) / 8;
+    header.timeBytes = timeBytes;
+    header.rowCount = rowCount;
+    header.dataOffset = pos;
+    return true;
+}
+
+std::string encodeTraceHeader(const std::vector<std::string> &propositions, uint32_t rowCount, size_t timeBytes) {
+    if (propositions.size() > UINT16_MAX) {
+        throw TraceFormatError("Too many propositions for a trace header");
+    }
+    uint16_t version = timeBytes == sizeof(int64_t) ? TRACE_VERSION_TIME64 : TRACE_VERSION;
+    uint16_t count = static_cast<uint16_t>(propositions.size());
+
+    std::string out(TRACE_MAGIC, sizeof(TRACE_MAGIC));
+    out.append(reinterpret_cast<const char *>(&version), sizeof(version));
+    out.append(reinterpret_cast<const char *>(&count), sizeof(count));
+    out.append(reinterpret_cast<const char *>(&rowCount), sizeof(rowCount));
+    for (const std::string &name : propositions) {
+        if (name.empty() || name.size() > UINT8_MAX) {
+            throw TraceFormatError("Proposition names must be 1 to 255 bytes: '" + name + "'");
+        }
+        out.push_back(static_cast<char>(name.size()));
+        out.append(name);
+    }
+    return out;
+}
+
+void encodeRow(int64_t time, const std::vector<bool> &values, char *out, size_t timeBytes) {
+    if (timeBytes == sizeof(int64_t)) {
+        std::memcpy(out, &time, sizeof(time));
+    }
+    else {
+        int32_t narrow = static_cast<int32_t>(time);
+        std::memcpy(out, &narrow, sizeof(narrow));
+    }
+    char *bits = out + timeBytes;
+    std::fill(bits, bits + (values.size() + 7) / 8, 0);
+    for (size_t i = 0; i < values.size(); i++) {
+        if (values[i]) {
+            bits[i / 8] = static_cast<char>(bits[i / 8] | (1u << (i % 8)));
+        }
+    }
+}
+
+std::vector<PropositionSlot> bindPropositions(const TraceHeader &header, const std::vector<std::string> &names) {
+    std::vector<PropositionSlot> slots;
+    slots.reserve(names.size());
+    for (const std::string &name : names) {
+        auto found = std::find(header.propositions.begin(), header.propositions.end(), name);
+        if (found == header.propositions.end()) {
+            throw TraceFormatError("Trace has no proposition named '" + name + "'");
+        }
+        slots.push_back(header.slots[found - header.propositions.begin()]);
+    }
+    return slots;
+}
+
+MappedTrace mapTraceFile(const std::string &fileName) {
+    MappedTrace trace{{}, {nullptr, 0, 1}, nullptr, 0};
+    size_t length = 0;
+    void *mapping = mapFile(fileName, length);
+    if (mapping == nullptr) {
+        return trace;
+    }
+
+    const char *bytes = static_cast<const char *>(mapping);
+    try {
+        if (!parseTraceHeader(bytes, length, trace.header)) {
+            throw TraceFormatError("Trace header is truncated");
+        }
+    } catch (...) {
+        munmap(mapping, length);
+        throw;
+    }
+
+    size_t available = (length - trace.header.dataOffset) / trace.header.rowBytes;
+    size_t count = trace.header.rowCount == 0 ? available : std::min<size_t>(trace.header.rowCount, available);
+    trace.rows = RowBatch{bytes + trace.header.dataOffset, count, trace.header.rowBytes, trace.header.timeBytes};
+    trace.mapping = mapping;
+    trace.mappingLength = length;
+    return trace;
+}
+
+void unmapTraceFile(MappedTrace &trace) {
+    if (trace.mapping != nullptr) {
+        munmap(trace.mapping, trace.mappingLength);
+    }
+    trace = MappedTrace{{}, {nullptr, 0, 1}, nullptr, 0};
+}
+
+namespace {
+
+// read() that retries on EINTR and marks the stream finished at end of
+// file or on error.
+size_t readSome(RowStream &stream, char *target, size_t wanted) {
+    while (true) {
+        ssize_t count = read(stream.fd, target, wanted);
+        if (count > 0) {
+            return static_cast<size_t>(count);
+        }
+        if (count < 0 && errno == EINTR) {
+            continue;
+        }
+        stream.failed = count < 0;
+        stream.finished = true;
+        return 0;
+    }
+}
+
+} // namespace
+
+RowStream openRowStream(int fd, size_t batchRows) {
+    return RowStream{fd, std::max<size_t>(batchRows, 1), std::vector<char>(4096), {}, false, 0, 0, false, false};
+}
+
+bool readStreamHeader(RowStream &stream) {
+    size_t filled = 0;
+    while (!stream.headerParsed) {
+        if (parseTraceHeader(stream.buffer.data(), filled, stream.header)) {
+            stream.headerParsed = true;
+            break;
+        }
+        if (filled == stream.buffer.size()) {
+            stream.buffer.resize(stream.buffer.size() * 2); // Long proposition list
+        }
+        size_t count = readSome(stream, stream.buffer.data() + filled, stream.buffer.size() - filled);
+        if (count == 0) {
+            return false;
+        }
+        filled += count;
+    }
+
+    // Whatever arrived after the header already belongs to the rows
+    size_t extra = filled - stream.header.dataOffset;
+    std::memmove(stream.buffer.data(), stream.buffer.data() + stream.header.dataOffset, extra);
+    stream.buffer.resize(std::max(stream.batchRows * stream.header.rowBytes, extra));
+    stream.tailOffset = 0;
+    stream.tailBytes = extra;
+    return true;
+}
+
+RowBatch readBatch(RowStream &stream) {
+    if (!stream.headerParsed && !readStreamHeader(stream)) {
+        return RowBatch{nullptr, 0, 1};
+    }
+    size_t rowBytes = stream.header.rowBytes;
+    char *bytes = stream.buffer.data();
+
+    // Carry the bytes left over from the previous read to the front
+    std::memmove(bytes, bytes + stream.tailOffset, stream.tailBytes);
+    size_t filled = stream.tailBytes;
+    stream.tailOffset = 0;
+    stream.tailBytes = 0;
+
+    while (true) {
+        size_t rows = std::min(filled / rowBytes, stream.batchRows);
+        if (rows > 0) {
+            stream.tailOffset = rows * rowBytes;
+            stream.tailBytes = filled - stream.tailOffset;
+            return RowBatch{bytes, rows, rowBytes, stream.header.timeBytes};
+        }
+        if (stream.finished) {
+            return RowBatch{bytes, 0, rowBytes, stream.header.timeBytes};
+        }
+        filled += readSome(stream, bytes + filled, stream.buffer.size() - filled);
+    }
+}
+
 } // namespace binary_row_reader
@@ -0,0 +1,194 @@
+#include "do-verify/block_engine.hpp"
+
+#include <climits>
+
+namespace do_verify {
+
+namespace {
+
+constexpr long long NO_STEP = LLONG_MIN / 2;
+
+// The operand delayed by 'a' steps: bit k is the operand at step k - a.
+uint64_t delayColumn(BlockState &state, uint64_t column, Time a) {
+    if (a == 0) {
+        return column;
+    }
+    const unsigned int size = static_cast<unsigned int>(state.history.size());
+    const unsigned int words = static_cast<unsigned int>(a / 64);
+    const unsigned int shift = static_cast<unsigned int>(a % 64);
+    state.history[state.head] = column;
+    uint64_t high = state.history[(state.head + size - words) % size];
+    uint64_t low = state.history[(state.head + size - words - 1) % size];
+    state.head = (state.head + 1) % size;
+    return shift == 0 ? high : (high << shift) | (low >> (64 - shift));
+}
+
+/**
+ * Discrete once[a:b] over a column: bit k holds if the operand held at some
+ * step in [k - b, k - a]. Inside the block that is a shift-or doubling over
+ * the delayed column; steps before the block only matter through the latest
+ * one at which the delayed operand held.
+ */
+uint64_t onceColumn(BlockState &state, uint64_t column, Time a, Time b, long long start) {
+    uint64_t delayed = delayColumn(state, column, a);
+    const long long length = b == B_INFINITY ? LLONG_MAX : static_cast<long long>(b) - a + 1;
+    const long long inBlock = std::min(length, 64LL);
+
+    uint64_t output = delayed;
+    long long covered = 1;
+    while (covered * 2 <= inBlock) {
+        output |= output << covered;
+        covered *= 2;
+    }
+    if (covered < inBlock) {
+        output |= output << (inBlock - covered);
+    }
+
+    if (state.lastOne != NO_STEP) {
+        if (b == B_INFINITY) {
+            output = ~uint64_t(0);
+        }
+        else {
+            long long reach = length - (start - state.lastOne); // First bit no longer covered
+            output |= reach >= 64 ? ~uint64_t(0) : reach <= 0 ? 0 : (uint64_t(1) << reach) - 1;
+        }
+    }
+    if (delayed != 0) {
+        state.lastOne = start + 63 - __builtin_clzll(delayed);
+    }
+    return output;
+}
+
+/**
+ * Discrete since[0:inf): s[k] = q[k] | (p[k] & s[k-1]). Seeding bit j + 1
+ * for every q at j and adding it to p carries each seed up through its run
+ * of p, which resolves the recurrence for the whole word at once.
+ */
+uint64_t sinceColumn(BlockState &state, uint64_t left, uint64_t right) {
+    uint64_t seeds = ((right << 1) | state.carry) & left;
+    uint64_t filled = (((left + seeds) ^ left) | seeds) & left;
+    uint64_t output = right | filled;
+    state.carry = output >> 63;
+    return output;
+}
+
+// Other since bounds, one step at a time: 'candidates' are the right operand
+// steps since the left operand last failed that can still fall in [k-b, k-a].
+uint64_t boundedSinceColumn(BlockState &state, uint64_t left, uint64_t right, Time a, Time b,
+                            long long start, unsigned int steps) {
+    uint64_t output = 0;
+    for (unsigned int k = 0; k < steps; k++) {
+        const long long step = start + k;
+        if (!((left >> k) & 1)) {
+            state.candidates.clear();
+        }
+        if ((right >> k) & 1) {
+            // With no upper bound only the earliest candidate matters
+            if (b != B_INFINITY || state.candidates.empty()) state.candidates.push_back(step);
+        }
+        if (b != B_INFINITY) {
+            while (!state.candidates.empty() && step - state.candidates.front() > b) state.candidates.pop_front();
+        }
+        if (!state.candidates.empty() && step - state.candidates.front() >= a) {
+            output |= uint64_t(1) << k;
+        }
+    }
+    return output;
+}
+
+} // namespace
+
+BlockProgram newBlockProgram(size_t nodeCount) {
+    BlockProgram program;
+    program.opcodes.resize(nodeCount, NodeType::TEST);
+    program.leftOperands.resize(nodeCount, 0);
+    program.rightOperands.resize(nodeCount, 0);
+    program.lowerBounds.resize(nodeCount, 0);
+    program.upperBounds.resize(nodeCount, 0);
+    program.outputs.resize(nodeCount, 0);
+    program.states.resize(nodeCount, BlockState{{}, 0, NO_STEP, 0, {}});
+    program.position = 0;
+    return program;
+}
+
+void resetBlockStates(BlockProgram &program) {
+    for (size_t i = 0; i < program.opcodes.size(); i++) {
+        BlockState &state = program.states[i];
+        Time a = program.lowerBounds[i];
+        bool delays = a > 0 && program.opcodes[i] != NodeType::SINCE;
+        state.history.assign(delays ? static_cast<size_t>(a / 64 + 2) : 0, 0);
+        state.head = 0;
+        state.lastOne = NO_STEP;
+        state.carry = 0;
+        state.candidates.clear();
+        program.outputs[i] = 0;
+    }
+    program.position = 0;
+}
+
+uint64_t run_evaluation(BlockProgram &program, const std::vector<uint64_t> &propositionColumns, const unsigned int steps) {
+    const NodeType *opcodes = program.opcodes.data();
+    const unsigned int *left = program.leftOperands.data();
+    const unsigned int *right = program.rightOperands.data();
+    uint64_t *outputs = program.outputs.data();
+    const size_t nodeCount = program.opcodes.size();
+    const long long start = program.position;
+
+    for (size_t i = 0; i < nodeCount; i++) {
+        switch (opcodes[i]) {
+        case NodeType::PROPOSITION:
+            outputs[i] = propositionColumns[i];
+            break;
+        case NodeType::AND:
+            outputs[i] = outputs[left[i]] & outputs[right[i]];
+            break;
+        case NodeType::OR:
+            outputs[i] = outputs[left[i]] | outputs[right[i]];
+            break;
+        case NodeType::NOT:
+            outputs[i] = ~outputs[right[i]];
+            break;
+        case NodeType::IMPLIES:
+            outputs[i] = ~outputs[left[i]] | outputs[right[i]];
+            break;
+        case NodeType::EVENTUALLY:
+        case NodeType::EVENTUALLY_WINDOW:
+            outputs[i] = onceColumn(program.states[i], outputs[right[i]],
+                                    program.lowerBounds[i], program.upperBounds[i], start);
+            break;
+        case NodeType::ALWAYS:
+        case NodeType::ALWAYS_WINDOW:
+            // historically p is !once !p
+            outputs[i] = ~onceColumn(program.states[i], ~outputs[right[i]],
+                                     program.lowerBounds[i], program.upperBounds[i], start);
+            break;
+        case NodeType::SINCE:
+            if (program.lowerBounds[i] == 0 && program.upperBounds[i] == B_INFINITY) {
+                outputs[i] = sinceColumn(program.states[i], outputs[left[i]], outputs[right[i]]);
+            }
+            else {
+                outputs[i] = boundedSinceColumn(program.states[i], outputs[left[i]], outputs[right[i]],
+                                                program.lowerBounds[i], program.upperBounds[i], start, steps);
+            }
+            break;
+        case NodeType::TEST:
+            break;
+        case NodeType::PREVIOUS:
+        case NodeType::DELAY:
+            outputs[i] = delayColumn(program.states[i], outputs[right[i]], program.lowerBounds[i]);
+            break;
+        case NodeType::RISE:
+            outputs[i] = outputs[right[i]] & ~delayColumn(program.states[i], outputs[right[i]], 1);
+            break;
+        case NodeType::FALL:
+            outputs[i] = ~outputs[right[i]] & delayColumn(program.states[i], outputs[right[i]], 1);
+            break;
+        default:
+            break;
+        }
+    }
+    program.position += steps;
+    return outputs[nodeCount - 1];
+}
+
+} // namespace do_verify
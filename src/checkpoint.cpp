@@ -0,0 +1,301 @@
+#include "do-verify/checkpoint.hpp"
+
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace checkpoint {
+
+CheckpointError::CheckpointError(const std::string &message) : std::runtime_error(message) {}
+
+namespace {
+
+template <typename T>
+void append(std::vector<char> &out, const T &value) {
+    const char *bytes = reinterpret_cast<const char *>(&value);
+    out.insert(out.end(), bytes, bytes + sizeof(value));
+}
+
+void appendIntervals(std::vector<char> &out, const std::vector<db_interval_set::Interval> &intervals) {
+    append(out, static_cast<uint32_t>(intervals.size()));
+    for (const db_interval_set::Interval &interval : intervals) {
+        append(out, static_cast<int64_t>(interval.start));
+        append(out, static_cast<int64_t>(interval.end));
+    }
+}
+
+struct Reader {
+    const char *bytes;
+    size_t length;
+    size_t offset;
+};
+
+template <typename T>
+T take(Reader &reader) {
+    if (reader.length - reader.offset < sizeof(T)) {
+        throw CheckpointError("Checkpoint is truncated");
+    }
+    T value;
+    std::memcpy(&value, reader.bytes + reader.offset, sizeof(T));
+    reader.offset += sizeof(T);
+    return value;
+}
+
+db_interval_set::Time takeTime(Reader &reader) {
+    int64_t time = take<int64_t>(reader);
+    if (time != static_cast<db_interval_set::Time>(time)) {
+        throw CheckpointError("Checkpoint needs a build with DO_VERIFY_TIME64");
+    }
+    return static_cast<db_interval_set::Time>(time);
+}
+
+std::vector<db_interval_set::Interval> takeIntervals(Reader &reader) {
+    uint32_t count = take<uint32_t>(reader);
+    if ((reader.length - reader.offset) / (2 * sizeof(int64_t)) < count) {
+        throw CheckpointError("Checkpoint is truncated");
+    }
+    std::vector<db_interval_set::Interval> intervals(count);
+    for (db_interval_set::Interval &interval : intervals) {
+        interval.start = takeTime(reader);
+        interval.end = takeTime(reader);
+    }
+    return intervals;
+}
+
+std::vector<db_interval_set::Interval> windowIntervals(const do_verify::IntervalWindow &window) {
+    std::vector<db_interval_set::Interval> intervals;
+    const size_t capacity = window.buffer.size();
+    for (unsigned int i = 0; i < window.size; i++) {
+        intervals.push_back(window.buffer[(window.head + i) % capacity]);
+    }
+    return intervals;
+}
+
+// A step operator's ring as the ages, 1 being the last step, at which its
+// operand held. The ring has no set in the holder, so this takes its place
+// among the states.
+std::vector<db_interval_set::Interval> ringIntervals(const do_verify::BitRing &ring) {
+    std::vector<db_interval_set::Interval> intervals;
+    for (unsigned int age = 1; age <= ring.size; age++) {
+        const unsigned int slot = ring.position >= age ? ring.position - age : ring.position + ring.size - age;
+        if (((ring.words[slot >> 6] >> (slot & 63)) & 1) == 0) continue;
+        if (!intervals.empty() && intervals.back().end == static_cast<db_interval_set::Time>(age)) {
+            intervals.back().end++;
+        } else {
+            intervals.push_back({static_cast<db_interval_set::Time>(age), static_cast<db_interval_set::Time>(age + 1)});
+        }
+    }
+    return intervals;
+}
+
+// Replays the ages oldest first into a fresh ring
+void restoreRing(do_verify::BitRing &ring, const std::vector<db_interval_set::Interval> &intervals) {
+    size_t next = intervals.size();
+    for (unsigned int age = ring.size; age >= 1; age--) {
+        while (next > 0 && intervals[next - 1].start > static_cast<db_interval_set::Time>(age)) next--;
+        const bool held = next > 0 && intervals[next - 1].end > static_cast<db_interval_set::Time>(age);
+        do_verify::shiftRing(ring, held);
+    }
+}
+
+void checkNodeCount(size_t nodes, const Snapshot &snapshot) {
+    if (snapshot.states.size() != nodes || snapshot.windows.size() != nodes) {
+        throw CheckpointError("Checkpoint was taken with a different spec");
+    }
+}
+
+} // namespace
+
+uint64_t specFingerprint(const spec_compiler::CompiledSpec &spec) {
+    // FNV-1a over every node field and the proposition names
+    uint64_t hash = 14695981039346656037ull;
+    auto mix = [&hash](uint64_t value) {
+        for (int i = 0; i < 8; i++) {
+            hash ^= (value >> (i * 8)) & 0xFF;
+            hash *= 1099511628211ull;
+        }
+    };
+    for (const spec_compiler::SpecNode &node : spec.nodes) {
+        mix(static_cast<uint64_t>(node.type));
+        mix(node.leftOperandIndex);
+        mix(node.rightOperandIndex);
+        mix(static_cast<uint64_t>(node.a));
+        mix(static_cast<uint64_t>(node.b));
+    }
+    for (const std::string &name : spec.propositions) {
+        for (char c : name) mix(static_cast<unsigned char>(c));
+        mix(0);
+    }
+    return hash;
+}
+
+std::vector<char> encodeSnapshot(const Snapshot &snapshot) {
+    std::vector<char> out;
+    out.reserve(128);
+    out.insert(out.end(), CHECKPOINT_MAGIC, CHECKPOINT_MAGIC + sizeof(CHECKPOINT_MAGIC));
+    append(out, CHECKPOINT_VERSION);
+    append(out, snapshot.mode);
+    append(out, snapshot.fingerprint);
+    append(out, snapshot.rows);
+    append(out, static_cast<uint8_t>(snapshot.violated));
+    append(out, static_cast<int64_t>(snapshot.firstViolation));
+    append(out, static_cast<int64_t>(snapshot.previousTime));
+    append(out, static_cast<uint8_t>(snapshot.hasPrevious));
+    append(out, static_cast<uint32_t>(snapshot.previousInputs.size()));
+    for (bool input : snapshot.previousInputs) {
+        append(out, static_cast<uint8_t>(input));
+    }
+    append(out, static_cast<uint8_t>(snapshot.hasRun));
+    append(out, static_cast<int64_t>(snapshot.runStart));
+    append(out, static_cast<int64_t>(snapshot.runEnd));
+    append(out, static_cast<uint8_t>(snapshot.runValue));
+    append(out, snapshot.outputOffset);
+    append(out, static_cast<uint32_t>(snapshot.states.size()));
+    for (size_t i = 0; i < snapshot.states.size(); i++) {
+        appendIntervals(out, snapshot.states[i]);
+        appendIntervals(out, i < snapshot.windows.size() ? snapshot.windows[i] : std::vector<db_interval_set::Interval>{});
+    }
+    return out;
+}
+
+Snapshot decodeSnapshot(const char *bytes, size_t length) {
+    if (length < sizeof(CHECKPOINT_MAGIC) || std::memcmp(bytes, CHECKPOINT_MAGIC, sizeof(CHECKPOINT_MAGIC)) != 0) {
+        throw CheckpointError("Not a checkpoint file");
+    }
+    Reader reader{bytes, length, sizeof(CHECKPOINT_MAGIC)};
+    if (take<uint16_t>(reader) != CHECKPOINT_VERSION) {
+        throw CheckpointError("Unsupported checkpoint version");
+    }
+    Snapshot snapshot;
+    snapshot.mode = take<uint16_t>(reader);
+    snapshot.fingerprint = take<uint64_t>(reader);
+    snapshot.rows = take<uint64_t>(reader);
+    snapshot.violated = take<uint8_t>(reader) != 0;
+    snapshot.firstViolation = takeTime(reader);
+    snapshot.previousTime = takeTime(reader);
+    snapshot.hasPrevious = take<uint8_t>(reader) != 0;
+    uint32_t inputs = take<uint32_t>(reader);
+    if (reader.length - reader.offset < inputs) {
+        throw CheckpointError("Checkpoint is truncated");
+    }
+    for (uint32_t i = 0; i < inputs; i++) {
+        snapshot.previousInputs.push_back(take<uint8_t>(reader) != 0);
+    }
+    snapshot.hasRun = take<uint8_t>(reader) != 0;
+    snapshot.runStart = takeTime(reader);
+    snapshot.runEnd = takeTime(reader);
+    snapshot.runValue = take<uint8_t>(reader) != 0;
+    snapshot.outputOffset = take<int64_t>(reader);
+    uint32_t nodes = take<uint32_t>(reader);
+    for (uint32_t i = 0; i < nodes; i++) {
+        snapshot.states.push_back(takeIntervals(reader));
+        snapshot.windows.push_back(takeIntervals(reader));
+    }
+    return snapshot;
+}
+
+void saveSnapshot(const std::string &path, const Snapshot &snapshot) {
+    std::vector<char> bytes = encodeSnapshot(snapshot);
+    std::string temporary = path + ".tmp";
+    int fd = open(temporary.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        throw CheckpointError("Can't create checkpoint " + temporary + ": " + std::strerror(errno));
+    }
+    size_t written = 0;
+    while (written < bytes.size()) {
+        ssize_t count = write(fd, bytes.data() + written, bytes.size() - written);
+        if (count < 0) {
+            if (errno == EINTR) continue;
+            int error = errno;
+            close(fd);
+            throw CheckpointError("Can't write checkpoint " + temporary + ": " + std::strerror(error));
+        }
+        written += static_cast<size_t>(count);
+    }
+    // The rename must not become visible before the data it points to
+    bool synced = fsync(fd) == 0;
+    close(fd);
+    if (!synced || rename(temporary.c_str(), path.c_str()) != 0) {
+        throw CheckpointError("Can't store checkpoint " + path + ": " + std::strerror(errno));
+    }
+}
+
+Snapshot loadSnapshot(const std::string &path) {
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw CheckpointError("Can't open checkpoint " + path + ": " + std::strerror(errno));
+    }
+    std::vector<char> bytes;
+    char chunk[1 << 14];
+    while (true) {
+        ssize_t count = read(fd, chunk, sizeof(chunk));
+        if (count < 0) {
+            if (errno == EINTR) continue;
+            int error = errno;
+            close(fd);
+            throw CheckpointError("Can't read checkpoint " + path + ": " + std::strerror(error));
+        }
+        if (count == 0) break;
+        bytes.insert(bytes.end(), chunk, chunk + count);
+    }
+    close(fd);
+    return decodeSnapshot(bytes.data(), bytes.size());
+}
+
+void captureProgram(const do_verify::DiscreteProgram &program, Snapshot &snapshot) {
+    const size_t nodes = program.opcodes.size();
+    snapshot.states.assign(nodes, {});
+    snapshot.windows.assign(nodes, {});
+    for (size_t i = 0; i < nodes; i++) {
+        snapshot.states[i] = program.rings[i].size > 0 ? ringIntervals(program.rings[i])
+                                                       : db_interval_set::toVectorIntervals(program.states[i]);
+        snapshot.windows[i] = windowIntervals(program.windows[i]);
+    }
+}
+
+void captureProgram(const do_verify::DenseProgram &program, Snapshot &snapshot) {
+    const size_t nodes = program.opcodes.size();
+    snapshot.states.assign(nodes, {});
+    snapshot.windows.assign(nodes, {});
+    for (size_t i = 0; i < nodes; i++) {
+        snapshot.states[i] = db_interval_set::toVectorIntervals(program.states[i]);
+        snapshot.windows[i] = windowIntervals(program.windows[i]);
+    }
+}
+
+void restoreProgram(do_verify::DiscreteProgram &program, db_interval_set::IntervalSetHolder &holder, const Snapshot &snapshot) {
+    checkNodeCount(program.opcodes.size(), snapshot);
+    for (size_t i = 0; i < program.opcodes.size(); i++) {
+        if (program.rings[i].size > 0) {
+            restoreRing(program.rings[i], snapshot.states[i]);
+            continue;
+        }
+        program.states[i] = db_interval_set::createSetFromIntervals(holder, snapshot.states[i]);
+        for (const db_interval_set::Interval &interval : snapshot.windows[i]) {
+            do_verify::pushInterval(program.windows[i], interval);
+        }
+    }
+}
+
+void restoreProgram(do_verify::DenseProgram &program, db_interval_set::IntervalSetHolder &holder, const Snapshot &snapshot) {
+    checkNodeCount(program.opcodes.size(), snapshot);
+    for (size_t i = 0; i < program.opcodes.size(); i++) {
+        program.states[i] = db_interval_set::createSetFromIntervals(holder, snapshot.states[i]);
+        const bool isWindow = program.opcodes[i] == do_verify::NodeType::EVENTUALLY_WINDOW ||
+                              program.opcodes[i] == do_verify::NodeType::ALWAYS_WINDOW;
+        // Dense once/historically kept their state as a set before they
+        // ran on windows; it holds the same intervals
+        if (isWindow) {
+            for (const db_interval_set::Interval &interval : snapshot.states[i]) {
+                do_verify::pushInterval(program.windows[i], interval);
+            }
+        }
+        for (const db_interval_set::Interval &interval : snapshot.windows[i]) {
+            do_verify::pushInterval(program.windows[i], interval);
+        }
+    }
+}
+
+} // namespace checkpoint
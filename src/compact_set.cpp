@@ -0,0 +1,164 @@
+#include "do-verify/compact_set.hpp"
+
+#include <algorithm>
+
+namespace db_interval_set {
+
+CompactSet toCompactSet(const IntervalSet &set) {
+    CompactSet compact;
+    compact.times.reserve(set.endIndex - set.startIndex + 1);
+    for (int i = set.startIndex; i <= set.endIndex; i++) {
+        compact.times.push_back(set.buffer[i].time);
+    }
+    return compact;
+}
+
+IntervalSet fromCompactSet(IntervalSetHolder &holder, const CompactSet &set) {
+    const int count = static_cast<int>(set.times.size());
+    reserveTransitions(holder, count);
+    int newStartIndex = holder.writeIndex;
+    for (int i = 0; i < count; i++) {
+        holder.writeBuffer[holder.writeIndex++] = Transition{set.times[i], (i & 1) == 0};
+    }
+    return IntervalSet{holder.writeBuffer, newStartIndex, holder.writeIndex - 1};
+}
+
+std::vector<Interval> toVectorIntervals(const CompactSet &set) {
+    std::vector<Interval> intervals;
+    intervals.reserve(set.times.size() / 2);
+    for (size_t i = 0; i + 1 < set.times.size(); i += 2) {
+        intervals.push_back({set.times[i], set.times[i + 1]});
+    }
+    return intervals;
+}
+
+bool includes(const CompactSet &set, Time time) {
+    // Inside exactly when an odd number of transitions are at or before 'time'
+    size_t passed = std::upper_bound(set.times.begin(), set.times.end(), time) - set.times.begin();
+    return (passed & 1) != 0;
+}
+
+// In both sweeps, i and j count the transitions consumed so far, so an odd
+// count means the sweep is inside that set.
+void unionSets(const CompactSet &setA, const CompactSet &setB, CompactSet &out) {
+    const Time *a = setA.times.data();
+    const Time *b = setB.times.data();
+    const size_t na = setA.times.size();
+    const size_t nb = setB.times.size();
+    out.times.resize(na + nb);
+    Time *written = out.times.data();
+
+    size_t i = 0;
+    size_t j = 0;
+    while (i < na && j < nb) {
+        const Time t = std::min(a[i], b[j]);
+        const bool wasInSet = ((i | j) & 1) != 0;
+        i += a[i] == t;
+        j += b[j] == t;
+        const bool isInSet = ((i | j) & 1) != 0;
+        // Stored unconditionally and kept only on a change, which spares
+        // the sweep a branch that random sets mispredict half the time
+        *written = t;
+        written += wasInSet != isInSet;
+    }
+    // One set is used up and ended outside, so the rest is the other one as is
+    written = std::copy(a + i, a + na, written);
+    written = std::copy(b + j, b + nb, written);
+    out.times.resize(written - out.times.data());
+}
+
+void intersectSets(const CompactSet &setA, const CompactSet &setB, CompactSet &out) {
+    const Time *a = setA.times.data();
+    const Time *b = setB.times.data();
+    const size_t na = setA.times.size();
+    const size_t nb = setB.times.size();
+    out.times.resize(na + nb);
+    Time *written = out.times.data();
+
+    size_t i = 0;
+    size_t j = 0;
+    // Once either set is used up nothing more can be inside both
+    while (i < na && j < nb) {
+        const Time t = std::min(a[i], b[j]);
+        const bool wasInSet = ((i & j) & 1) != 0;
+        i += a[i] == t;
+        j += b[j] == t;
+        const bool isInSet = ((i & j) & 1) != 0;
+        *written = t;
+        written += wasInSet != isInSet;
+    }
+    out.times.resize(written - out.times.data());
+}
+
+void negateSet(const CompactSet &setA, Interval domain, CompactSet &out) {
+    out.times.clear();
+    if (domain.start >= domain.end) {
+        return;
+    }
+    auto first = std::upper_bound(setA.times.begin(), setA.times.end(), domain.start);
+    auto last = std::lower_bound(first, setA.times.end(), domain.end);
+    // The negation is on at domain.start when setA is off there
+    if (((first - setA.times.begin()) & 1) == 0) {
+        out.times.push_back(domain.start);
+    }
+    // Every transition of setA inside the domain flips the negation
+    out.times.insert(out.times.end(), first, last);
+    if (out.times.size() & 1) {
+        out.times.push_back(domain.end);
+    }
+}
+
+namespace {
+
+void appendVarint(std::vector<uint8_t> &bytes, uint64_t value) {
+    while (value >= 0x80) {
+        bytes.push_back(static_cast<uint8_t>(value | 0x80));
+        value >>= 7;
+    }
+    bytes.push_back(static_cast<uint8_t>(value));
+}
+
+uint64_t readVarint(const uint8_t *&in) {
+    uint64_t value = 0;
+    for (int shift = 0;; shift += 7) {
+        uint8_t byte = *in++;
+        value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+        if (byte < 0x80) {
+            return value;
+        }
+    }
+}
+
+} // namespace
+
+PackedSet packSet(const CompactSet &set) {
+    PackedSet packed{{}, static_cast<uint32_t>(set.times.size())};
+    if (set.times.empty()) {
+        return packed;
+    }
+    packed.bytes.reserve(set.times.size() * 2);
+    const int64_t first = set.times[0];
+    appendVarint(packed.bytes, (static_cast<uint64_t>(first) << 1) ^ static_cast<uint64_t>(first >> 63));
+    for (size_t i = 1; i < set.times.size(); i++) {
+        // Unsigned, so a gap from a negative time to B_INFINITY can't overflow
+        appendVarint(packed.bytes, static_cast<uint64_t>(set.times[i]) - static_cast<uint64_t>(set.times[i - 1]));
+    }
+    return packed;
+}
+
+void unpackSet(const PackedSet &packed, CompactSet &out) {
+    out.times.resize(packed.count);
+    if (packed.count == 0) {
+        return;
+    }
+    const uint8_t *in = packed.bytes.data();
+    const uint64_t zigzag = readVarint(in);
+    uint64_t time = (zigzag >> 1) ^ (~(zigzag & 1) + 1);
+    out.times[0] = static_cast<Time>(static_cast<int64_t>(time));
+    for (uint32_t i = 1; i < packed.count; i++) {
+        time += readVarint(in);
+        out.times[i] = static_cast<Time>(static_cast<int64_t>(time));
+    }
+}
+
+} // namespace db_interval_set
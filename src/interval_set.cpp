@@ -1,23 +1,109 @@
 #include "do-verify/interval_set.hpp"
 
+#include <cstddef>
+#include <utility>
+
 namespace db_interval_set {
 
 IntervalSetHolder newHolder(int bufferSize) {
+    bufferSize = std::max(bufferSize, 2);
     // Allocate Transition buffers
-    return IntervalSetHolder{new Transition[bufferSize], new Transition[bufferSize], 0, bufferSize};
+    return IntervalSetHolder{new Transition[bufferSize], new Transition[bufferSize], 0, bufferSize, bufferSize, 0, 0, {}, {}};
 }
 
 void swapBuffers(IntervalSetHolder &holder) {
+    holder.peakUsage = std::max(holder.peakUsage, holder.retiredUsage + holder.writeIndex);
+    holder.retiredUsage = 0;
+
+    // The sets in the buffers retired two steps ago are all dead now
+    for (Transition *buffer : holder.retiredReadBuffers) {
+        delete[] buffer;
+    }
+    holder.retiredReadBuffers.swap(holder.retiredWriteBuffers);
+    holder.retiredWriteBuffers.clear();
+
     Transition *temp = holder.readBuffer;
     holder.readBuffer = holder.writeBuffer;
     holder.writeBuffer = temp;
+    std::swap(holder.bufferSize, holder.readBufferSize);
     holder.writeIndex = 0;
+
+    // The new write buffer only holds dead sets, so catching it up with a
+    // buffer that grew during the last step costs no copying.
+    if (holder.bufferSize < holder.readBufferSize) {
+        delete[] holder.writeBuffer;
+        holder.bufferSize = holder.readBufferSize;
+        holder.writeBuffer = new Transition[holder.bufferSize];
+    }
+}
+
+void reserveTransitions(IntervalSetHolder &holder, int count) {
+    if (holder.writeIndex + count <= holder.bufferSize) {
+        return;
+    }
+    holder.retiredUsage += holder.writeIndex;
+    holder.retiredWriteBuffers.push_back(holder.writeBuffer);
+    holder.bufferSize = std::max(holder.bufferSize * 2, count);
+    holder.writeBuffer = new Transition[holder.bufferSize];
+    holder.writeIndex = 0;
+}
+
+int peakUsage(const IntervalSetHolder &holder) {
+    return std::max(holder.peakUsage, holder.retiredUsage + holder.writeIndex);
+}
+
+void resetPeakUsage(IntervalSetHolder &holder) {
+    holder.peakUsage = 0;
+    holder.retiredUsage = 0;
 }
 
 IntervalSet empty(IntervalSetHolder &holder) {
     return IntervalSet{holder.writeBuffer, 1, 0};
 }
 
+namespace {
+
+// First transition in [first, last) at 'time' or later, or strictly later
+// when 'after'. Searches from the front in doubling steps, so an answer d
+// transitions in costs O(log d) rather than O(log(last - first)).
+const Transition *gallop(const Transition *first, const Transition *last, Time time, bool after) {
+    auto isBefore = [time, after](const Transition &t) { return after ? t.time <= time : t.time < time; };
+    const std::ptrdiff_t size = last - first;
+    std::ptrdiff_t bound = 1;
+    while (bound <= size && isBefore(first[bound - 1])) {
+        bound *= 2;
+    }
+    return std::partition_point(first + bound / 2, first + std::min(bound, size), isBefore);
+}
+
+// Writes [begin, end) AND interval to 'written' and returns the new end.
+// Every transition lands at or before where it is read from, so 'written'
+// may point into the same buffer at or before 'begin'.
+Transition *writeClipped(const Transition *begin, const Transition *end, Interval interval, Transition *written) {
+    if (interval.start >= interval.end) {
+        return written;
+    }
+    auto byTime = [](const Transition &t, Time time) { return t.time < time; };
+    auto timeBefore = [](Time time, const Transition &t) { return time < t.time; };
+    const Transition *first = std::upper_bound(begin, end, interval.start, timeBefore);
+    const Transition *last = std::lower_bound(first, end, interval.end, byTime);
+    if (((first - begin) & 1) != 0) {
+        *written++ = Transition{interval.start, true};
+    }
+    written = std::copy(first, last, written);
+    if (((last - begin) & 1) != 0) {
+        *written++ = Transition{interval.end, false};
+    }
+    return written;
+}
+
+// The set ends where the holder writes next, so it can grow in place
+bool isLastWritten(const IntervalSetHolder &holder, const IntervalSet &set) {
+    return set.buffer == holder.writeBuffer && set.endIndex == holder.writeIndex - 1;
+}
+
+} // namespace
+
 /**
  * @brief Checks if a single time point is contained within the interval set.
  * Since intervals are [start, end), start is inclusive and end is exclusive.
@@ -26,17 +112,41 @@ IntervalSet empty(IntervalSetHolder &holder) {
  * @param time The time point to query.
  * @return true if the time point is in the set, false otherwise.
  */
-bool includes(const IntervalSet& set, int time) {
-    bool state = false;
-    for (int i = set.startIndex; i <= set.endIndex; ++i) {
-        const Transition& t = set.buffer[i];
-        if (t.time <= time) {
-            state = t.isStart;
-        } else {
-            break; // No need to check further transitions
+bool includes(const IntervalSet& set, Time time) {
+    const Transition *begin = set.buffer + set.startIndex;
+    const Transition *next = gallop(begin, set.buffer + set.endIndex + 1, time, true);
+    // The last transition at or before 'time' decides
+    return next != begin && next[-1].isStart;
+}
+
+std::vector<bool> includesEach(const IntervalSet& set, const std::vector<Time>& times) {
+    std::vector<bool> result(times.size());
+    const Transition *begin = set.buffer + set.startIndex;
+    const Transition *end = set.buffer + set.endIndex + 1;
+    const Transition *next = begin;
+    for (size_t k = 0; k < times.size(); k++) {
+        // Sorted queries only move forward, so one pass serves them all
+        next = gallop(next, end, times[k], true);
+        result[k] = next != begin && next[-1].isStart;
+    }
+    return result;
+}
+
+Time nextChange(const IntervalSet& set, Time time) {
+    const Transition *begin = set.buffer + set.startIndex;
+    const Transition *end = set.buffer + set.endIndex + 1;
+    const Transition *next = gallop(begin, end, time, true);
+    bool inSet = next != begin && next[-1].isStart;
+    while (next != end) {
+        // Transitions at the same time apply together, so an empty [t, t)
+        // interval changes nothing
+        const Transition *group = gallop(next, end, next->time, true);
+        if (group[-1].isStart != inSet) {
+            return next->time;
         }
+        next = group;
     }
-    return state;
+    return std::numeric_limits<Time>::max();
 }
 
 /**
@@ -44,6 +154,7 @@ bool includes(const IntervalSet& set, int time) {
  * This is the primary way to get data into the system.
  */
 IntervalSet fromInterval(IntervalSetHolder &holder, Interval interval) {
+    reserveTransitions(holder, 2);
     int newStartIndex = holder.writeIndex;
     
     // Only add a non-empty interval
@@ -61,6 +172,7 @@ IntervalSet fromInterval(IntervalSetHolder &holder, Interval interval) {
  * before calling swapBuffers().
  */
 IntervalSet copySet(IntervalSetHolder& holder, IntervalSet set) {
+    reserveTransitions(holder, set.endIndex - set.startIndex + 1);
     int newStartIndex = holder.writeIndex;
     
     // Read from the set's *own* buffer (could be read or write)
@@ -73,42 +185,99 @@ IntervalSet copySet(IntervalSetHolder& holder, IntervalSet set) {
     return IntervalSet{holder.writeBuffer, newStartIndex, holder.writeIndex - 1};
 }
 
+namespace {
+
+// The galloping versions below walk the intervals of a set at most 1/8 the
+// size of the other one
+constexpr int GALLOP_RATIO = 8;
+
+// In the sweeps below, the sweep is inside 'large' exactly when an odd
+// number of its transitions lie before the current position, as a
+// normalised set alternates starts and ends. Everything of 'large' between
+// two intervals of 'small' is copied as is.
+
+Transition *unionGalloping(const Transition *large, int countLarge, const Transition *small, int countSmall,
+                           Transition *written) {
+    const Transition *end = large + countLarge;
+    const Transition *next = large;
+    for (int k = 0; k + 1 < countSmall; k += 2) {
+        const Transition *first = gallop(next, end, small[k].time, false);
+        written = std::copy(next, first, written);
+        if (((first - large) & 1) == 0) {
+            *written++ = small[k];
+        }
+        // Transitions of 'large' inside the interval, or touching it, vanish
+        next = gallop(first, end, small[k + 1].time, true);
+        if (((next - large) & 1) == 0) {
+            *written++ = small[k + 1];
+        }
+    }
+    return std::copy(next, end, written);
+}
+
+Transition *intersectGalloping(const Transition *large, int countLarge, const Transition *small, int countSmall,
+                               Transition *written) {
+    const Transition *end = large + countLarge;
+    const Transition *next = large;
+    for (int k = 0; k + 1 < countSmall; k += 2) {
+        const Transition *first = gallop(next, end, small[k].time, true);
+        if (((first - large) & 1) != 0) {
+            *written++ = small[k];
+        }
+        next = gallop(first, end, small[k + 1].time, false);
+        written = std::copy(first, next, written);
+        if (((next - large) & 1) != 0) {
+            *written++ = small[k + 1];
+        }
+    }
+    return written;
+}
+
+} // namespace
+
+// In both sweeps, i and j count the transitions consumed so far. A
+// normalised set alternates starts and ends, so the sweep is inside a set
+// exactly when its count is odd, and neither sweep reads isStart. Which
+// set moves on is the only thing that depends on the data, and it becomes
+// a conditional add instead of a branch that fresh sets mispredict about
+// every other transition.
+
 /**
  * @brief Computes the union (OR) of two sets using a plane-sweep algorithm.
  */
 IntervalSet unionSets(IntervalSetHolder &holder, IntervalSet setA, IntervalSet setB) {
+    const Transition *a = setA.buffer + setA.startIndex;
+    const Transition *b = setB.buffer + setB.startIndex;
+    const int countA = setA.endIndex - setA.startIndex + 1;
+    const int countB = setB.endIndex - setB.startIndex + 1;
+    reserveTransitions(holder, countA + countB);
     int newStartIndex = holder.writeIndex;
-    int i = setA.startIndex;
-    int j = setB.startIndex;
-
-    int overlap = 0; // "Winding number" or overlap count (can be 0, 1, or 2)
-
-    while (i <= setA.endIndex || j <= setB.endIndex) {
-        // Determine the next time point to process
-        int t = std::numeric_limits<int>::max();
-        if (i <= setA.endIndex) t = std::min(t, setA.buffer[i].time);
-        if (j <= setB.endIndex) t = std::min(t, setB.buffer[j].time);
-        
-        bool wasInSet = (overlap > 0);
-
-        if (i <= setA.endIndex && setA.buffer[i].time == t) {
-            overlap += (setA.buffer[i].isStart ? 1 : -1);
-            i++;
-        }
-        if (j <= setB.endIndex && setB.buffer[j].time == t) {
-            overlap += (setB.buffer[j].isStart ? 1 : -1);
-            j++;
-        }
+    Transition *written = holder.writeBuffer + newStartIndex;
 
-        bool isInSet = (overlap > 0);
+    if (countB * GALLOP_RATIO <= countA || countA * GALLOP_RATIO <= countB) {
+        written = countA > countB ? unionGalloping(a, countA, b, countB, written)
+                                  : unionGalloping(b, countB, a, countA, written);
+        holder.writeIndex = static_cast<int>(written - holder.writeBuffer);
+        return IntervalSet{holder.writeBuffer, newStartIndex, holder.writeIndex - 1};
+    }
 
-        // If the state changed (e.g., from 0 to 1, or 1 to 0),
-        // we write a new transition to the output.
-        if (wasInSet != isInSet) {
-            holder.writeBuffer[holder.writeIndex++] = Transition{t, isInSet};
-        }
+    int i = 0;
+    int j = 0;
+    while (i < countA && j < countB) {
+        const Time t = std::min(a[i].time, b[j].time);
+        const bool wasInSet = ((i | j) & 1) != 0;
+        i += a[i].time == t;
+        j += b[j].time == t;
+        const bool isInSet = ((i | j) & 1) != 0;
+        // Stored unconditionally and kept only on a change
+        *written = Transition{t, isInSet};
+        written += wasInSet != isInSet;
     }
-    
+    // One set is used up and ended outside, so the rest is the other one as is
+    written = std::copy(a + i, a + countA, written);
+    written = std::copy(b + j, b + countB, written);
+
+    holder.writeIndex = static_cast<int>(written - holder.writeBuffer);
     return IntervalSet{holder.writeBuffer, newStartIndex, holder.writeIndex - 1};
 }
 
@@ -116,46 +285,181 @@ IntervalSet unionSets(IntervalSetHolder &holder, IntervalSet setA, IntervalSet s
  * @brief Computes the intersection (AND) of two sets.
  */
 IntervalSet intersectSets(IntervalSetHolder &holder, IntervalSet setA, IntervalSet setB) {
+    const Transition *a = setA.buffer + setA.startIndex;
+    const Transition *b = setB.buffer + setB.startIndex;
+    const int countA = setA.endIndex - setA.startIndex + 1;
+    const int countB = setB.endIndex - setB.startIndex + 1;
+    reserveTransitions(holder, countA + countB);
     int newStartIndex = holder.writeIndex;
-    int i = setA.startIndex;
-    int j = setB.startIndex;
+    Transition *written = holder.writeBuffer + newStartIndex;
 
-    // A normalized set's "overlap" is just 0 or 1 (i.e., true/false).
-    bool isInA = false; 
-    bool isInB = false;
+    if (countB * GALLOP_RATIO <= countA || countA * GALLOP_RATIO <= countB) {
+        written = countA > countB ? intersectGalloping(a, countA, b, countB, written)
+                                  : intersectGalloping(b, countB, a, countA, written);
+        holder.writeIndex = static_cast<int>(written - holder.writeBuffer);
+        return IntervalSet{holder.writeBuffer, newStartIndex, holder.writeIndex - 1};
+    }
 
-    while (i <= setA.endIndex || j <= setB.endIndex) {
-        int t = std::numeric_limits<int>::max();
-        if (i <= setA.endIndex) t = std::min(t, setA.buffer[i].time);
-        if (j <= setB.endIndex) t = std::min(t, setB.buffer[j].time);
+    int i = 0;
+    int j = 0;
+    // Once either set is used up nothing more can be inside both
+    while (i < countA && j < countB) {
+        const Time t = std::min(a[i].time, b[j].time);
+        const bool wasInSet = ((i & j) & 1) != 0;
+        i += a[i].time == t;
+        j += b[j].time == t;
+        const bool isInSet = ((i & j) & 1) != 0;
+        *written = Transition{t, isInSet};
+        written += wasInSet != isInSet;
+    }
 
-        bool wasInSet = (isInA && isInB);
+    holder.writeIndex = static_cast<int>(written - holder.writeBuffer);
+    return IntervalSet{holder.writeBuffer, newStartIndex, holder.writeIndex - 1};
+}
 
-        if (i <= setA.endIndex && setA.buffer[i].time == t) {
-            isInA = setA.buffer[i].isStart; // Just update the flag
-            i++;
-        }
-        if (j <= setB.endIndex && setB.buffer[j].time == t) {
-            isInB = setB.buffer[j].isStart;
-            j++;
-        }
+IntervalSet clipToInterval(IntervalSetHolder &holder, IntervalSet setA, Interval interval) {
+    const Transition *begin = setA.buffer + setA.startIndex;
+    const Transition *end = setA.buffer + setA.endIndex + 1;
+    reserveTransitions(holder, static_cast<int>(end - begin) + 2);
+    int newStartIndex = holder.writeIndex;
+    Transition *written = writeClipped(begin, end, interval, holder.writeBuffer + newStartIndex);
 
-        bool isInSet = (isInA && isInB);
+    holder.writeIndex = static_cast<int>(written - holder.writeBuffer);
+    return IntervalSet{holder.writeBuffer, newStartIndex, holder.writeIndex - 1};
+}
 
-        // If the intersection state changed, write a transition
-        if (wasInSet != isInSet) {
-            holder.writeBuffer[holder.writeIndex++] = Transition{t, isInSet};
-        }
+IntervalSet unionWithInterval(IntervalSetHolder &holder, IntervalSet setA, Interval interval) {
+    if (interval.start >= interval.end) {
+        return copySet(holder, setA);
     }
-    
+    const Transition *begin = setA.buffer + setA.startIndex;
+    const Transition *end = setA.buffer + setA.endIndex + 1;
+    reserveTransitions(holder, static_cast<int>(end - begin) + 2);
+    int newStartIndex = holder.writeIndex;
+    Transition *written = holder.writeBuffer + newStartIndex;
+
+    auto byTime = [](const Transition &t, Time time) { return t.time < time; };
+    auto timeBefore = [](Time time, const Transition &t) { return time < t.time; };
+    const Transition *first = std::lower_bound(begin, end, interval.start, byTime);
+    const Transition *last = std::upper_bound(first, end, interval.end, timeBefore);
+    written = std::copy(begin, first, written);
+    if (((first - begin) & 1) == 0) {
+        *written++ = Transition{interval.start, true};
+    }
+    if (((last - begin) & 1) == 0) {
+        *written++ = Transition{interval.end, false};
+    }
+    written = std::copy(last, end, written);
+
+    holder.writeIndex = static_cast<int>(written - holder.writeBuffer);
     return IntervalSet{holder.writeBuffer, newStartIndex, holder.writeIndex - 1};
 }
 
+void unionWithIntervalInPlace(IntervalSetHolder &holder, IntervalSet &set, Interval interval) {
+    if (interval.start >= interval.end) {
+        return;
+    }
+    reserveTransitions(holder, 2);
+    if (!isLastWritten(holder, set)) {
+        set = unionWithInterval(holder, set, interval);
+        return;
+    }
+    Transition *begin = set.buffer + set.startIndex;
+    Transition *end = set.buffer + set.endIndex + 1;
+    auto byTime = [](const Transition &t, Time time) { return t.time < time; };
+    auto timeBefore = [](Time time, const Transition &t) { return time < t.time; };
+    Transition *first = std::lower_bound(begin, end, interval.start, byTime);
+    Transition *last = std::upper_bound(first, end, interval.end, timeBefore);
+    const bool addStart = ((first - begin) & 1) == 0;
+    const bool addEnd = ((last - begin) & 1) == 0;
+
+    // Move whatever follows the interval to just after the new transitions.
+    // Intervals mostly arrive in time order, so this is usually nothing.
+    Transition *suffix = first + addStart + addEnd;
+    Transition *newEnd = suffix + (end - last);
+    if (suffix < last) {
+        std::copy(last, end, suffix);
+    } else {
+        std::copy_backward(last, end, newEnd);
+    }
+    if (addStart) {
+        *first++ = Transition{interval.start, true};
+    }
+    if (addEnd) {
+        *first = Transition{interval.end, false};
+    }
+    set.endIndex = static_cast<int>(newEnd - set.buffer) - 1;
+    holder.writeIndex = set.endIndex + 1;
+}
+
+void clipToIntervalInPlace(IntervalSetHolder &holder, IntervalSet &set, Interval interval) {
+    if (set.buffer != holder.writeBuffer) {
+        set = clipToInterval(holder, set, interval);
+        return;
+    }
+    if (interval.start >= interval.end) {
+        set.endIndex = set.startIndex - 1;
+        return;
+    }
+    Transition *begin = set.buffer + set.startIndex;
+    Transition *end = set.buffer + set.endIndex + 1;
+    auto byTime = [](const Transition &t, Time time) { return t.time < time; };
+    auto timeBefore = [](Time time, const Transition &t) { return time < t.time; };
+    Transition *first = std::upper_bound(begin, end, interval.start, timeBefore);
+    Transition *last = std::lower_bound(first, end, interval.end, byTime);
+    // Inside an interval at either cut, its own start (or end) sits right
+    // before (or at) the cut and is overwritten with the cut
+    if (((last - begin) & 1) != 0) {
+        *last++ = Transition{interval.end, false};
+    }
+    if (((first - begin) & 1) != 0) {
+        *--first = Transition{interval.start, true};
+    }
+    set.startIndex = static_cast<int>(first - set.buffer);
+    set.endIndex = static_cast<int>(last - set.buffer) - 1;
+}
+
+void appendClipped(IntervalSetHolder &holder, IntervalSet &output, IntervalSet set, Interval interval) {
+    const Transition *begin = set.buffer + set.startIndex;
+    const Transition *end = set.buffer + set.endIndex + 1;
+    const bool outputEmpty = output.endIndex < output.startIndex;
+    Transition *written;
+
+    if (isLastWritten(holder, set) &&
+        (outputEmpty || (output.buffer == holder.writeBuffer && output.endIndex + 1 == set.startIndex))) {
+        // 'set' directly follows 'output', so the clipped part of it moves
+        // down onto the end of 'output' and the rest is dropped
+        written = set.buffer + set.startIndex;
+        if (outputEmpty) {
+            output = IntervalSet{set.buffer, set.startIndex, set.startIndex - 1};
+        }
+    } else {
+        reserveTransitions(holder, (output.endIndex - output.startIndex + 1) + static_cast<int>(end - begin) + 2);
+        if (outputEmpty) {
+            output = IntervalSet{holder.writeBuffer, holder.writeIndex, holder.writeIndex - 1};
+        } else if (!isLastWritten(holder, output)) {
+            output = copySet(holder, output);
+        }
+        written = holder.writeBuffer + holder.writeIndex;
+    }
+
+    Transition *appended = written;
+    written = writeClipped(begin, end, interval, written);
+    // An interval of 'output' ending where the first appended one starts
+    // merges with it
+    if (appended != written && output.endIndex >= output.startIndex && appended[-1].time == appended[0].time) {
+        written = std::copy(appended + 1, written, appended - 1);
+    }
+    output.endIndex = static_cast<int>(written - output.buffer) - 1;
+    holder.writeIndex = output.endIndex + 1;
+}
+
 /**
  * @brief Computes the negation of a set within a given domain.
  * This is (domain AND (NOT setA)).
  */
 IntervalSet negateSet(IntervalSetHolder &holder, IntervalSet setA, Interval domain) {
+    reserveTransitions(holder, (setA.endIndex - setA.startIndex + 1) + 2);
     int newStartIndex = holder.writeIndex;
     int i = setA.startIndex;
 
@@ -206,6 +510,14 @@ IntervalSet negateSet(IntervalSetHolder &holder, IntervalSet setA, Interval doma
 void destroyHolder(IntervalSetHolder &holder) {
     delete[] holder.writeBuffer;
     delete[] holder.readBuffer;
+    for (Transition *buffer : holder.retiredWriteBuffers) {
+        delete[] buffer;
+    }
+    for (Transition *buffer : holder.retiredReadBuffers) {
+        delete[] buffer;
+    }
+    holder.retiredWriteBuffers.clear();
+    holder.retiredReadBuffers.clear();
 }
 
 // --- NEW SEGMENT ITERATOR FUNCTIONS ---
@@ -275,11 +587,11 @@ bool getNextSegment(SegmentIterator& it) {
     }
 
     // 1. Find the time `t` of the *next* transition from either set
-    int t = it.domain.end; // Default to the end of the domain
+    Time t = it.domain.end; // Default to the end of the domain
 
     // Check for the next transition in setA
     if (it.leftIndex <= it.leftIntervalSet.endIndex) {
-        int tA = it.leftIntervalSet.buffer[it.leftIndex].time;
+        Time tA = it.leftIntervalSet.buffer[it.leftIndex].time;
         // Only consider transitions *within* the domain
         if (tA < it.domain.end) {
             t = std::min(t, tA);
@@ -287,7 +599,7 @@ bool getNextSegment(SegmentIterator& it) {
     }
     // Check for the next transition in setB
     if (it.rightIndex <= it.rightIntervalSet.endIndex) {
-        int tB = it.rightIntervalSet.buffer[it.rightIndex].time;
+        Time tB = it.rightIntervalSet.buffer[it.rightIndex].time;
         // Only consider transitions *within* the domain
         if (tB < it.domain.end) {
             t = std::min(t, tB);
@@ -341,7 +653,7 @@ std::vector<Interval> toVectorIntervals(const IntervalSet& set) {
         return result; // Empty set
     }
 
-    int intervalStart = 0;
+    Time intervalStart = 0;
     // This assumes the set is normalized (no overlapping starts)
     // which our union/intersect/negate functions guarantee.
     
@@ -385,6 +697,7 @@ bool compareTransitions(const Transition& a, const Transition& b) {
 IntervalSet createSetFromIntervals(
     IntervalSetHolder& holder, 
     const std::vector<Interval>& intervals) {
+    reserveTransitions(holder, static_cast<int>(intervals.size()) * 2);
     int newStartIndex = holder.writeIndex;
     
     // 1. Create all transitions in a temporary vector
@@ -408,9 +721,6 @@ IntervalSet createSetFromIntervals(
         bool isInSet = (overlap > 0);
 
         if (wasInSet != isInSet) {
-            // Check for buffer overflow
-            // (In a real benchmark, just make the buffer huge)
-            // if (holder.writeIndex >= MAX_BUFFER_SIZE) { ... }
             holder.writeBuffer[holder.writeIndex++] = {t.time, isInSet};
         }
     }
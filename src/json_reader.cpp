@@ -1,5 +1,15 @@
 #include "do-verify/json_reader.hpp"
 
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <unistd.h>
+#include <cstring>
+
+#if defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
 namespace json_reader {
 
 TimescalesInput read_line(std::string &line) {
@@ -35,4 +45,420 @@ TimescalesInput read_line(std::string &line) {
 
 }
 
+JsonlParseError::JsonlParseError(const std::string &message, size_t offset)
+    : std::runtime_error(message + " at byte " + std::to_string(offset)), offset(offset) {}
+
+namespace {
+
+constexpr int TIME_SLOT = -1;
+constexpr int IGNORED_SLOT = -2;
+
+// --- Structural character scan ---
+// Each function returns a bitmask with bit i set when block[i] is one of
+// { } " : , or a newline. Blocks are always 64 bytes.
+
+using StructuralMaskFunction = uint64_t (*)(const char *block);
+
+#if !defined(__SSE2__)
+bool isStructural(char c) {
+    return c == '{' || c == '}' || c == '"' || c == ':' || c == ',' || c == '\n';
+}
+
+uint64_t structuralMaskScalar(const char *block) {
+    uint64_t mask = 0;
+    for (int i = 0; i < 64; i++) {
+        if (isStructural(block[i])) {
+            mask |= uint64_t(1) << i;
+        }
+    }
+    return mask;
+}
+#endif
+
+#if defined(__SSE2__)
+uint64_t structuralMaskSse2(const char *block) {
+    const __m128i openBrace = _mm_set1_epi8('{');
+    const __m128i closeBrace = _mm_set1_epi8('}');
+    const __m128i quote = _mm_set1_epi8('"');
+    const __m128i colon = _mm_set1_epi8(':');
+    const __m128i comma = _mm_set1_epi8(',');
+    const __m128i newline = _mm_set1_epi8('\n');
+    uint64_t mask = 0;
+    for (int i = 0; i < 64; i += 16) {
+        __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i *>(block + i));
+        __m128i hits = _mm_or_si128(
+            _mm_or_si128(_mm_cmpeq_epi8(chunk, openBrace), _mm_cmpeq_epi8(chunk, closeBrace)),
+            _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(chunk, quote), _mm_cmpeq_epi8(chunk, colon)),
+                         _mm_or_si128(_mm_cmpeq_epi8(chunk, comma), _mm_cmpeq_epi8(chunk, newline))));
+        mask |= uint64_t(static_cast<uint32_t>(_mm_movemask_epi8(hits))) << i;
+    }
+    return mask;
+}
+#endif
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define JSONL_HAVE_AVX2 1
+__attribute__((target("avx2")))
+uint64_t structuralMaskAvx2(const char *block) {
+    const __m256i openBrace = _mm256_set1_epi8('{');
+    const __m256i closeBrace = _mm256_set1_epi8('}');
+    const __m256i quote = _mm256_set1_epi8('"');
+    const __m256i colon = _mm256_set1_epi8(':');
+    const __m256i comma = _mm256_set1_epi8(',');
+    const __m256i newline = _mm256_set1_epi8('\n');
+    uint64_t mask = 0;
+    for (int i = 0; i < 64; i += 32) {
+        __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(block + i));
+        __m256i hits = _mm256_or_si256(
+            _mm256_or_si256(_mm256_cmpeq_epi8(chunk, openBrace), _mm256_cmpeq_epi8(chunk, closeBrace)),
+            _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(chunk, quote), _mm256_cmpeq_epi8(chunk, colon)),
+                            _mm256_or_si256(_mm256_cmpeq_epi8(chunk, comma), _mm256_cmpeq_epi8(chunk, newline))));
+        mask |= uint64_t(static_cast<uint32_t>(_mm256_movemask_epi8(hits))) << i;
+    }
+    return mask;
+}
+#endif
+
+StructuralMaskFunction pickStructuralMask() {
+#if defined(JSONL_HAVE_AVX2)
+    if (__builtin_cpu_supports("avx2")) {
+        return structuralMaskAvx2;
+    }
+#endif
+#if defined(__SSE2__)
+    return structuralMaskSse2;
+#else
+    return structuralMaskScalar;
+#endif
+}
+
+const StructuralMaskFunction structuralMask = pickStructuralMask();
+
+// --- Line state machine ---
+
+enum class State {
+    LINE_START,   // Before '{', blank lines are skipped
+    EXPECT_KEY,   // After '{' or ','
+    IN_KEY,
+    EXPECT_COLON,
+    IN_VALUE,
+    IN_STRING_VALUE,
+    AFTER_OBJECT, // After '}', only a newline may follow
+};
+
+bool isSpace(char c) {
+    return c == ' ' || c == '\t' || c == '\r';
+}
+
+// A quote inside a string is escaped when an odd run of backslashes
+// precedes it, as in "a\"b" but not "a\\". Backslashes aren't structural,
+// so the run is counted back from the quote, never past the string's start.
+bool isEscaped(const char *data, size_t quote, size_t stringStart) {
+    size_t backslashes = 0;
+    while (quote - backslashes > stringStart && data[quote - backslashes - 1] == '\\') {
+        backslashes++;
+    }
+    return (backslashes & 1) != 0;
+}
+
+// Only whitespace may sit between a structural character and the next one
+// outside of values. These gaps are a byte or two in practice, so they are
+// checked here rather than with another mask.
+void requireSpace(const char *data, size_t start, size_t end, const char *expected) {
+    for (size_t pos = start; pos < end; pos++) {
+        if (!isSpace(data[pos])) {
+            throw JsonlParseError(expected, pos);
+        }
+    }
+}
+
+int slotFor(JsonlParser &parser, size_t field, const char *key, size_t length) {
+    if (field < parser.fieldKeys.size()) {
+        const std::string &cached = parser.fieldKeys[field];
+        if (cached.size() == length && std::memcmp(cached.data(), key, length) == 0) {
+            return parser.fieldSlots[field];
+        }
+    }
+
+    int slot = IGNORED_SLOT;
+    if (parser.timeKey.size() == length && std::memcmp(parser.timeKey.data(), key, length) == 0) {
+        slot = TIME_SLOT;
+    } else {
+        for (size_t i = 0; i < parser.propositions.size(); i++) {
+            const std::string &name = parser.propositions[i];
+            if (name.size() == length && std::memcmp(name.data(), key, length) == 0) {
+                slot = static_cast<int>(i);
+                parser.seen[i] = true;
+                break;
+            }
+        }
+    }
+
+    if (field < parser.fieldKeys.size()) {
+        parser.fieldKeys[field].assign(key, length);
+        parser.fieldSlots[field] = slot;
+    } else {
+        parser.fieldKeys.emplace_back(key, length);
+        parser.fieldSlots.push_back(slot);
+    }
+    return slot;
+}
+
+void storeValue(int slot, const char *data, size_t start, size_t end, bool isString, size_t timeBytes, char *row) {
+    if (slot == IGNORED_SLOT) {
+        return;
+    }
+    while (start < end && isSpace(data[start])) start++;
+    while (end > start && isSpace(data[end - 1])) end--;
+
+    if (slot == TIME_SLOT) {
+        size_t pos = start;
+        bool negative = pos < end && data[pos] == '-';
+        if (negative) pos++;
+        if (isString || pos == end) {
+            throw JsonlParseError("Expected an integer time", start);
+        }
+        const int64_t limit = timeBytes == sizeof(int64_t) ? INT64_MAX : INT32_MAX;
+        int64_t value = 0;
+        for (; pos < end; pos++) {
+            char c = data[pos];
+            if (c < '0' || c > '9') {
+                throw JsonlParseError("Expected an integer time", start);
+            }
+            if (value > (limit - (c - '0')) / 10) {
+                throw JsonlParseError("Time does not fit in " + std::to_string(timeBytes * 8) + " bits", start);
+            }
+            value = value * 10 + (c - '0');
+        }
+        const int64_t time = negative ? -value : value;
+        if (timeBytes == sizeof(int64_t)) {
+            std::memcpy(row, &time, sizeof(time));
+        }
+        else {
+            const int32_t narrow = static_cast<int32_t>(time);
+            std::memcpy(row, &narrow, sizeof(narrow));
+        }
+        return;
+    }
+
+    // A repeated key takes its last value, so false has to clear the bit
+    char &byte = row[timeBytes + slot / 8];
+    if (!isString && end - start == 4 && std::memcmp(data + start, "true", 4) == 0) {
+        byte = static_cast<char>(byte | (1u << (slot % 8)));
+    } else if (!isString && end - start == 5 && std::memcmp(data + start, "false", 5) == 0) {
+        byte = static_cast<char>(byte & ~(1u << (slot % 8)));
+    } else {
+        throw JsonlParseError("Expected true or false", start);
+    }
+}
+
+} // namespace
+
+JsonlParser newJsonlParser(const std::vector<std::string> &propositions, const std::string &timeKey) {
+    const size_t timeBytes = sizeof(db_interval_set::Time);
+    return JsonlParser{propositions, timeKey, timeBytes, timeBytes + (propositions.size() + 7) / 8, {}, {},
+                       std::vector<bool>(propositions.size(), false)};
+}
+
+std::vector<std::string> missingPropositions(const JsonlParser &parser) {
+    std::vector<std::string> missing;
+    for (size_t i = 0; i < parser.propositions.size(); i++) {
+        if (!parser.seen[i]) {
+            missing.push_back(parser.propositions[i]);
+        }
+    }
+    return missing;
+}
+
+binary_row_reader::TraceHeader jsonlHeader(const JsonlParser &parser) {
+    std::string encoded = binary_row_reader::encodeTraceHeader(parser.propositions, 0, parser.timeBytes);
+    binary_row_reader::TraceHeader header;
+    binary_row_reader::parseTraceHeader(encoded.data(), encoded.size(), header);
+    header.dataOffset = 0;
+    return header;
+}
+
+size_t parseRows(JsonlParser &parser, const char *data, size_t length, bool atEnd,
+                 char *rows, size_t maxRows, size_t &consumed) {
+    State state = State::LINE_START;
+    size_t lineStart = 0;
+    size_t rowCount = 0;
+    size_t field = 0;
+    size_t keyStart = 0;
+    size_t valueStart = 0;
+    size_t stringStart = 0;
+    size_t gapStart = 0;
+    int slot = IGNORED_SLOT;
+    bool valueIsString = false;
+    bool hasTime = false;
+    char *row = rows;
+    consumed = 0;
+
+    if (maxRows == 0) {
+        return 0;
+    }
+
+    alignas(64) char padded[64];
+    for (size_t blockStart = 0; blockStart < length; blockStart += 64) {
+        uint64_t mask;
+        if (length - blockStart >= 64) {
+            mask = structuralMask(data + blockStart);
+        } else {
+            // Zero bytes are not structural, so padding the tail is safe
+            std::memset(padded, 0, sizeof(padded));
+            std::memcpy(padded, data + blockStart, length - blockStart);
+            mask = structuralMask(padded);
+        }
+
+        while (mask != 0) {
+            size_t pos = blockStart + static_cast<size_t>(__builtin_ctzll(mask));
+            mask &= mask - 1;
+            char c = data[pos];
+
+            switch (state) {
+            case State::LINE_START:
+                requireSpace(data, gapStart, pos, "Expected '{'");
+                if (c == '{') {
+                    row = rows + rowCount * parser.rowBytes;
+                    std::memset(row, 0, parser.rowBytes);
+                    field = 0;
+                    hasTime = false;
+                    state = State::EXPECT_KEY;
+                } else if (c == '\n') {
+                    lineStart = pos + 1;
+                } else {
+                    throw JsonlParseError("Expected '{'", pos);
+                }
+                break;
+            case State::EXPECT_KEY:
+                requireSpace(data, gapStart, pos, "Expected a key");
+                if (c == '"') {
+                    keyStart = pos + 1;
+                    state = State::IN_KEY;
+                } else if (c == '}' && field == 0) {
+                    throw JsonlParseError("Missing the time key '" + parser.timeKey + "'", pos);
+                } else {
+                    throw JsonlParseError("Expected a key", pos);
+                }
+                break;
+            case State::IN_KEY:
+                if (c == '"' && !isEscaped(data, pos, keyStart)) {
+                    slot = slotFor(parser, field, data + keyStart, pos - keyStart);
+                    field++;
+                    state = State::EXPECT_COLON;
+                } else if (c == '\n') {
+                    throw JsonlParseError("Unterminated key", pos);
+                }
+                break;
+            case State::EXPECT_COLON:
+                requireSpace(data, gapStart, pos, "Expected ':'");
+                if (c != ':') {
+                    throw JsonlParseError("Expected ':'", pos);
+                }
+                valueStart = pos + 1;
+                valueIsString = false;
+                state = State::IN_VALUE;
+                break;
+            case State::IN_VALUE:
+                // A string value is closed, so only whitespace may follow it
+                if (valueIsString) {
+                    requireSpace(data, gapStart, pos, "Expected ',' or '}'");
+                }
+                if (c == ',' || c == '}') {
+                    storeValue(slot, data, valueStart, pos, valueIsString, parser.timeBytes, row);
+                    hasTime |= slot == TIME_SLOT;
+                    if (c == '}' && !hasTime) {
+                        throw JsonlParseError("Missing the time key '" + parser.timeKey + "'", pos);
+                    }
+                    state = c == ',' ? State::EXPECT_KEY : State::AFTER_OBJECT;
+                } else if (c == '"' && !valueIsString) {
+                    requireSpace(data, valueStart, pos, "Expected ',' or '}'");
+                    valueIsString = true;
+                    stringStart = pos + 1;
+                    state = State::IN_STRING_VALUE;
+                } else if (c == '"') {
+                    throw JsonlParseError("Expected ',' or '}'", pos);
+                } else {
+                    throw JsonlParseError("Nested values are not supported", pos);
+                }
+                break;
+            case State::IN_STRING_VALUE:
+                if (c == '"' && !isEscaped(data, pos, stringStart)) {
+                    state = State::IN_VALUE;
+                } else if (c == '\n') {
+                    throw JsonlParseError("Unterminated string", pos);
+                }
+                break;
+            case State::AFTER_OBJECT:
+                requireSpace(data, gapStart, pos, "Expected the end of the line");
+                if (c != '\n') {
+                    throw JsonlParseError("Expected the end of the line", pos);
+                }
+                rowCount++;
+                lineStart = pos + 1;
+                state = State::LINE_START;
+                if (rowCount == maxRows) {
+                    consumed = lineStart;
+                    return rowCount;
+                }
+                break;
+            }
+            gapStart = pos + 1;
+        }
+    }
+
+    if (atEnd) {
+        if (state == State::AFTER_OBJECT) {
+            requireSpace(data, gapStart, length, "Expected the end of the line");
+            rowCount++;
+        } else if (state == State::LINE_START) {
+            requireSpace(data, gapStart, length, "Expected '{'");
+        } else {
+            throw JsonlParseError("Unterminated line", lineStart);
+        }
+        lineStart = length;
+    }
+    consumed = lineStart;
+    return rowCount;
+}
+
+JsonlStream openJsonlStream(int fd, JsonlParser parser, size_t batchRows) {
+    batchRows = std::max<size_t>(batchRows, 1);
+    size_t rowBytes = parser.rowBytes;
+    return JsonlStream{fd, std::move(parser), std::vector<char>(1 << 16), 0, 0,
+                       std::vector<char>(batchRows * rowBytes), batchRows, false, false};
+}
+
+binary_row_reader::RowBatch readBatch(JsonlStream &stream) {
+    size_t rowBytes = stream.parser.rowBytes;
+    while (true) {
+        size_t consumed = 0;
+        size_t count = parseRows(stream.parser, stream.text.data() + stream.textOffset, stream.textBytes,
+                                 stream.finished, stream.rows.data(), stream.batchRows, consumed);
+        stream.textOffset += consumed;
+        stream.textBytes -= consumed;
+        if (count > 0 || stream.finished) {
+            return binary_row_reader::RowBatch{stream.rows.data(), count, rowBytes, stream.parser.timeBytes};
+        }
+
+        // Not a single complete line buffered: move the partial line to the
+        // front, growing the buffer only for a line longer than all of it.
+        std::memmove(stream.text.data(), stream.text.data() + stream.textOffset, stream.textBytes);
+        stream.textOffset = 0;
+        if (stream.textBytes == stream.text.size()) {
+            stream.text.resize(stream.text.size() * 2);
+        }
+        ssize_t read_bytes = read(stream.fd, stream.text.data() + stream.textBytes, stream.text.size() - stream.textBytes);
+        if (read_bytes < 0 && errno == EINTR) {
+            continue;
+        }
+        if (read_bytes <= 0) {
+            stream.failed = read_bytes < 0;
+            stream.finished = true;
+            continue;
+        }
+        stream.textBytes += static_cast<size_t>(read_bytes);
+    }
+}
+
 } // namespace json_reader
@@ -0,0 +1,149 @@
+#include "do-verify/lane_engine.hpp"
+
+namespace do_verify {
+
+namespace {
+
+constexpr uint64_t ALL_LANES = ~uint64_t(0);
+
+// Clears, in every stored step, the lanes not in 'mask'. OR distributes over
+// AND, so the front stack's running ORs stay valid when masked one by one.
+void maskWindow(LaneWindow &window, uint64_t mask) {
+    for (LaneEntry &entry : window.pending) entry.lanes &= mask;
+    for (LaneEntry &entry : window.front) entry.lanes &= mask;
+    for (LaneEntry &entry : window.back) entry.lanes &= mask;
+    window.backLanes &= mask;
+    window.sticky &= mask;
+}
+
+/**
+ * Adds the lanes that held at 'time' and reports, per lane, whether some
+ * stored step t' satisfies t - b <= t' <= t - a, the discrete once[a:b]
+ * verdict.
+ */
+uint64_t stepWindow(LaneWindow &window, uint64_t lanes, Time a, Time b, Time time) {
+    if (lanes != 0) {
+        window.pending.push_back({time, lanes});
+    }
+    while (!window.pending.empty() && time - window.pending.front().time >= a) {
+        const LaneEntry &entry = window.pending.front();
+        if (b == B_INFINITY) {
+            window.sticky |= entry.lanes;
+        }
+        else {
+            window.back.push_back(entry);
+            window.backLanes |= entry.lanes;
+        }
+        window.pending.pop_front();
+    }
+    if (b == B_INFINITY) {
+        return window.sticky;
+    }
+
+    while (true) {
+        if (window.front.empty()) {
+            if (window.back.empty()) break;
+            uint64_t suffix = 0;
+            for (size_t i = window.back.size(); i-- > 0;) {
+                suffix |= window.back[i].lanes;
+                window.front.push_back({window.back[i].time, suffix});
+            }
+            window.back.clear();
+            window.backLanes = 0;
+        }
+        if (time - window.front.back().time > b) window.front.pop_back();
+        else break;
+    }
+    return window.backLanes | (window.front.empty() ? 0 : window.front.back().lanes);
+}
+
+// The lanes in which the operand held 'steps' steps ago, none before the
+// trace has had that many. 'pending' holds the last 'steps' steps.
+uint64_t delayLanes(LaneWindow &window, uint64_t lanes, Time steps, Time time) {
+    window.pending.push_back({time, lanes});
+    if (window.pending.size() <= static_cast<size_t>(steps)) {
+        return 0;
+    }
+    const uint64_t delayed = window.pending.front().lanes;
+    window.pending.pop_front();
+    return delayed;
+}
+
+} // namespace
+
+LaneProgram newLaneProgram(size_t nodeCount) {
+    LaneProgram program;
+    program.opcodes.resize(nodeCount, NodeType::TEST);
+    program.leftOperands.resize(nodeCount, 0);
+    program.rightOperands.resize(nodeCount, 0);
+    program.lowerBounds.resize(nodeCount, 0);
+    program.upperBounds.resize(nodeCount, 0);
+    program.outputs.resize(nodeCount, 0);
+    program.windows.resize(nodeCount, LaneWindow{{}, {}, {}, 0, 0});
+    return program;
+}
+
+uint64_t run_evaluation(LaneProgram &program, const Time time, const std::vector<uint64_t> &propositionLanes) {
+    const NodeType *opcodes = program.opcodes.data();
+    const unsigned int *left = program.leftOperands.data();
+    const unsigned int *right = program.rightOperands.data();
+    uint64_t *outputs = program.outputs.data();
+    const size_t nodeCount = program.opcodes.size();
+
+    for (size_t i = 0; i < nodeCount; i++) {
+        switch (opcodes[i]) {
+        case NodeType::PROPOSITION:
+            outputs[i] = propositionLanes[i];
+            break;
+        case NodeType::AND:
+            outputs[i] = outputs[left[i]] & outputs[right[i]];
+            break;
+        case NodeType::OR:
+            outputs[i] = outputs[left[i]] | outputs[right[i]];
+            break;
+        case NodeType::NOT:
+            outputs[i] = ~outputs[right[i]];
+            break;
+        case NodeType::IMPLIES:
+            outputs[i] = ~outputs[left[i]] | outputs[right[i]];
+            break;
+        case NodeType::EVENTUALLY:
+        case NodeType::EVENTUALLY_WINDOW:
+            outputs[i] = stepWindow(program.windows[i], outputs[right[i]],
+                                    program.lowerBounds[i], program.upperBounds[i], time);
+            break;
+        case NodeType::ALWAYS:
+        case NodeType::ALWAYS_WINDOW:
+            // historically p is !once !p
+            outputs[i] = ~stepWindow(program.windows[i], ~outputs[right[i]],
+                                     program.lowerBounds[i], program.upperBounds[i], time);
+            break;
+        case NodeType::SINCE:
+            // A lane where the left operand fails forgets every earlier right
+            // operand step, the rest behaves like once over the right operand.
+            if (outputs[left[i]] != ALL_LANES) {
+                maskWindow(program.windows[i], outputs[left[i]]);
+            }
+            outputs[i] = stepWindow(program.windows[i], outputs[right[i]],
+                                    program.lowerBounds[i], program.upperBounds[i], time);
+            break;
+        case NodeType::TEST:
+            break;
+        case NodeType::PREVIOUS:
+        case NodeType::DELAY:
+            outputs[i] = delayLanes(program.windows[i], outputs[right[i]], program.lowerBounds[i], time);
+            break;
+        case NodeType::RISE:
+            outputs[i] = outputs[right[i]] & ~delayLanes(program.windows[i], outputs[right[i]], 1, time);
+            break;
+        case NodeType::FALL:
+            outputs[i] = ~outputs[right[i]] & delayLanes(program.windows[i], outputs[right[i]], 1, time);
+            break;
+        default:
+            break;
+        }
+    }
+    return outputs[nodeCount - 1];
+}
+
+} // namespace do_verify
@@ -1,14 +1,26 @@
+#include <algorithm>
 #include <array>
+#include <chrono>
+#include <cstdlib>
 #include <cstddef>
 #include <iostream>
 #include <fstream>
+#include <functional>
+#include <optional>
 #include <string>
-#include <cstring>
 #include <argp.h>
+#include <fcntl.h>
+#include <sys/stat.h>
 #include <sys/types.h>
+#include <unistd.h>
 
 #include <do-verify/binary_row_reader.hpp>
+#include <do-verify/checkpoint.hpp>
+#include <do-verify/json_reader.hpp>
 #include <do-verify/MTLEngine.hpp>
+#include <do-verify/monitor.hpp>
+#include <do-verify/spec_compiler.hpp>
+#include <do-verify/verdict_writer.hpp>
 
 using namespace db_interval_set;
 using namespace do_verify;
@@ -17,25 +29,53 @@ using namespace do_verify;
 enum RYBINX_OPTS : uint8_t
 {
     OPT_DENSE = 'v',
-    OPT_DISCRETE = 'x'
+    OPT_DISCRETE = 'x',
+    OPT_STATS = 's',
+    OPT_JSONL = 'j',
+    OPT_OUTPUT = 'o',
+    OPT_FORMAT = 'f',
+    OPT_BATCH = 'b',
+    OPT_THREADS = 't',
+    OPT_CHECKPOINT = 'k',
+    OPT_CHECKPOINT_EVERY = 'c',
+    OPT_RESUME = 'r'
 };
 
 const char *argp_program_version = "do-verify-bin 0.1.0";
 const char *argp_program_bug_address = "Arinc Demir <github.com/arincdemir>";
 static const char *doc = "Do-verify (Reelay) on Binary Row format";
-static const char *args_doc = "SPEC FILE";
+static const char *args_doc = "SPEC [FILE]\nSPEC --batch TRACE_OR_DIR...";
 
 struct arguments
 {
-    char *spec;
-    char *file;
+    char *spec = nullptr;
+    char *file = nullptr; // stdin when missing or "-"
     bool dense = false;
     bool discrete = false;
+    bool stats = false;
+    bool jsonl = false;
+    char *output = nullptr; // stdout when missing or "-"
+    bool binary_output = false;
+    bool batch = false;
+    unsigned int threads = 0; // One per core when 0
+    std::vector<std::string> traces; // Every FILE argument, for --batch
+    char *checkpoint = nullptr; // FILE.ckpt, or do-verify.ckpt for stdin, when missing
+    size_t checkpoint_every = 0;
+    bool resume = false;
 };
 
 static std::array<struct argp_option, 12> options = {
     {{"dense", OPT_DENSE, nullptr, 0, "Use dense time model (default)", 0},
      {"discrete", OPT_DISCRETE, nullptr, 0, "Use discrete time model", 0},
+     {"stats", OPT_STATS, nullptr, 0, "Print interval set holder usage to stderr", 0},
+     {"jsonl", OPT_JSONL, nullptr, 0, "Read the trace as JSONL (default for *.jsonl files)", 0},
+     {"output", OPT_OUTPUT, "FILE", 0, "Write verdicts to FILE instead of stdout", 0},
+     {"format", OPT_FORMAT, "FORMAT", 0, "Verdict format: text (default) or binary", 0},
+     {"batch", OPT_BATCH, nullptr, 0, "Monitor every trace given (directories are expanded) in parallel and print a report", 0},
+     {"threads", OPT_THREADS, "N", 0, "Worker threads for --batch (default: one per core)", 0},
+     {"checkpoint", OPT_CHECKPOINT, "CKPT", 0, "Checkpoint file (default: FILE.ckpt, or do-verify.ckpt for stdin)", 0},
+     {"checkpoint-every", OPT_CHECKPOINT_EVERY, "N", 0, "Save the monitor state to the checkpoint file every N rows", 0},
+     {"resume", OPT_RESUME, nullptr, 0, "Continue from the checkpoint file instead of the start of the trace", 0},
      {nullptr}}};
 
 static error_t parse_opt(int key, char *arg, struct argp_state *state)
@@ -49,6 +89,40 @@ static error_t parse_opt(int key, char *arg, struct argp_state *state)
     case OPT_DISCRETE:
         arguments->discrete = true;
         break;
+    case OPT_STATS:
+        arguments->stats = true;
+        break;
+    case OPT_JSONL:
+        arguments->jsonl = true;
+        break;
+    case OPT_OUTPUT:
+        arguments->output = arg;
+        break;
+    case OPT_FORMAT:
+        if (std::string(arg) == "binary")
+        {
+            arguments->binary_output = true;
+        }
+        else if (std::string(arg) != "text")
+        {
+            argp_error(state, "unknown verdict format '%s'", arg);
+        }
+        break;
+    case OPT_BATCH:
+        arguments->batch = true;
+        break;
+    case OPT_THREADS:
+        arguments->threads = static_cast<unsigned int>(std::strtoul(arg, nullptr, 10));
+        break;
+    case OPT_CHECKPOINT:
+        arguments->checkpoint = arg;
+        break;
+    case OPT_CHECKPOINT_EVERY:
+        arguments->checkpoint_every = static_cast<size_t>(std::strtoull(arg, nullptr, 10));
+        break;
+    case OPT_RESUME:
+        arguments->resume = true;
+        break;
     case ARGP_KEY_ARG:
         if (state->arg_num == 0)
         {
@@ -57,13 +131,22 @@ static error_t parse_opt(int key, char *arg, struct argp_state *state)
         else
         {
             arguments->file = arg;
+            arguments->traces.push_back(arg);
         }
         break;
     case ARGP_KEY_END:
-        if (state->arg_num < 2)
+        if (state->arg_num < 1)
         {
             argp_usage(state);
         }
+        if (arguments->traces.size() > 1 && !arguments->batch)
+        {
+            argp_error(state, "several traces need --batch");
+        }
+        if (arguments->batch && (arguments->checkpoint_every > 0 || arguments->resume))
+        {
+            argp_error(state, "checkpoints are not supported with --batch");
+        }
         break;
     default:
         return ARGP_ERR_UNKNOWN;
@@ -72,8 +155,17 @@ static error_t parse_opt(int key, char *arg, struct argp_state *state)
 }
 static struct argp argp = {options.data(), parse_opt, args_doc, doc};
 
-void discrete_case(arguments arguments, std::vector<binary_row_reader::TimescalesInput> allInputs);
-void dense_case(arguments arguments, std::vector<binary_row_reader::TimescalesInput> allInputs);
+using InputSlots = monitor::InputSlots;
+using RowBatch = binary_row_reader::RowBatch;
+using RowSource = monitor::RowSource;
+
+// Rows pulled per read() when streaming from a pipe or stdin
+static constexpr size_t STREAM_BATCH_ROWS = 4096;
+// Verdict bytes buffered before they are written out
+static constexpr size_t VERDICT_BUFFER_BYTES = 1 << 16;
+
+static int batch_case(const spec_compiler::CompiledSpec &spec, const struct arguments &arguments, bool use_discrete);
+static void printStats(const IntervalSetHolder &holder);
 
 int main(int argc, char **argv)
 {
@@ -90,1319 +182,253 @@ int main(int argc, char **argv)
         use_discrete = true;
     }
 
-    std::ifstream input(arguments.file, std::ios::binary);
-    if (!input)
-    {
-        std::cerr << "Error opening file: " << arguments.file << std::endl;
-        return 1;
-    }
-
-    const auto &allInputs = binary_row_reader::readInputFile(arguments.file);
-
-    if (use_discrete)
-    {
-        discrete_case(arguments, allInputs);
-    }
-    else
-    {
-        dense_case(arguments, allInputs);
-    }
-}
-
-void discrete_case(arguments arguments, std::vector<binary_row_reader::TimescalesInput> allInputs)
-{
-    // AbsentAQ: historically((once[:N]{q}) -> ((not{p}) since {q}))
-    if (strcmp(arguments.spec, "historically((once[:10]{q}) -> ((not{p}) since {q}))") == 0)
+    spec_compiler::CompiledSpec spec;
+    try
     {
-        IntervalSetHolder holder = newHolder(1000);
-        DiscreteNode q{empty(holder), false, NodeType::PROPOSITION, 0, 0, 0, 0};
-        DiscreteNode p{empty(holder), false, NodeType::PROPOSITION, 0, 0, 0, 0};
-        DiscreteNode once{empty(holder), false, NodeType::EVENTUALLY, 0, 0, 0, 10};
-        DiscreteNode notNode{empty(holder), false, NodeType::NOT, 0, 1, 0, 0};
-        DiscreteNode since{empty(holder), false, NodeType::SINCE, 3, 0, 0, B_INFINITY};
-        DiscreteNode implies{empty(holder), false, NodeType::IMPLIES, 2, 4, 0, 0};
-        DiscreteNode always{empty(holder), false, NodeType::ALWAYS, 0, 5, 0, B_INFINITY};
-        std::vector<DiscreteNode> nodes{q, p, once, notNode, since, implies, always};
-
-        for (size_t i = 0; i < allInputs.size(); i++)
-        {
-            run_evaluation(nodes, holder, allInputs[i].time, {allInputs[i].q, allInputs[i].p});
-            swapBuffers(holder);
-        }
-        destroyHolder(holder);
+        spec = spec_compiler::compile(arguments.spec);
     }
-    else if (strcmp(arguments.spec, "historically((once[:100]{q}) -> ((not{p}) since {q}))") == 0)
+    catch (const spec_compiler::SpecParseError &e)
     {
-        IntervalSetHolder holder = newHolder(1000);
-        DiscreteNode q{empty(holder), false, NodeType::PROPOSITION, 0, 0, 0, 0};
-        DiscreteNode p{empty(holder), false, NodeType::PROPOSITION, 0, 0, 0, 0};
-        DiscreteNode once{empty(holder), false, NodeType::EVENTUALLY, 0, 0, 0, 100};
-        DiscreteNode notNode{empty(holder), false, NodeType::NOT, 0, 1, 0, 0};
-        DiscreteNode since{empty(holder), false, NodeType::SINCE, 3, 0, 0, B_INFINITY};
-        DiscreteNode implies{empty(holder), false, NodeType::IMPLIES, 2, 4, 0, 0};
-        DiscreteNode always{empty(holder), false, NodeType::ALWAYS, 0, 5, 0, B_INFINITY};
-        std::vector<DiscreteNode> nodes{q, p, once, notNode, since, implies, always};
-
-        for (size_t i = 0; i < allInputs.size(); i++)
-        {
-            run_evaluation(nodes, holder, allInputs[i].time, {allInputs[i].q, allInputs[i].p});
-            swapBuffers(holder);
-        }
-        destroyHolder(holder);
+        std::cerr << "Error: Can't parse spec: " << e.what() << std::endl;
+        return 1;
     }
-    else if (strcmp(arguments.spec, "historically((once[:1000]{q}) -> ((not{p}) since {q}))") == 0)
+    if (use_discrete && spec_compiler::needsDenseTime(spec))
     {
-        IntervalSetHolder holder = newHolder(1000);
-        DiscreteNode q{empty(holder), false, NodeType::PROPOSITION, 0, 0, 0, 0};
-        DiscreteNode p{empty(holder), false, NodeType::PROPOSITION, 0, 0, 0, 0};
-        DiscreteNode once{empty(holder), false, NodeType::EVENTUALLY, 0, 0, 0, 1000};
-        DiscreteNode notNode{empty(holder), false, NodeType::NOT, 0, 1, 0, 0};
-        DiscreteNode since{empty(holder), false, NodeType::SINCE, 3, 0, 0, B_INFINITY};
-        DiscreteNode implies{empty(holder), false, NodeType::IMPLIES, 2, 4, 0, 0};
-        DiscreteNode always{empty(holder), false, NodeType::ALWAYS, 0, 5, 0, B_INFINITY};
-        std::vector<DiscreteNode> nodes{q, p, once, notNode, since, implies, always};
-
-        for (size_t i = 0; i < allInputs.size(); i++)
-        {
-            run_evaluation(nodes, holder, allInputs[i].time, {allInputs[i].q, allInputs[i].p});
-            swapBuffers(holder);
-        }
-        destroyHolder(holder);
+        std::cerr << "Error: Specs with future operators need --dense" << std::endl;
+        return 1;
     }
-    // AbsentBQR: historically({r} && !{q} && once{q}) -> ((not{p}) since[A:B] {q})
-    else if (strcmp(arguments.spec, "historically({r} && !{q} && once{q}) -> ((not{p}) since[3:10] {q})") == 0)
+    if (!use_discrete && spec_compiler::needsDiscreteTime(spec))
     {
-        IntervalSetHolder holder = newHolder(1000);
-        DiscreteNode q{empty(holder), false, NodeType::PROPOSITION, 0, 0, 0, 0};
-        DiscreteNode p{empty(holder), false, NodeType::PROPOSITION, 0, 0, 0, 0};
-        DiscreteNode r{empty(holder), false, NodeType::PROPOSITION, 0, 0, 0, 0};
-        DiscreteNode not_q{empty(holder), false, NodeType::NOT, 0, 0, 0, 0};
-        DiscreteNode once_q{empty(holder), false, NodeType::EVENTUALLY, 0, 0, 0, B_INFINITY};
-        DiscreteNode and1{empty(holder), false, NodeType::AND, 2, 3, 0, 0};
-        DiscreteNode and2{empty(holder), false, NodeType::AND, 5, 4, 0, 0};
-        DiscreteNode not_p{empty(holder), false, NodeType::NOT, 0, 1, 0, 0};
-        DiscreteNode since_node{empty(holder), false, NodeType::SINCE, 7, 0, 3, 10};
-        DiscreteNode implies_node{empty(holder), false, NodeType::IMPLIES, 6, 8, 0, 0};
-        DiscreteNode always_node{empty(holder), false, NodeType::ALWAYS, 0, 9, 0, B_INFINITY};
-        std::vector<DiscreteNode> nodes{q, p, r, not_q, once_q, and1, and2, not_p, since_node, implies_node, always_node};
-
-        for (size_t i = 0; i < allInputs.size(); i++)
-        {
-            run_evaluation(nodes, holder, allInputs[i].time, {allInputs[i].q, allInputs[i].p, allInputs[i].r});
-            swapBuffers(holder);
-        }
-        destroyHolder(holder);
+        std::cerr << "Error: Specs with pre, rise, fall or delay need --discrete" << std::endl;
+        return 1;
     }
-    else if (strcmp(arguments.spec, "historically({r} && !{q} && once{q}) -> ((not{p}) since[30:100] {q})") == 0)
-    {
-        IntervalSetHolder holder = newHolder(1000);
-        DiscreteNode q{empty(holder), false, NodeType::PROPOSITION, 0, 0, 0, 0};
-        DiscreteNode p{empty(holder), false, NodeType::PROPOSITION, 0, 0, 0, 0};
-        DiscreteNode r{empty(holder), false, NodeType::PROPOSITION, 0, 0, 0, 0};
-        DiscreteNode not_q{empty(holder), false, NodeType::NOT, 0, 0, 0, 0};
-        DiscreteNode once_q{empty(holder), false, NodeType::EVENTUALLY, 0, 0, 0, B_INFINITY};
-        DiscreteNode and1{empty(holder), false, NodeType::AND, 2, 3, 0, 0};
-        DiscreteNode and2{empty(holder), false, NodeType::AND, 5, 4, 0, 0};
-        DiscreteNode not_p{empty(holder), false, NodeType::NOT, 0, 1, 0, 0};
-        DiscreteNode since_node{empty(holder), false, NodeType::SINCE, 7, 0, 30, 100};
-        DiscreteNode implies_node{empty(holder), false, NodeType::IMPLIES, 6, 8, 0, 0};
-        DiscreteNode always_node{empty(holder), false, NodeType::ALWAYS, 0, 9, 0, B_INFINITY};
-        std::vector<DiscreteNode> nodes{q, p, r, not_q, once_q, and1, and2, not_p, since_node, implies_node, always_node};
 
-        for (size_t i = 0; i < allInputs.size(); i++)
-        {
-            run_evaluation(nodes, holder, allInputs[i].time, {allInputs[i].q, allInputs[i].p, allInputs[i].r});
-            swapBuffers(holder);
-        }
-        destroyHolder(holder);
-    }
-    else if (strcmp(arguments.spec, "historically({r} && !{q} && once{q}) -> ((not{p}) since[300:1000] {q})") == 0)
+    if (arguments.batch)
     {
-        IntervalSetHolder holder = newHolder(1000);
-        DiscreteNode q{empty(holder), false, NodeType::PROPOSITION, 0, 0, 0, 0};
-        DiscreteNode p{empty(holder), false, NodeType::PROPOSITION, 0, 0, 0, 0};
-        DiscreteNode r{empty(holder), false, NodeType::PROPOSITION, 0, 0, 0, 0};
-        DiscreteNode not_q{empty(holder), false, NodeType::NOT, 0, 0, 0, 0};
-        DiscreteNode once_q{empty(holder), false, NodeType::EVENTUALLY, 0, 0, 0, B_INFINITY};
-        DiscreteNode and1{empty(holder), false, NodeType::AND, 2, 3, 0, 0};
-        DiscreteNode and2{empty(holder), false, NodeType::AND, 5, 4, 0, 0};
-        DiscreteNode not_p{empty(holder), false, NodeType::NOT, 0, 1, 0, 0};
-        DiscreteNode since_node{empty(holder), false, NodeType::SINCE, 7, 0, 300, 1000};
-        DiscreteNode implies_node{empty(holder), false, NodeType::IMPLIES, 6, 8, 0, 0};
-        DiscreteNode always_node{empty(holder), false, NodeType::ALWAYS, 0, 9, 0, B_INFINITY};
-        std::vector<DiscreteNode> nodes{q, p, r, not_q, once_q, and1, and2, not_p, since_node, implies_node, always_node};
-
-        for (size_t i = 0; i < allInputs.size(); i++)
-        {
-            run_evaluation(nodes, holder, allInputs[i].time, {allInputs[i].q, allInputs[i].p, allInputs[i].r});
-            swapBuffers(holder);
-        }
-        destroyHolder(holder);
+        return batch_case(spec, arguments, use_discrete);
     }
-    // AbsentBR: historically({r} -> (historically[:N](not{p})))
-    else if (strcmp(arguments.spec, "historically({r} -> (historically[:10](not{p})))") == 0)
-    {
-        IntervalSetHolder holder = newHolder(1000);
-        DiscreteNode q{empty(holder), false, NodeType::PROPOSITION, 0, 0, 0, 0};
-        DiscreteNode p{empty(holder), false, NodeType::PROPOSITION, 0, 0, 0, 0};
-        DiscreteNode r{empty(holder), false, NodeType::PROPOSITION, 0, 0, 0, 0};
-        DiscreteNode not_p{empty(holder), false, NodeType::NOT, 0, 1, 0, 0};
-        DiscreteNode inner_always{empty(holder), false, NodeType::ALWAYS, 0, 3, 0, 10};
-        DiscreteNode implies_node{empty(holder), false, NodeType::IMPLIES, 2, 4, 0, 0};
-        DiscreteNode root_always{empty(holder), false, NodeType::ALWAYS, 0, 5, 0, B_INFINITY};
-        std::vector<DiscreteNode> nodes{q, p, r, not_p, inner_always, implies_node, root_always};
 
-        for (size_t i = 0; i < allInputs.size(); i++)
-        {
-            run_evaluation(nodes, holder, allInputs[i].time, {allInputs[i].q, allInputs[i].p, allInputs[i].r});
-            swapBuffers(holder);
-        }
-        destroyHolder(holder);
-    }
-    else if (strcmp(arguments.spec, "historically({r} -> (historically[:100](not{p})))") == 0)
-    {
-        IntervalSetHolder holder = newHolder(1000);
-        DiscreteNode q{empty(holder), false, NodeType::PROPOSITION, 0, 0, 0, 0};
-        DiscreteNode p{empty(holder), false, NodeType::PROPOSITION, 0, 0, 0, 0};
-        DiscreteNode r{empty(holder), false, NodeType::PROPOSITION, 0, 0, 0, 0};
-        DiscreteNode not_p{empty(holder), false, NodeType::NOT, 0, 1, 0, 0};
-        DiscreteNode inner_always{empty(holder), false, NodeType::ALWAYS, 0, 3, 0, 100};
-        DiscreteNode implies_node{empty(holder), false, NodeType::IMPLIES, 2, 4, 0, 0};
-        DiscreteNode root_always{empty(holder), false, NodeType::ALWAYS, 0, 5, 0, B_INFINITY};
-        std::vector<DiscreteNode> nodes{q, p, r, not_p, inner_always, implies_node, root_always};
-
-        for (size_t i = 0; i < allInputs.size(); i++)
-        {
-            run_evaluation(nodes, holder, allInputs[i].time, {allInputs[i].q, allInputs[i].p, allInputs[i].r});
-            swapBuffers(holder);
-        }
-        destroyHolder(holder);
-    }
-    else if (strcmp(arguments.spec, "historically({r} -> (historically[:1000](not{p})))") == 0)
+    bool from_stdin = arguments.file == nullptr || std::string(arguments.file) == "-";
+    int fd = from_stdin ? STDIN_FILENO : open(arguments.file, O_RDONLY);
+    if (fd < 0)
     {
-        IntervalSetHolder holder = newHolder(1000);
-        DiscreteNode q{empty(holder), false, NodeType::PROPOSITION, 0, 0, 0, 0};
-        DiscreteNode p{empty(holder), false, NodeType::PROPOSITION, 0, 0, 0, 0};
-        DiscreteNode r{empty(holder), false, NodeType::PROPOSITION, 0, 0, 0, 0};
-        DiscreteNode not_p{empty(holder), false, NodeType::NOT, 0, 1, 0, 0};
-        DiscreteNode inner_always{empty(holder), false, NodeType::ALWAYS, 0, 3, 0, 1000};
-        DiscreteNode implies_node{empty(holder), false, NodeType::IMPLIES, 2, 4, 0, 0};
-        DiscreteNode root_always{empty(holder), false, NodeType::ALWAYS, 0, 5, 0, B_INFINITY};
-        std::vector<DiscreteNode> nodes{q, p, r, not_p, inner_always, implies_node, root_always};
-
-        for (size_t i = 0; i < allInputs.size(); i++)
-        {
-            run_evaluation(nodes, holder, allInputs[i].time, {allInputs[i].q, allInputs[i].p, allInputs[i].r});
-            swapBuffers(holder);
-        }
-        destroyHolder(holder);
+        std::cerr << "Error opening file: " << arguments.file << std::endl;
+        return 1;
     }
-    // AlwaysAQ: historically((once[:N]{q}) -> ({p} since {q}))
-    else if (strcmp(arguments.spec, "historically((once[:10]{q}) -> ({p} since {q}))") == 0)
-    {
-        IntervalSetHolder holder = newHolder(1000);
-        DiscreteNode q{empty(holder), false, NodeType::PROPOSITION, 0, 0, 0, 0};
-        DiscreteNode p{empty(holder), false, NodeType::PROPOSITION, 0, 0, 0, 0};
-        DiscreteNode r{empty(holder), false, NodeType::PROPOSITION, 0, 0, 0, 0};
-        DiscreteNode once_q{empty(holder), false, NodeType::EVENTUALLY, 0, 0, 0, 10};
-        DiscreteNode since_node{empty(holder), false, NodeType::SINCE, 1, 0, 0, B_INFINITY};
-        DiscreteNode implies_node{empty(holder), false, NodeType::IMPLIES, 3, 4, 0, 0};
-        DiscreteNode root_always{empty(holder), false, NodeType::ALWAYS, 0, 5, 0, B_INFINITY};
-        std::vector<DiscreteNode> nodes{q, p, r, once_q, since_node, implies_node, root_always};
 
-        for (size_t i = 0; i < allInputs.size(); i++)
-        {
-            run_evaluation(nodes, holder, allInputs[i].time, {allInputs[i].q, allInputs[i].p, allInputs[i].r});
-            swapBuffers(holder);
+    struct stat info;
+    bool regular_file = fstat(fd, &info) == 0 && S_ISREG(info.st_mode);
+    std::string file_name = from_stdin ? "" : arguments.file;
+    bool use_jsonl = arguments.jsonl ||
+                     (file_name.size() >= 6 && file_name.compare(file_name.size() - 6, 6, ".jsonl") == 0);
+
+    binary_row_reader::MappedTrace mapped{{}, {nullptr, 0, 1}, nullptr, 0};
+    // Only the reader the input needs is built, and a mapped file needs none
+    std::optional<binary_row_reader::RowStream> stream;
+    std::optional<json_reader::JsonlStream> jsonl_stream;
+    RowSource nextBatch;
+    InputSlots slots;
+    try
+    {
+        if (use_jsonl)
+        {
+            // JSONL is parsed into packed rows with the spec's propositions
+            // in order, so the slots are just the row's bits.
+            jsonl_stream.emplace(
+                json_reader::openJsonlStream(fd, json_reader::newJsonlParser(spec.propositions), STREAM_BATCH_ROWS));
+            slots = binary_row_reader::bindPropositions(json_reader::jsonlHeader(jsonl_stream->parser), spec.propositions);
+            nextBatch = [&]() { return json_reader::readBatch(*jsonl_stream); };
+        }
+        else if (regular_file && !from_stdin)
+        {
+            // Evaluation walks the mapping directly, so it starts before the whole
+            // trace has been paged in and never keeps a second copy of it.
+            mapped = binary_row_reader::mapTraceFile(arguments.file);
+            slots = binary_row_reader::bindPropositions(mapped.header, spec.propositions);
+            bool handedOut = false;
+            nextBatch = [&, handedOut]() mutable -> RowBatch
+            {
+                if (handedOut) return RowBatch{nullptr, 0, 1};
+                handedOut = true;
+                return mapped.rows;
+            };
         }
-        destroyHolder(holder);
-    }
-    else if (strcmp(arguments.spec, "historically((once[:100]{q}) -> ({p} since {q}))") == 0)
-    {
-        IntervalSetHolder holder = newHolder(1000);
-        DiscreteNode q{empty(holder), false, NodeType::PROPOSITION, 0, 0, 0, 0};
-        DiscreteNode p{empty(holder), false, NodeType::PROPOSITION, 0, 0, 0, 0};
-        DiscreteNode r{empty(holder), false, NodeType::PROPOSITION, 0, 0, 0, 0};
-        DiscreteNode once_q{empty(holder), false, NodeType::EVENTUALLY, 0, 0, 0, 100};
-        DiscreteNode since_node{empty(holder), false, NodeType::SINCE, 1, 0, 0, B_INFINITY};
-        DiscreteNode implies_node{empty(holder), false, NodeType::IMPLIES, 3, 4, 0, 0};
-        DiscreteNode root_always{empty(holder), false, NodeType::ALWAYS, 0, 5, 0, B_INFINITY};
-        std::vector<DiscreteNode> nodes{q, p, r, once_q, since_node, implies_node, root_always};
-
-        for (size_t i = 0; i < allInputs.size(); i++)
+        else
         {
-            run_evaluation(nodes, holder, allInputs[i].time, {allInputs[i].q, allInputs[i].p, allInputs[i].r});
-            swapBuffers(holder);
+            // Pipes, FIFOs and stdin have no end to map, so rows are pulled in
+            // fixed-size batches as the producer writes them. The header has
+            // to arrive first so the spec can be bound to its propositions.
+            stream.emplace(binary_row_reader::openRowStream(fd, STREAM_BATCH_ROWS));
+            if (binary_row_reader::readStreamHeader(*stream))
+            {
+                slots = binary_row_reader::bindPropositions(stream->header, spec.propositions);
+            }
+            nextBatch = [&]() { return binary_row_reader::readBatch(*stream); };
         }
-        destroyHolder(holder);
     }
-    else if (strcmp(arguments.spec, "historically((once[:1000]{q}) -> ({p} since {q}))") == 0)
+    catch (const binary_row_reader::TraceFormatError &e)
     {
-        IntervalSetHolder holder = newHolder(1000);
-        DiscreteNode q{empty(holder), false, NodeType::PROPOSITION, 0, 0, 0, 0};
-        DiscreteNode p{empty(holder), false, NodeType::PROPOSITION, 0, 0, 0, 0};
-        DiscreteNode r{empty(holder), false, NodeType::PROPOSITION, 0, 0, 0, 0};
-        DiscreteNode once_q{empty(holder), false, NodeType::EVENTUALLY, 0, 0, 0, 1000};
-        DiscreteNode since_node{empty(holder), false, NodeType::SINCE, 1, 0, 0, B_INFINITY};
-        DiscreteNode implies_node{empty(holder), false, NodeType::IMPLIES, 3, 4, 0, 0};
-        DiscreteNode root_always{empty(holder), false, NodeType::ALWAYS, 0, 5, 0, B_INFINITY};
-        std::vector<DiscreteNode> nodes{q, p, r, once_q, since_node, implies_node, root_always};
-
-        for (size_t i = 0; i < allInputs.size(); i++)
-        {
-            run_evaluation(nodes, holder, allInputs[i].time, {allInputs[i].q, allInputs[i].p, allInputs[i].r});
-            swapBuffers(holder);
-        }
-        destroyHolder(holder);
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
     }
-    // AlwaysBQR: historically(({r} && !{q} && once{q}) -> ({p} since[A:B] {q}))
-    else if (strcmp(arguments.spec, "historically(({r} && !{q} && once{q}) -> ({p} since[3:10] {q}))") == 0)
-    {
-        IntervalSetHolder holder = newHolder(1000);
-        DiscreteNode q{empty(holder), false, NodeType::PROPOSITION, 0, 0, 0, 0};
-        DiscreteNode p{empty(holder), false, NodeType::PROPOSITION, 0, 0, 0, 0};
-        DiscreteNode r{empty(holder), false, NodeType::PROPOSITION, 0, 0, 0, 0};
-        DiscreteNode not_q{empty(holder), false, NodeType::NOT, 0, 0, 0, 0};
-        DiscreteNode once_q{empty(holder), false, NodeType::EVENTUALLY, 0, 0, 0, B_INFINITY};
-        DiscreteNode and1{empty(holder), false, NodeType::AND, 2, 3, 0, 0};
-        DiscreteNode and2{empty(holder), false, NodeType::AND, 5, 4, 0, 0};
-        DiscreteNode not_p{empty(holder), false, NodeType::NOT, 0, 1, 0, 0};
-        DiscreteNode since_node{empty(holder), false, NodeType::SINCE, 1, 0, 3, 10};
-        DiscreteNode implies_node{empty(holder), false, NodeType::IMPLIES, 6, 8, 0, 0};
-        DiscreteNode always_node{empty(holder), false, NodeType::ALWAYS, 0, 9, 0, B_INFINITY};
-        std::vector<DiscreteNode> nodes{q, p, r, not_q, once_q, and1, and2, not_p, since_node, implies_node, always_node};
 
-        for (size_t i = 0; i < allInputs.size(); i++)
-        {
-            run_evaluation(nodes, holder, allInputs[i].time, {allInputs[i].q, allInputs[i].p, allInputs[i].r});
-            swapBuffers(holder);
-        }
-        destroyHolder(holder);
-    }
-    else if (strcmp(arguments.spec, "historically(({r} && !{q} && once{q}) -> ({p} since[30:100] {q}))") == 0)
+    monitor::Checkpointing checkpointing{arguments.checkpoint_every,
+                                         arguments.checkpoint != nullptr ? arguments.checkpoint
+                                         : from_stdin                    ? "do-verify.ckpt"
+                                                                         : file_name + ".ckpt",
+                                         nullptr};
+    checkpoint::Snapshot snapshot;
+    if (arguments.resume)
     {
-        IntervalSetHolder holder = newHolder(1000);
-        DiscreteNode q{empty(holder), false, NodeType::PROPOSITION, 0, 0, 0, 0};
-        DiscreteNode p{empty(holder), false, NodeType::PROPOSITION, 0, 0, 0, 0};
-        DiscreteNode r{empty(holder), false, NodeType::PROPOSITION, 0, 0, 0, 0};
-        DiscreteNode not_q{empty(holder), false, NodeType::NOT, 0, 0, 0, 0};
-        DiscreteNode once_q{empty(holder), false, NodeType::EVENTUALLY, 0, 0, 0, B_INFINITY};
-        DiscreteNode and1{empty(holder), false, NodeType::AND, 2, 3, 0, 0};
-        DiscreteNode and2{empty(holder), false, NodeType::AND, 5, 4, 0, 0};
-        DiscreteNode not_p{empty(holder), false, NodeType::NOT, 0, 1, 0, 0};
-        DiscreteNode since_node{empty(holder), false, NodeType::SINCE, 1, 0, 30, 100};
-        DiscreteNode implies_node{empty(holder), false, NodeType::IMPLIES, 6, 8, 0, 0};
-        DiscreteNode always_node{empty(holder), false, NodeType::ALWAYS, 0, 9, 0, B_INFINITY};
-        std::vector<DiscreteNode> nodes{q, p, r, not_q, once_q, and1, and2, not_p, since_node, implies_node, always_node};
-
-        for (size_t i = 0; i < allInputs.size(); i++)
+        try
         {
-            run_evaluation(nodes, holder, allInputs[i].time, {allInputs[i].q, allInputs[i].p, allInputs[i].r});
-            swapBuffers(holder);
+            snapshot = checkpoint::loadSnapshot(checkpointing.path);
         }
-        destroyHolder(holder);
-    }
-    else if (strcmp(arguments.spec, "historically(({r} && !{q} && once{q}) -> ({p} since[300:1000] {q}))") == 0)
-    {
-        IntervalSetHolder holder = newHolder(1000);
-        DiscreteNode q{empty(holder), false, NodeType::PROPOSITION, 0, 0, 0, 0};
-        DiscreteNode p{empty(holder), false, NodeType::PROPOSITION, 0, 0, 0, 0};
-        DiscreteNode r{empty(holder), false, NodeType::PROPOSITION, 0, 0, 0, 0};
-        DiscreteNode not_q{empty(holder), false, NodeType::NOT, 0, 0, 0, 0};
-        DiscreteNode once_q{empty(holder), false, NodeType::EVENTUALLY, 0, 0, 0, B_INFINITY};
-        DiscreteNode and1{empty(holder), false, NodeType::AND, 2, 3, 0, 0};
-        DiscreteNode and2{empty(holder), false, NodeType::AND, 5, 4, 0, 0};
-        DiscreteNode not_p{empty(holder), false, NodeType::NOT, 0, 1, 0, 0};
-        DiscreteNode since_node{empty(holder), false, NodeType::SINCE, 1, 0, 300, 1000};
-        DiscreteNode implies_node{empty(holder), false, NodeType::IMPLIES, 6, 8, 0, 0};
-        DiscreteNode always_node{empty(holder), false, NodeType::ALWAYS, 0, 9, 0, B_INFINITY};
-        std::vector<DiscreteNode> nodes{q, p, r, not_q, once_q, and1, and2, not_p, since_node, implies_node, always_node};
-
-        for (size_t i = 0; i < allInputs.size(); i++)
+        catch (const checkpoint::CheckpointError &e)
         {
-            run_evaluation(nodes, holder, allInputs[i].time, {allInputs[i].q, allInputs[i].p, allInputs[i].r});
-            swapBuffers(holder);
+            std::cerr << "Error: " << e.what() << std::endl;
+            return 1;
         }
-        destroyHolder(holder);
+        checkpointing.resume = &snapshot;
     }
-    // AlwaysBR: historically({r} -> (historically[:N]{p}))
-    else if (strcmp(arguments.spec, "historically({r} -> (historically[:10]{p}))") == 0)
-    {
-        IntervalSetHolder holder = newHolder(1000);
-        DiscreteNode q{empty(holder), false, NodeType::PROPOSITION, 0, 0, 0, 0};
-        DiscreteNode p{empty(holder), false, NodeType::PROPOSITION, 0, 0, 0, 0};
-        DiscreteNode r{empty(holder), false, NodeType::PROPOSITION, 0, 0, 0, 0};
-        DiscreteNode inner_always{empty(holder), false, NodeType::ALWAYS, 0, 1, 0, 10};
-        DiscreteNode implies_node{empty(holder), false, NodeType::IMPLIES, 2, 3, 0, 0};
-        DiscreteNode root_always{empty(holder), false, NodeType::ALWAYS, 0, 4, 0, B_INFINITY};
-        std::vector<DiscreteNode> nodes{q, p, r, inner_always, implies_node, root_always};
 
-        for (size_t i = 0; i < allInputs.size(); i++)
-        {
-            run_evaluation(nodes, holder, allInputs[i].time, {allInputs[i].q, allInputs[i].p, allInputs[i].r});
-            swapBuffers(holder);
-        }
-        destroyHolder(holder);
-    }
-    else if (strcmp(arguments.spec, "historically({r} -> (historically[:100]{p}))") == 0)
+    // A resumed monitor keeps the verdicts written up to its checkpoint and
+    // drops whatever the interrupted run wrote after it.
+    bool to_stdout = arguments.output == nullptr || std::string(arguments.output) == "-";
+    bool keep_output = arguments.resume && snapshot.outputOffset >= 0;
+    int output_fd = to_stdout ? STDOUT_FILENO : open(arguments.output, O_WRONLY | O_CREAT | (keep_output ? 0 : O_TRUNC), 0644);
+    if (output_fd < 0)
     {
-        IntervalSetHolder holder = newHolder(1000);
-        DiscreteNode q{empty(holder), false, NodeType::PROPOSITION, 0, 0, 0, 0};
-        DiscreteNode p{empty(holder), false, NodeType::PROPOSITION, 0, 0, 0, 0};
-        DiscreteNode r{empty(holder), false, NodeType::PROPOSITION, 0, 0, 0, 0};
-        DiscreteNode inner_always{empty(holder), false, NodeType::ALWAYS, 0, 1, 0, 100};
-        DiscreteNode implies_node{empty(holder), false, NodeType::IMPLIES, 2, 3, 0, 0};
-        DiscreteNode root_always{empty(holder), false, NodeType::ALWAYS, 0, 4, 0, B_INFINITY};
-        std::vector<DiscreteNode> nodes{q, p, r, inner_always, implies_node, root_always};
-
-        for (size_t i = 0; i < allInputs.size(); i++)
-        {
-            run_evaluation(nodes, holder, allInputs[i].time, {allInputs[i].q, allInputs[i].p, allInputs[i].r});
-            swapBuffers(holder);
-        }
-        destroyHolder(holder);
+        std::cerr << "Error opening output file: " << arguments.output << std::endl;
+        return 1;
     }
-    else if (strcmp(arguments.spec, "historically({r} -> (historically[:1000]{p}))") == 0)
+    struct stat output_info;
+    if (!to_stdout && keep_output && fstat(output_fd, &output_info) == 0 && S_ISREG(output_info.st_mode) &&
+        (ftruncate(output_fd, snapshot.outputOffset) != 0 || lseek(output_fd, snapshot.outputOffset, SEEK_SET) < 0))
     {
-        IntervalSetHolder holder = newHolder(1000);
-        DiscreteNode q{empty(holder), false, NodeType::PROPOSITION, 0, 0, 0, 0};
-        DiscreteNode p{empty(holder), false, NodeType::PROPOSITION, 0, 0, 0, 0};
-        DiscreteNode r{empty(holder), false, NodeType::PROPOSITION, 0, 0, 0, 0};
-        DiscreteNode inner_always{empty(holder), false, NodeType::ALWAYS, 0, 1, 0, 1000};
-        DiscreteNode implies_node{empty(holder), false, NodeType::IMPLIES, 2, 3, 0, 0};
-        DiscreteNode root_always{empty(holder), false, NodeType::ALWAYS, 0, 4, 0, B_INFINITY};
-        std::vector<DiscreteNode> nodes{q, p, r, inner_always, implies_node, root_always};
-
-        for (size_t i = 0; i < allInputs.size(); i++)
-        {
-            run_evaluation(nodes, holder, allInputs[i].time, {allInputs[i].q, allInputs[i].p, allInputs[i].r});
-            swapBuffers(holder);
-        }
-        destroyHolder(holder);
+        std::cerr << "Error rewinding output file: " << arguments.output << std::endl;
+        return 1;
     }
-    // RecurBQR: historically(({r} && !{q} && once{q}) -> ((once[:N]({p} or {q})) since {q}))
-    else if (strcmp(arguments.spec, "historically(({r} && !{q} && once{q}) -> ((once[:10]({p} or {q})) since {q}))") == 0)
-    {
-        IntervalSetHolder holder = newHolder(1000);
-        DiscreteNode q{empty(holder), false, NodeType::PROPOSITION, 0, 0, 0, 0};
-        DiscreteNode p{empty(holder), false, NodeType::PROPOSITION, 0, 0, 0, 0};
-        DiscreteNode r{empty(holder), false, NodeType::PROPOSITION, 0, 0, 0, 0};
-        DiscreteNode not_q{empty(holder), false, NodeType::NOT, 0, 0, 0, 0};
-        DiscreteNode once_q{empty(holder), false, NodeType::EVENTUALLY, 0, 0, 0, B_INFINITY};
-        DiscreteNode and1{empty(holder), false, NodeType::AND, 2, 3, 0, 0};
-        DiscreteNode and2{empty(holder), false, NodeType::AND, 5, 4, 0, 0};
-        DiscreteNode p_or_q{empty(holder), false, NodeType::OR, 1, 0, 0, 0};
-        DiscreteNode once_p_or_q{empty(holder), false, NodeType::EVENTUALLY, 0, 7, 0, 10};
-        DiscreteNode since_node{empty(holder), false, NodeType::SINCE, 8, 0, 0, B_INFINITY};
-        DiscreteNode implies_node{empty(holder), false, NodeType::IMPLIES, 6, 9, 0, 0};
-        DiscreteNode root_always{empty(holder), false, NodeType::ALWAYS, 0, 10, 0, B_INFINITY};
-        std::vector<DiscreteNode> nodes{q, p, r, not_q, once_q, and1, and2, p_or_q, once_p_or_q, since_node, implies_node, root_always};
+    verdict_writer::VerdictFormat format =
+        arguments.binary_output ? verdict_writer::VerdictFormat::BINARY : verdict_writer::VerdictFormat::TEXT;
+    verdict_writer::VerdictMode mode =
+        use_discrete ? verdict_writer::VerdictMode::DISCRETE : verdict_writer::VerdictMode::DENSE;
+    verdict_writer::VerdictWriter verdicts =
+        keep_output ? verdict_writer::continueVerdictWriter(output_fd, format, mode, VERDICT_BUFFER_BYTES)
+                         : verdict_writer::newVerdictWriter(output_fd, format, mode, VERDICT_BUFFER_BYTES);
+    const monitor::Checkpointing *checkpoints =
+        arguments.checkpoint_every > 0 || arguments.resume ? &checkpointing : nullptr;
 
-        for (size_t i = 0; i < allInputs.size(); i++)
-        {
-            run_evaluation(nodes, holder, allInputs[i].time, {allInputs[i].q, allInputs[i].p, allInputs[i].r});
-            swapBuffers(holder);
-        }
-        destroyHolder(holder);
-    }
-    else if (strcmp(arguments.spec, "historically(({r} && !{q} && once{q}) -> ((once[:100]({p} or {q})) since {q}))") == 0)
+    IntervalSetHolder holder = newHolder(spec_compiler::holderSizeHint(spec));
+    try
     {
-        IntervalSetHolder holder = newHolder(1000);
-        DiscreteNode q{empty(holder), false, NodeType::PROPOSITION, 0, 0, 0, 0};
-        DiscreteNode p{empty(holder), false, NodeType::PROPOSITION, 0, 0, 0, 0};
-        DiscreteNode r{empty(holder), false, NodeType::PROPOSITION, 0, 0, 0, 0};
-        DiscreteNode not_q{empty(holder), false, NodeType::NOT, 0, 0, 0, 0};
-        DiscreteNode once_q{empty(holder), false, NodeType::EVENTUALLY, 0, 0, 0, B_INFINITY};
-        DiscreteNode and1{empty(holder), false, NodeType::AND, 2, 3, 0, 0};
-        DiscreteNode and2{empty(holder), false, NodeType::AND, 5, 4, 0, 0};
-        DiscreteNode p_or_q{empty(holder), false, NodeType::OR, 1, 0, 0, 0};
-        DiscreteNode once_p_or_q{empty(holder), false, NodeType::EVENTUALLY, 0, 7, 0, 100};
-        DiscreteNode since_node{empty(holder), false, NodeType::SINCE, 8, 0, 0, B_INFINITY};
-        DiscreteNode implies_node{empty(holder), false, NodeType::IMPLIES, 6, 9, 0, 0};
-        DiscreteNode root_always{empty(holder), false, NodeType::ALWAYS, 0, 10, 0, B_INFINITY};
-        std::vector<DiscreteNode> nodes{q, p, r, not_q, once_q, and1, and2, p_or_q, once_p_or_q, since_node, implies_node, root_always};
-
-        for (size_t i = 0; i < allInputs.size(); i++)
+        if (use_discrete)
         {
-            run_evaluation(nodes, holder, allInputs[i].time, {allInputs[i].q, allInputs[i].p, allInputs[i].r});
-            swapBuffers(holder);
+            monitor::runDiscrete(spec, slots, nextBatch, holder, &verdicts, checkpoints);
         }
-        destroyHolder(holder);
-    }
-    else if (strcmp(arguments.spec, "historically(({r} && !{q} && once{q}) -> ((once[:1000]({p} or {q})) since {q}))") == 0)
-    {
-        IntervalSetHolder holder = newHolder(1000);
-        DiscreteNode q{empty(holder), false, NodeType::PROPOSITION, 0, 0, 0, 0};
-        DiscreteNode p{empty(holder), false, NodeType::PROPOSITION, 0, 0, 0, 0};
-        DiscreteNode r{empty(holder), false, NodeType::PROPOSITION, 0, 0, 0, 0};
-        DiscreteNode not_q{empty(holder), false, NodeType::NOT, 0, 0, 0, 0};
-        DiscreteNode once_q{empty(holder), false, NodeType::EVENTUALLY, 0, 0, 0, B_INFINITY};
-        DiscreteNode and1{empty(holder), false, NodeType::AND, 2, 3, 0, 0};
-        DiscreteNode and2{empty(holder), false, NodeType::AND, 5, 4, 0, 0};
-        DiscreteNode p_or_q{empty(holder), false, NodeType::OR, 1, 0, 0, 0};
-        DiscreteNode once_p_or_q{empty(holder), false, NodeType::EVENTUALLY, 0, 7, 0, 1000};
-        DiscreteNode since_node{empty(holder), false, NodeType::SINCE, 8, 0, 0, B_INFINITY};
-        DiscreteNode implies_node{empty(holder), false, NodeType::IMPLIES, 6, 9, 0, 0};
-        DiscreteNode root_always{empty(holder), false, NodeType::ALWAYS, 0, 10, 0, B_INFINITY};
-        std::vector<DiscreteNode> nodes{q, p, r, not_q, once_q, and1, and2, p_or_q, once_p_or_q, since_node, implies_node, root_always};
-
-        for (size_t i = 0; i < allInputs.size(); i++)
+        else
         {
-            run_evaluation(nodes, holder, allInputs[i].time, {allInputs[i].q, allInputs[i].p, allInputs[i].r});
-            swapBuffers(holder);
+            monitor::runDense(spec, slots, nextBatch, holder, &verdicts, checkpoints);
         }
-        destroyHolder(holder);
     }
-    // RecurGLB: historically(once[:N]{p})
-    else if (strcmp(arguments.spec, "historically(once[:10]{p})") == 0)
+    catch (const json_reader::JsonlParseError &e)
     {
-        IntervalSetHolder holder = newHolder(1000);
-        DiscreteNode p{empty(holder), false, NodeType::PROPOSITION, 0, 0, 0, 0};
-        DiscreteNode once{empty(holder), false, NodeType::EVENTUALLY, 0, 0, 0, 10};
-        DiscreteNode always{empty(holder), false, NodeType::ALWAYS, 0, 1, 0, B_INFINITY};
-        std::vector<DiscreteNode> nodes{p, once, always};
-
-        for (size_t i = 0; i < allInputs.size(); i++)
-        {
-            run_evaluation(nodes, holder, allInputs[i].time, {allInputs[i].p});
-            swapBuffers(holder);
-        }
-        destroyHolder(holder);
+        std::cerr << "Error: Can't parse JSONL trace: " << e.what() << std::endl;
+        return 1;
     }
-    else if (strcmp(arguments.spec, "historically(once[:100]{p})") == 0)
+    catch (const binary_row_reader::TraceFormatError &e)
     {
-        IntervalSetHolder holder = newHolder(1000);
-        DiscreteNode p{empty(holder), false, NodeType::PROPOSITION, 0, 0, 0, 0};
-        DiscreteNode once{empty(holder), false, NodeType::EVENTUALLY, 0, 0, 0, 100};
-        DiscreteNode always{empty(holder), false, NodeType::ALWAYS, 0, 1, 0, B_INFINITY};
-        std::vector<DiscreteNode> nodes{p, once, always};
-
-        for (size_t i = 0; i < allInputs.size(); i++)
-        {
-            run_evaluation(nodes, holder, allInputs[i].time, {allInputs[i].p});
-            swapBuffers(holder);
-        }
-        destroyHolder(holder);
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
     }
-    else if (strcmp(arguments.spec, "historically(once[:1000]{p})") == 0)
+    catch (const checkpoint::CheckpointError &e)
     {
-        IntervalSetHolder holder = newHolder(1000);
-        DiscreteNode p{empty(holder), false, NodeType::PROPOSITION, 0, 0, 0, 0};
-        DiscreteNode once{empty(holder), false, NodeType::EVENTUALLY, 0, 0, 0, 1000};
-        DiscreteNode always{empty(holder), false, NodeType::ALWAYS, 0, 1, 0, B_INFINITY};
-        std::vector<DiscreteNode> nodes{p, once, always};
-
-        for (size_t i = 0; i < allInputs.size(); i++)
-        {
-            run_evaluation(nodes, holder, allInputs[i].time, {allInputs[i].p});
-            swapBuffers(holder);
-        }
-        destroyHolder(holder);
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
     }
-    // RespondBQR: historically(({r} && !{q} && once{q}) -> ( (({s} -> once[A:B]{p}) and not((not {s}) since[B:] {p})) since {q}))
-    else if (strcmp(arguments.spec, "historically(({r} && !{q} && once{q}) -> ( (({s} -> once[3:10]{p}) and not((not {s}) since[10:] {p})) since {q}))") == 0)
+    if (jsonl_stream)
     {
-        IntervalSetHolder holder = newHolder(1000);
-        DiscreteNode q{empty(holder), false, NodeType::PROPOSITION, 0, 0, 0, 0};
-        DiscreteNode p{empty(holder), false, NodeType::PROPOSITION, 0, 0, 0, 0};
-        DiscreteNode s{empty(holder), false, NodeType::PROPOSITION, 0, 0, 0, 0};
-        DiscreteNode r{empty(holder), false, NodeType::PROPOSITION, 0, 0, 0, 0};
-        DiscreteNode not_q{empty(holder), false, NodeType::NOT, 0, 0, 0, 0};
-        DiscreteNode once_q{empty(holder), false, NodeType::EVENTUALLY, 0, 0, 0, B_INFINITY};
-        DiscreteNode and_A1{empty(holder), false, NodeType::AND, 3, 4, 0, 0};
-        DiscreteNode and_A2{empty(holder), false, NodeType::AND, 6, 5, 0, 0};
-        DiscreteNode once_p{empty(holder), false, NodeType::EVENTUALLY, 0, 1, 3, 10};
-        DiscreteNode implies_D{empty(holder), false, NodeType::IMPLIES, 2, 8, 0, 0};
-        DiscreteNode not_s{empty(holder), false, NodeType::NOT, 0, 2, 0, 0};
-        DiscreteNode since_F{empty(holder), false, NodeType::SINCE, 10, 1, 10, B_INFINITY};
-        DiscreteNode not_F{empty(holder), false, NodeType::NOT, 0, 11, 0, 0};
-        DiscreteNode and_C{empty(holder), false, NodeType::AND, 9, 12, 0, 0};
-        DiscreteNode since_B{empty(holder), false, NodeType::SINCE, 13, 0, 0, B_INFINITY};
-        DiscreteNode implies_main{empty(holder), false, NodeType::IMPLIES, 7, 14, 0, 0};
-        DiscreteNode root_always{empty(holder), false, NodeType::ALWAYS, 0, 15, 0, B_INFINITY};
-        std::vector<DiscreteNode> nodes{q, p, s, r, not_q, once_q, and_A1, and_A2, once_p, implies_D, not_s, since_F, not_F, and_C, since_B, implies_main, root_always};
-
-        for (size_t i = 0; i < allInputs.size(); i++)
+        // A spec proposition no line has reads as false throughout, which is
+        // far more often a misspelled name than an intended constant.
+        for (const std::string &name : json_reader::missingPropositions(jsonl_stream->parser))
         {
-            run_evaluation(nodes, holder, allInputs[i].time, {allInputs[i].q, allInputs[i].p, allInputs[i].s, allInputs[i].r});
-            swapBuffers(holder);
+            std::cerr << "Warning: Proposition '" << name << "' never appears in the trace, so it is always false"
+                      << std::endl;
         }
-        destroyHolder(holder);
     }
-    else if (strcmp(arguments.spec, "historically(({r} && !{q} && once{q}) -> ( (({s} -> once[30:100]{p}) and not((not {s}) since[100:] {p})) since {q}))") == 0)
+    if (arguments.stats)
     {
-        IntervalSetHolder holder = newHolder(1000);
-        DiscreteNode q{empty(holder), false, NodeType::PROPOSITION, 0, 0, 0, 0};
-        DiscreteNode p{empty(holder), false, NodeType::PROPOSITION, 0, 0, 0, 0};
-        DiscreteNode s{empty(holder), false, NodeType::PROPOSITION, 0, 0, 0, 0};
-        DiscreteNode r{empty(holder), false, NodeType::PROPOSITION, 0, 0, 0, 0};
-        DiscreteNode not_q{empty(holder), false, NodeType::NOT, 0, 0, 0, 0};
-        DiscreteNode once_q{empty(holder), false, NodeType::EVENTUALLY, 0, 0, 0, B_INFINITY};
-        DiscreteNode and_A1{empty(holder), false, NodeType::AND, 3, 4, 0, 0};
-        DiscreteNode and_A2{empty(holder), false, NodeType::AND, 6, 5, 0, 0};
-        DiscreteNode once_p{empty(holder), false, NodeType::EVENTUALLY, 0, 1, 30, 100};
-        DiscreteNode implies_D{empty(holder), false, NodeType::IMPLIES, 2, 8, 0, 0};
-        DiscreteNode not_s{empty(holder), false, NodeType::NOT, 0, 2, 0, 0};
-        DiscreteNode since_F{empty(holder), false, NodeType::SINCE, 10, 1, 100, B_INFINITY};
-        DiscreteNode not_F{empty(holder), false, NodeType::NOT, 0, 11, 0, 0};
-        DiscreteNode and_C{empty(holder), false, NodeType::AND, 9, 12, 0, 0};
-        DiscreteNode since_B{empty(holder), false, NodeType::SINCE, 13, 0, 0, B_INFINITY};
-        DiscreteNode implies_main{empty(holder), false, NodeType::IMPLIES, 7, 14, 0, 0};
-        DiscreteNode root_always{empty(holder), false, NodeType::ALWAYS, 0, 15, 0, B_INFINITY};
-        std::vector<DiscreteNode> nodes{q, p, s, r, not_q, once_q, and_A1, and_A2, once_p, implies_D, not_s, since_F, not_F, and_C, since_B, implies_main, root_always};
-
-        for (size_t i = 0; i < allInputs.size(); i++)
-        {
-            run_evaluation(nodes, holder, allInputs[i].time, {allInputs[i].q, allInputs[i].p, allInputs[i].s, allInputs[i].r});
-            swapBuffers(holder);
-        }
-        destroyHolder(holder);
+        printStats(holder);
     }
-    else if (strcmp(arguments.spec, "historically(({r} && !{q} && once{q}) -> ( (({s} -> once[300:1000]{p}) and not((not {s}) since[1000:] {p})) since {q}))") == 0)
-    {
-        IntervalSetHolder holder = newHolder(1000);
-        DiscreteNode q{empty(holder), false, NodeType::PROPOSITION, 0, 0, 0, 0};
-        DiscreteNode p{empty(holder), false, NodeType::PROPOSITION, 0, 0, 0, 0};
-        DiscreteNode s{empty(holder), false, NodeType::PROPOSITION, 0, 0, 0, 0};
-        DiscreteNode r{empty(holder), false, NodeType::PROPOSITION, 0, 0, 0, 0};
-        DiscreteNode not_q{empty(holder), false, NodeType::NOT, 0, 0, 0, 0};
-        DiscreteNode once_q{empty(holder), false, NodeType::EVENTUALLY, 0, 0, 0, B_INFINITY};
-        DiscreteNode and_A1{empty(holder), false, NodeType::AND, 3, 4, 0, 0};
-        DiscreteNode and_A2{empty(holder), false, NodeType::AND, 6, 5, 0, 0};
-        DiscreteNode once_p{empty(holder), false, NodeType::EVENTUALLY, 0, 1, 300, 1000};
-        DiscreteNode implies_D{empty(holder), false, NodeType::IMPLIES, 2, 8, 0, 0};
-        DiscreteNode not_s{empty(holder), false, NodeType::NOT, 0, 2, 0, 0};
-        DiscreteNode since_F{empty(holder), false, NodeType::SINCE, 10, 1, 1000, B_INFINITY};
-        DiscreteNode not_F{empty(holder), false, NodeType::NOT, 0, 11, 0, 0};
-        DiscreteNode and_C{empty(holder), false, NodeType::AND, 9, 12, 0, 0};
-        DiscreteNode since_B{empty(holder), false, NodeType::SINCE, 13, 0, 0, B_INFINITY};
-        DiscreteNode implies_main{empty(holder), false, NodeType::IMPLIES, 7, 14, 0, 0};
-        DiscreteNode root_always{empty(holder), false, NodeType::ALWAYS, 0, 15, 0, B_INFINITY};
-        std::vector<DiscreteNode> nodes{q, p, s, r, not_q, once_q, and_A1, and_A2, once_p, implies_D, not_s, since_F, not_F, and_C, since_B, implies_main, root_always};
+    destroyHolder(holder);
 
-        for (size_t i = 0; i < allInputs.size(); i++)
-        {
-            run_evaluation(nodes, holder, allInputs[i].time, {allInputs[i].q, allInputs[i].p, allInputs[i].s, allInputs[i].r});
-            swapBuffers(holder);
-        }
-        destroyHolder(holder);
-    }
-    // RespondGLB: historically(({s} -> once[A:B]{p}) and not((not {s}) since[B:] {p}))
-    else if (strcmp(arguments.spec, "historically(({s} -> once[3:10]{p}) and not((not {s}) since[10:] {p}))") == 0)
+    verdict_writer::finishVerdicts(verdicts);
+    if (!to_stdout)
     {
-        IntervalSetHolder holder = newHolder(1000);
-        DiscreteNode p{empty(holder), false, NodeType::PROPOSITION, 0, 0, 0, 0};
-        DiscreteNode s{empty(holder), false, NodeType::PROPOSITION, 0, 0, 0, 0};
-        DiscreteNode once_p{empty(holder), false, NodeType::EVENTUALLY, 0, 0, 3, 10};
-        DiscreteNode implies_D{empty(holder), false, NodeType::IMPLIES, 1, 2, 0, 0};
-        DiscreteNode not_s{empty(holder), false, NodeType::NOT, 0, 1, 0, 0};
-        DiscreteNode since_F{empty(holder), false, NodeType::SINCE, 4, 0, 10, B_INFINITY};
-        DiscreteNode not_F{empty(holder), false, NodeType::NOT, 0, 5, 0, 0};
-        DiscreteNode and_C{empty(holder), false, NodeType::AND, 3, 6, 0, 0};
-        DiscreteNode root_always{empty(holder), false, NodeType::ALWAYS, 0, 7, 0, B_INFINITY};
-        std::vector<DiscreteNode> nodes{p, s, once_p, implies_D, not_s, since_F, not_F, and_C, root_always};
-
-        for (size_t i = 0; i < allInputs.size(); i++)
-        {
-            run_evaluation(nodes, holder, allInputs[i].time, {allInputs[i].p, allInputs[i].s});
-            swapBuffers(holder);
-        }
-        destroyHolder(holder);
+        close(output_fd);
     }
-    else if (strcmp(arguments.spec, "historically(({s} -> once[30:100]{p}) and not((not {s}) since[100:] {p}))") == 0)
+    binary_row_reader::unmapTraceFile(mapped);
+    if (!from_stdin)
     {
-        IntervalSetHolder holder = newHolder(1000);
-        DiscreteNode p{empty(holder), false, NodeType::PROPOSITION, 0, 0, 0, 0};
-        DiscreteNode s{empty(holder), false, NodeType::PROPOSITION, 0, 0, 0, 0};
-        DiscreteNode once_p{empty(holder), false, NodeType::EVENTUALLY, 0, 0, 30, 100};
-        DiscreteNode implies_D{empty(holder), false, NodeType::IMPLIES, 1, 2, 0, 0};
-        DiscreteNode not_s{empty(holder), false, NodeType::NOT, 0, 1, 0, 0};
-        DiscreteNode since_F{empty(holder), false, NodeType::SINCE, 4, 0, 100, B_INFINITY};
-        DiscreteNode not_F{empty(holder), false, NodeType::NOT, 0, 5, 0, 0};
-        DiscreteNode and_C{empty(holder), false, NodeType::AND, 3, 6, 0, 0};
-        DiscreteNode root_always{empty(holder), false, NodeType::ALWAYS, 0, 7, 0, B_INFINITY};
-        std::vector<DiscreteNode> nodes{p, s, once_p, implies_D, not_s, since_F, not_F, and_C, root_always};
-
-        for (size_t i = 0; i < allInputs.size(); i++)
-        {
-            run_evaluation(nodes, holder, allInputs[i].time, {allInputs[i].p, allInputs[i].s});
-            swapBuffers(holder);
-        }
-        destroyHolder(holder);
+        close(fd);
     }
-    else if (strcmp(arguments.spec, "historically(({s} -> once[300:1000]{p}) and not((not {s}) since[1000:] {p}))") == 0)
+    if (verdicts.failed)
     {
-        IntervalSetHolder holder = newHolder(1000);
-        DiscreteNode p{empty(holder), false, NodeType::PROPOSITION, 0, 0, 0, 0};
-        DiscreteNode s{empty(holder), false, NodeType::PROPOSITION, 0, 0, 0, 0};
-        DiscreteNode once_p{empty(holder), false, NodeType::EVENTUALLY, 0, 0, 300, 1000};
-        DiscreteNode implies_D{empty(holder), false, NodeType::IMPLIES, 1, 2, 0, 0};
-        DiscreteNode not_s{empty(holder), false, NodeType::NOT, 0, 1, 0, 0};
-        DiscreteNode since_F{empty(holder), false, NodeType::SINCE, 4, 0, 1000, B_INFINITY};
-        DiscreteNode not_F{empty(holder), false, NodeType::NOT, 0, 5, 0, 0};
-        DiscreteNode and_C{empty(holder), false, NodeType::AND, 3, 6, 0, 0};
-        DiscreteNode root_always{empty(holder), false, NodeType::ALWAYS, 0, 7, 0, B_INFINITY};
-        std::vector<DiscreteNode> nodes{p, s, once_p, implies_D, not_s, since_F, not_F, and_C, root_always};
-
-        for (size_t i = 0; i < allInputs.size(); i++)
-        {
-            run_evaluation(nodes, holder, allInputs[i].time, {allInputs[i].p, allInputs[i].s});
-            swapBuffers(holder);
-        }
-        destroyHolder(holder);
+        std::cerr << "Error writing verdicts" << std::endl;
+        return 1;
     }
-    else
+    if ((stream && stream->failed) || (jsonl_stream && jsonl_stream->failed))
     {
-        std::cout << "Error: Can't find code for spec: " << arguments.spec << std::endl;
+        std::cerr << "Error reading input" << std::endl;
+        return 1;
     }
 }
 
-
-void dense_case(arguments arguments, std::vector<binary_row_reader::TimescalesInput> allInputs)
+static void printStats(const IntervalSetHolder &holder)
 {
-    // AbsentAQ: historically((once[:N]{q}) -> ((not{p}) since {q}))
-    if (strcmp(arguments.spec, "historically((once[:10]{q}) -> ((not{p}) since {q}))") == 0)
-    {
-        IntervalSetHolder holder = newHolder(1000);
-        DenseNode q{empty(holder), empty(holder), NodeType::PROPOSITION, 0, 0, 0, 0};
-        DenseNode p{empty(holder), empty(holder), NodeType::PROPOSITION, 0, 0, 0, 0};
-        DenseNode once{empty(holder), empty(holder), NodeType::EVENTUALLY, 0, 0, 0, 10};
-        DenseNode notNode{empty(holder), empty(holder), NodeType::NOT, 0, 1, 0, 0};
-        DenseNode since{empty(holder), empty(holder), NodeType::SINCE, 3, 0, 0, B_INFINITY};
-        DenseNode implies{empty(holder), empty(holder), NodeType::IMPLIES, 2, 4, 0, 0};
-        DenseNode always{empty(holder), empty(holder), NodeType::ALWAYS, 0, 5, 0, B_INFINITY};
-        std::vector<DenseNode> nodes{q, p, once, notNode, since, implies, always};
-
-        for (int i = 1; i < allInputs.size(); i++)
-        {
-            run_evaluation(nodes, holder, allInputs[i - 1].time, allInputs[i].time, {allInputs[i - 1].q, allInputs[i - 1].p});
-            swapBuffers(holder);
-        }
-        destroyHolder(holder);
-    }
-    else if (strcmp(arguments.spec, "historically((once[:100]{q}) -> ((not{p}) since {q}))") == 0)
-    {
-        IntervalSetHolder holder = newHolder(1000);
-        DenseNode q{empty(holder), empty(holder), NodeType::PROPOSITION, 0, 0, 0, 0};
-        DenseNode p{empty(holder), empty(holder), NodeType::PROPOSITION, 0, 0, 0, 0};
-        DenseNode once{empty(holder), empty(holder), NodeType::EVENTUALLY, 0, 0, 0, 100};
-        DenseNode notNode{empty(holder), empty(holder), NodeType::NOT, 0, 1, 0, 0};
-        DenseNode since{empty(holder), empty(holder), NodeType::SINCE, 3, 0, 0, B_INFINITY};
-        DenseNode implies{empty(holder), empty(holder), NodeType::IMPLIES, 2, 4, 0, 0};
-        DenseNode always{empty(holder), empty(holder), NodeType::ALWAYS, 0, 5, 0, B_INFINITY};
-        std::vector<DenseNode> nodes{q, p, once, notNode, since, implies, always};
-
-        for (int i = 1; i < allInputs.size(); i++)
-        {
-            run_evaluation(nodes, holder, allInputs[i - 1].time, allInputs[i].time, {allInputs[i - 1].q, allInputs[i - 1].p});
-            swapBuffers(holder);
-        }
-        destroyHolder(holder);
-    }
-    else if (strcmp(arguments.spec, "historically((once[:1000]{q}) -> ((not{p}) since {q}))") == 0)
-    {
-        IntervalSetHolder holder = newHolder(1000);
-        DenseNode q{empty(holder), empty(holder), NodeType::PROPOSITION, 0, 0, 0, 0};
-        DenseNode p{empty(holder), empty(holder), NodeType::PROPOSITION, 0, 0, 0, 0};
-        DenseNode once{empty(holder), empty(holder), NodeType::EVENTUALLY, 0, 0, 0, 1000};
-        DenseNode notNode{empty(holder), empty(holder), NodeType::NOT, 0, 1, 0, 0};
-        DenseNode since{empty(holder), empty(holder), NodeType::SINCE, 3, 0, 0, B_INFINITY};
-        DenseNode implies{empty(holder), empty(holder), NodeType::IMPLIES, 2, 4, 0, 0};
-        DenseNode always{empty(holder), empty(holder), NodeType::ALWAYS, 0, 5, 0, B_INFINITY};
-        std::vector<DenseNode> nodes{q, p, once, notNode, since, implies, always};
-
-        for (int i = 1; i < allInputs.size(); i++)
-        {
-            run_evaluation(nodes, holder, allInputs[i - 1].time, allInputs[i].time, {allInputs[i - 1].q, allInputs[i - 1].p});
-            swapBuffers(holder);
-        }
-        destroyHolder(holder);
-    }
-    // AbsentBQR: historically({r} && !{q} && once{q}) -> ((not{p}) since[A:B] {q})
-    else if (strcmp(arguments.spec, "historically({r} && !{q} && once{q}) -> ((not{p}) since[3:10] {q})") == 0)
-    {
-        IntervalSetHolder holder = newHolder(1000);
-        DenseNode q{empty(holder), empty(holder), NodeType::PROPOSITION, 0, 0, 0, 0};
-        DenseNode p{empty(holder), empty(holder), NodeType::PROPOSITION, 0, 0, 0, 0};
-        DenseNode r{empty(holder), empty(holder), NodeType::PROPOSITION, 0, 0, 0, 0};
-        DenseNode not_q{empty(holder), empty(holder), NodeType::NOT, 0, 0, 0, 0};
-        DenseNode once_q{empty(holder), empty(holder), NodeType::EVENTUALLY, 0, 0, 0, B_INFINITY};
-        DenseNode and1{empty(holder), empty(holder), NodeType::AND, 2, 3, 0, 0};
-        DenseNode and2{empty(holder), empty(holder), NodeType::AND, 5, 4, 0, 0};
-        DenseNode not_p{empty(holder), empty(holder), NodeType::NOT, 0, 1, 0, 0};
-        DenseNode since_node{empty(holder), empty(holder), NodeType::SINCE, 7, 0, 3, 10};
-        DenseNode implies_node{empty(holder), empty(holder), NodeType::IMPLIES, 6, 8, 0, 0};
-        DenseNode always_node{empty(holder), empty(holder), NodeType::ALWAYS, 0, 9, 0, B_INFINITY};
-        std::vector<DenseNode> nodes{q, p, r, not_q, once_q, and1, and2, not_p, since_node, implies_node, always_node};
-
-        for (int i = 1; i < allInputs.size(); i++)
-        {
-            run_evaluation(nodes, holder, allInputs[i - 1].time, allInputs[i].time, {allInputs[i - 1].q, allInputs[i - 1].p, allInputs[i - 1].r});
-            swapBuffers(holder);
-        }
-        destroyHolder(holder);
-    }
-    else if (strcmp(arguments.spec, "historically({r} && !{q} && once{q}) -> ((not{p}) since[30:100] {q})") == 0)
-    {
-        IntervalSetHolder holder = newHolder(1000);
-        DenseNode q{empty(holder), empty(holder), NodeType::PROPOSITION, 0, 0, 0, 0};
-        DenseNode p{empty(holder), empty(holder), NodeType::PROPOSITION, 0, 0, 0, 0};
-        DenseNode r{empty(holder), empty(holder), NodeType::PROPOSITION, 0, 0, 0, 0};
-        DenseNode not_q{empty(holder), empty(holder), NodeType::NOT, 0, 0, 0, 0};
-        DenseNode once_q{empty(holder), empty(holder), NodeType::EVENTUALLY, 0, 0, 0, B_INFINITY};
-        DenseNode and1{empty(holder), empty(holder), NodeType::AND, 2, 3, 0, 0};
-        DenseNode and2{empty(holder), empty(holder), NodeType::AND, 5, 4, 0, 0};
-        DenseNode not_p{empty(holder), empty(holder), NodeType::NOT, 0, 1, 0, 0};
-        DenseNode since_node{empty(holder), empty(holder), NodeType::SINCE, 7, 0, 30, 100};
-        DenseNode implies_node{empty(holder), empty(holder), NodeType::IMPLIES, 6, 8, 0, 0};
-        DenseNode always_node{empty(holder), empty(holder), NodeType::ALWAYS, 0, 9, 0, B_INFINITY};
-        std::vector<DenseNode> nodes{q, p, r, not_q, once_q, and1, and2, not_p, since_node, implies_node, always_node};
-
-        for (int i = 1; i < allInputs.size(); i++)
-        {
-            run_evaluation(nodes, holder, allInputs[i - 1].time, allInputs[i].time, {allInputs[i - 1].q, allInputs[i - 1].p, allInputs[i - 1].r});
-            swapBuffers(holder);
-        }
-        destroyHolder(holder);
-    }
-    else if (strcmp(arguments.spec, "historically({r} && !{q} && once{q}) -> ((not{p}) since[300:1000] {q})") == 0)
-    {
-        IntervalSetHolder holder = newHolder(1000);
-        DenseNode q{empty(holder), empty(holder), NodeType::PROPOSITION, 0, 0, 0, 0};
-        DenseNode p{empty(holder), empty(holder), NodeType::PROPOSITION, 0, 0, 0, 0};
-        DenseNode r{empty(holder), empty(holder), NodeType::PROPOSITION, 0, 0, 0, 0};
-        DenseNode not_q{empty(holder), empty(holder), NodeType::NOT, 0, 0, 0, 0};
-        DenseNode once_q{empty(holder), empty(holder), NodeType::EVENTUALLY, 0, 0, 0, B_INFINITY};
-        DenseNode and1{empty(holder), empty(holder), NodeType::AND, 2, 3, 0, 0};
-        DenseNode and2{empty(holder), empty(holder), NodeType::AND, 5, 4, 0, 0};
-        DenseNode not_p{empty(holder), empty(holder), NodeType::NOT, 0, 1, 0, 0};
-        DenseNode since_node{empty(holder), empty(holder), NodeType::SINCE, 7, 0, 300, 1000};
-        DenseNode implies_node{empty(holder), empty(holder), NodeType::IMPLIES, 6, 8, 0, 0};
-        DenseNode always_node{empty(holder), empty(holder), NodeType::ALWAYS, 0, 9, 0, B_INFINITY};
-        std::vector<DenseNode> nodes{q, p, r, not_q, once_q, and1, and2, not_p, since_node, implies_node, always_node};
-
-        for (int i = 1; i < allInputs.size(); i++)
-        {
-            run_evaluation(nodes, holder, allInputs[i - 1].time, allInputs[i].time, {allInputs[i - 1].q, allInputs[i - 1].p, allInputs[i - 1].r});
-            swapBuffers(holder);
-        }
-        destroyHolder(holder);
-    }
-    // AbsentBR: historically({r} -> (historically[:N](not{p})))
-    else if (strcmp(arguments.spec, "historically({r} -> (historically[:10](not{p})))") == 0)
-    {
-        IntervalSetHolder holder = newHolder(1000);
-        DenseNode q{empty(holder), empty(holder), NodeType::PROPOSITION, 0, 0, 0, 0};
-        DenseNode p{empty(holder), empty(holder), NodeType::PROPOSITION, 0, 0, 0, 0};
-        DenseNode r{empty(holder), empty(holder), NodeType::PROPOSITION, 0, 0, 0, 0};
-        DenseNode not_p{empty(holder), empty(holder), NodeType::NOT, 0, 1, 0, 0};
-        DenseNode inner_always{empty(holder), empty(holder), NodeType::ALWAYS, 0, 3, 0, 10};
-        DenseNode implies_node{empty(holder), empty(holder), NodeType::IMPLIES, 2, 4, 0, 0};
-        DenseNode root_always{empty(holder), empty(holder), NodeType::ALWAYS, 0, 5, 0, B_INFINITY};
-        std::vector<DenseNode> nodes{q, p, r, not_p, inner_always, implies_node, root_always};
-
-        for (int i = 1; i < allInputs.size(); i++)
-        {
-            run_evaluation(nodes, holder, allInputs[i - 1].time, allInputs[i].time, {allInputs[i - 1].q, allInputs[i - 1].p, allInputs[i - 1].r});
-            swapBuffers(holder);
-        }
-        destroyHolder(holder);
-    }
-    else if (strcmp(arguments.spec, "historically({r} -> (historically[:100](not{p})))") == 0)
-    {
-        IntervalSetHolder holder = newHolder(1000);
-        DenseNode q{empty(holder), empty(holder), NodeType::PROPOSITION, 0, 0, 0, 0};
-        DenseNode p{empty(holder), empty(holder), NodeType::PROPOSITION, 0, 0, 0, 0};
-        DenseNode r{empty(holder), empty(holder), NodeType::PROPOSITION, 0, 0, 0, 0};
-        DenseNode not_p{empty(holder), empty(holder), NodeType::NOT, 0, 1, 0, 0};
-        DenseNode inner_always{empty(holder), empty(holder), NodeType::ALWAYS, 0, 3, 0, 100};
-        DenseNode implies_node{empty(holder), empty(holder), NodeType::IMPLIES, 2, 4, 0, 0};
-        DenseNode root_always{empty(holder), empty(holder), NodeType::ALWAYS, 0, 5, 0, B_INFINITY};
-        std::vector<DenseNode> nodes{q, p, r, not_p, inner_always, implies_node, root_always};
-
-        for (int i = 1; i < allInputs.size(); i++)
-        {
-            run_evaluation(nodes, holder, allInputs[i - 1].time, allInputs[i].time, {allInputs[i - 1].q, allInputs[i - 1].p, allInputs[i - 1].r});
-            swapBuffers(holder);
-        }
-        destroyHolder(holder);
-    }
-    else if (strcmp(arguments.spec, "historically({r} -> (historically[:1000](not{p})))") == 0)
-    {
-        IntervalSetHolder holder = newHolder(1000);
-        DenseNode q{empty(holder), empty(holder), NodeType::PROPOSITION, 0, 0, 0, 0};
-        DenseNode p{empty(holder), empty(holder), NodeType::PROPOSITION, 0, 0, 0, 0};
-        DenseNode r{empty(holder), empty(holder), NodeType::PROPOSITION, 0, 0, 0, 0};
-        DenseNode not_p{empty(holder), empty(holder), NodeType::NOT, 0, 1, 0, 0};
-        DenseNode inner_always{empty(holder), empty(holder), NodeType::ALWAYS, 0, 3, 0, 1000};
-        DenseNode implies_node{empty(holder), empty(holder), NodeType::IMPLIES, 2, 4, 0, 0};
-        DenseNode root_always{empty(holder), empty(holder), NodeType::ALWAYS, 0, 5, 0, B_INFINITY};
-        std::vector<DenseNode> nodes{q, p, r, not_p, inner_always, implies_node, root_always};
-
-        for (int i = 1; i < allInputs.size(); i++)
-        {
-            run_evaluation(nodes, holder, allInputs[i - 1].time, allInputs[i].time, {allInputs[i - 1].q, allInputs[i - 1].p, allInputs[i - 1].r});
-            swapBuffers(holder);
-        }
-        destroyHolder(holder);
-    }
-    // AlwaysAQ: historically((once[:N]{q}) -> ({p} since {q}))
-    else if (strcmp(arguments.spec, "historically((once[:10]{q}) -> ({p} since {q}))") == 0)
-    {
-        IntervalSetHolder holder = newHolder(1000);
-        DenseNode q{empty(holder), empty(holder), NodeType::PROPOSITION, 0, 0, 0, 0};
-        DenseNode p{empty(holder), empty(holder), NodeType::PROPOSITION, 0, 0, 0, 0};
-        DenseNode r{empty(holder), empty(holder), NodeType::PROPOSITION, 0, 0, 0, 0};
-        DenseNode once_q{empty(holder), empty(holder), NodeType::EVENTUALLY, 0, 0, 0, 10};
-        DenseNode since_node{empty(holder), empty(holder), NodeType::SINCE, 1, 0, 0, B_INFINITY};
-        DenseNode implies_node{empty(holder), empty(holder), NodeType::IMPLIES, 3, 4, 0, 0};
-        DenseNode root_always{empty(holder), empty(holder), NodeType::ALWAYS, 0, 5, 0, B_INFINITY};
-        std::vector<DenseNode> nodes{q, p, r, once_q, since_node, implies_node, root_always};
-
-        for (int i = 1; i < allInputs.size(); i++)
-        {
-            run_evaluation(nodes, holder, allInputs[i - 1].time, allInputs[i].time, {allInputs[i - 1].q, allInputs[i - 1].p, allInputs[i - 1].r});
-            swapBuffers(holder);
-        }
-        destroyHolder(holder);
-    }
-    else if (strcmp(arguments.spec, "historically((once[:100]{q}) -> ({p} since {q}))") == 0)
-    {
-        IntervalSetHolder holder = newHolder(1000);
-        DenseNode q{empty(holder), empty(holder), NodeType::PROPOSITION, 0, 0, 0, 0};
-        DenseNode p{empty(holder), empty(holder), NodeType::PROPOSITION, 0, 0, 0, 0};
-        DenseNode r{empty(holder), empty(holder), NodeType::PROPOSITION, 0, 0, 0, 0};
-        DenseNode once_q{empty(holder), empty(holder), NodeType::EVENTUALLY, 0, 0, 0, 100};
-        DenseNode since_node{empty(holder), empty(holder), NodeType::SINCE, 1, 0, 0, B_INFINITY};
-        DenseNode implies_node{empty(holder), empty(holder), NodeType::IMPLIES, 3, 4, 0, 0};
-        DenseNode root_always{empty(holder), empty(holder), NodeType::ALWAYS, 0, 5, 0, B_INFINITY};
-        std::vector<DenseNode> nodes{q, p, r, once_q, since_node, implies_node, root_always};
-
-        for (int i = 1; i < allInputs.size(); i++)
-        {
-            run_evaluation(nodes, holder, allInputs[i - 1].time, allInputs[i].time, {allInputs[i - 1].q, allInputs[i - 1].p, allInputs[i - 1].r});
-            swapBuffers(holder);
-        }
-        destroyHolder(holder);
-    }
-    else if (strcmp(arguments.spec, "historically((once[:1000]{q}) -> ({p} since {q}))") == 0)
-    {
-        IntervalSetHolder holder = newHolder(1000);
-        DenseNode q{empty(holder), empty(holder), NodeType::PROPOSITION, 0, 0, 0, 0};
-        DenseNode p{empty(holder), empty(holder), NodeType::PROPOSITION, 0, 0, 0, 0};
-        DenseNode r{empty(holder), empty(holder), NodeType::PROPOSITION, 0, 0, 0, 0};
-        DenseNode once_q{empty(holder), empty(holder), NodeType::EVENTUALLY, 0, 0, 0, 1000};
-        DenseNode since_node{empty(holder), empty(holder), NodeType::SINCE, 1, 0, 0, B_INFINITY};
-        DenseNode implies_node{empty(holder), empty(holder), NodeType::IMPLIES, 3, 4, 0, 0};
-        DenseNode root_always{empty(holder), empty(holder), NodeType::ALWAYS, 0, 5, 0, B_INFINITY};
-        std::vector<DenseNode> nodes{q, p, r, once_q, since_node, implies_node, root_always};
-
-        for (int i = 1; i < allInputs.size(); i++)
-        {
-            run_evaluation(nodes, holder, allInputs[i - 1].time, allInputs[i].time, {allInputs[i - 1].q, allInputs[i - 1].p, allInputs[i - 1].r});
-            swapBuffers(holder);
-        }
-        destroyHolder(holder);
-    }
-    // AlwaysBQR: historically(({r} && !{q} && once{q}) -> ({p} since[A:B] {q}))
-    else if (strcmp(arguments.spec, "historically(({r} && !{q} && once{q}) -> ({p} since[3:10] {q}))") == 0)
-    {
-        IntervalSetHolder holder = newHolder(1000);
-        DenseNode q{empty(holder), empty(holder), NodeType::PROPOSITION, 0, 0, 0, 0};
-        DenseNode p{empty(holder), empty(holder), NodeType::PROPOSITION, 0, 0, 0, 0};
-        DenseNode r{empty(holder), empty(holder), NodeType::PROPOSITION, 0, 0, 0, 0};
-        DenseNode not_q{empty(holder), empty(holder), NodeType::NOT, 0, 0, 0, 0};
-        DenseNode once_q{empty(holder), empty(holder), NodeType::EVENTUALLY, 0, 0, 0, B_INFINITY};
-        DenseNode and1{empty(holder), empty(holder), NodeType::AND, 2, 3, 0, 0};
-        DenseNode and2{empty(holder), empty(holder), NodeType::AND, 5, 4, 0, 0};
-        DenseNode not_p{empty(holder), empty(holder), NodeType::NOT, 0, 1, 0, 0};
-        DenseNode since_node{empty(holder), empty(holder), NodeType::SINCE, 1, 0, 3, 10};
-        DenseNode implies_node{empty(holder), empty(holder), NodeType::IMPLIES, 6, 8, 0, 0};
-        DenseNode always_node{empty(holder), empty(holder), NodeType::ALWAYS, 0, 9, 0, B_INFINITY};
-        std::vector<DenseNode> nodes{q, p, r, not_q, once_q, and1, and2, not_p, since_node, implies_node, always_node};
-
-        for (int i = 1; i < allInputs.size(); i++)
-        {
-            run_evaluation(nodes, holder, allInputs[i - 1].time, allInputs[i].time, {allInputs[i - 1].q, allInputs[i - 1].p, allInputs[i - 1].r});
-            swapBuffers(holder);
-        }
-        destroyHolder(holder);
-    }
-    else if (strcmp(arguments.spec, "historically(({r} && !{q} && once{q}) -> ({p} since[30:100] {q}))") == 0)
-    {
-        IntervalSetHolder holder = newHolder(1000);
-        DenseNode q{empty(holder), empty(holder), NodeType::PROPOSITION, 0, 0, 0, 0};
-        DenseNode p{empty(holder), empty(holder), NodeType::PROPOSITION, 0, 0, 0, 0};
-        DenseNode r{empty(holder), empty(holder), NodeType::PROPOSITION, 0, 0, 0, 0};
-        DenseNode not_q{empty(holder), empty(holder), NodeType::NOT, 0, 0, 0, 0};
-        DenseNode once_q{empty(holder), empty(holder), NodeType::EVENTUALLY, 0, 0, 0, B_INFINITY};
-        DenseNode and1{empty(holder), empty(holder), NodeType::AND, 2, 3, 0, 0};
-        DenseNode and2{empty(holder), empty(holder), NodeType::AND, 5, 4, 0, 0};
-        DenseNode not_p{empty(holder), empty(holder), NodeType::NOT, 0, 1, 0, 0};
-        DenseNode since_node{empty(holder), empty(holder), NodeType::SINCE, 1, 0, 30, 100};
-        DenseNode implies_node{empty(holder), empty(holder), NodeType::IMPLIES, 6, 8, 0, 0};
-        DenseNode always_node{empty(holder), empty(holder), NodeType::ALWAYS, 0, 9, 0, B_INFINITY};
-        std::vector<DenseNode> nodes{q, p, r, not_q, once_q, and1, and2, not_p, since_node, implies_node, always_node};
-
-        for (int i = 1; i < allInputs.size(); i++)
-        {
-            run_evaluation(nodes, holder, allInputs[i - 1].time, allInputs[i].time, {allInputs[i - 1].q, allInputs[i - 1].p, allInputs[i - 1].r});
-            swapBuffers(holder);
-        }
-        destroyHolder(holder);
-    }
-    else if (strcmp(arguments.spec, "historically(({r} && !{q} && once{q}) -> ({p} since[300:1000] {q}))") == 0)
-    {
-        IntervalSetHolder holder = newHolder(1000);
-        DenseNode q{empty(holder), empty(holder), NodeType::PROPOSITION, 0, 0, 0, 0};
-        DenseNode p{empty(holder), empty(holder), NodeType::PROPOSITION, 0, 0, 0, 0};
-        DenseNode r{empty(holder), empty(holder), NodeType::PROPOSITION, 0, 0, 0, 0};
-        DenseNode not_q{empty(holder), empty(holder), NodeType::NOT, 0, 0, 0, 0};
-        DenseNode once_q{empty(holder), empty(holder), NodeType::EVENTUALLY, 0, 0, 0, B_INFINITY};
-        DenseNode and1{empty(holder), empty(holder), NodeType::AND, 2, 3, 0, 0};
-        DenseNode and2{empty(holder), empty(holder), NodeType::AND, 5, 4, 0, 0};
-        DenseNode not_p{empty(holder), empty(holder), NodeType::NOT, 0, 1, 0, 0};
-        DenseNode since_node{empty(holder), empty(holder), NodeType::SINCE, 1, 0, 300, 1000};
-        DenseNode implies_node{empty(holder), empty(holder), NodeType::IMPLIES, 6, 8, 0, 0};
-        DenseNode always_node{empty(holder), empty(holder), NodeType::ALWAYS, 0, 9, 0, B_INFINITY};
-        std::vector<DenseNode> nodes{q, p, r, not_q, once_q, and1, and2, not_p, since_node, implies_node, always_node};
-
-        for (int i = 1; i < allInputs.size(); i++)
-        {
-            run_evaluation(nodes, holder, allInputs[i - 1].time, allInputs[i].time, {allInputs[i - 1].q, allInputs[i - 1].p, allInputs[i - 1].r});
-            swapBuffers(holder);
-        }
-        destroyHolder(holder);
-    }
-    // AlwaysBR: historically({r} -> (historically[:N]{p}))
-    else if (strcmp(arguments.spec, "historically({r} -> (historically[:10]{p}))") == 0)
-    {
-        IntervalSetHolder holder = newHolder(1000);
-        DenseNode q{empty(holder), empty(holder), NodeType::PROPOSITION, 0, 0, 0, 0};
-        DenseNode p{empty(holder), empty(holder), NodeType::PROPOSITION, 0, 0, 0, 0};
-        DenseNode r{empty(holder), empty(holder), NodeType::PROPOSITION, 0, 0, 0, 0};
-        DenseNode inner_always{empty(holder), empty(holder), NodeType::ALWAYS, 0, 1, 0, 10};
-        DenseNode implies_node{empty(holder), empty(holder), NodeType::IMPLIES, 2, 3, 0, 0};
-        DenseNode root_always{empty(holder), empty(holder), NodeType::ALWAYS, 0, 4, 0, B_INFINITY};
-        std::vector<DenseNode> nodes{q, p, r, inner_always, implies_node, root_always};
-
-        for (int i = 1; i < allInputs.size(); i++)
-        {
-            run_evaluation(nodes, holder, allInputs[i - 1].time, allInputs[i].time, {allInputs[i - 1].q, allInputs[i - 1].p, allInputs[i - 1].r});
-            swapBuffers(holder);
-        }
-        destroyHolder(holder);
-    }
-    else if (strcmp(arguments.spec, "historically({r} -> (historically[:100]{p}))") == 0)
-    {
-        IntervalSetHolder holder = newHolder(1000);
-        DenseNode q{empty(holder), empty(holder), NodeType::PROPOSITION, 0, 0, 0, 0};
-        DenseNode p{empty(holder), empty(holder), NodeType::PROPOSITION, 0, 0, 0, 0};
-        DenseNode r{empty(holder), empty(holder), NodeType::PROPOSITION, 0, 0, 0, 0};
-        DenseNode inner_always{empty(holder), empty(holder), NodeType::ALWAYS, 0, 1, 0, 100};
-        DenseNode implies_node{empty(holder), empty(holder), NodeType::IMPLIES, 2, 3, 0, 0};
-        DenseNode root_always{empty(holder), empty(holder), NodeType::ALWAYS, 0, 4, 0, B_INFINITY};
-        std::vector<DenseNode> nodes{q, p, r, inner_always, implies_node, root_always};
-
-        for (int i = 1; i < allInputs.size(); i++)
-        {
-            run_evaluation(nodes, holder, allInputs[i - 1].time, allInputs[i].time, {allInputs[i - 1].q, allInputs[i - 1].p, allInputs[i - 1].r});
-            swapBuffers(holder);
-        }
-        destroyHolder(holder);
-    }
-    else if (strcmp(arguments.spec, "historically({r} -> (historically[:1000]{p}))") == 0)
-    {
-        IntervalSetHolder holder = newHolder(1000);
-        DenseNode q{empty(holder), empty(holder), NodeType::PROPOSITION, 0, 0, 0, 0};
-        DenseNode p{empty(holder), empty(holder), NodeType::PROPOSITION, 0, 0, 0, 0};
-        DenseNode r{empty(holder), empty(holder), NodeType::PROPOSITION, 0, 0, 0, 0};
-        DenseNode inner_always{empty(holder), empty(holder), NodeType::ALWAYS, 0, 1, 0, 1000};
-        DenseNode implies_node{empty(holder), empty(holder), NodeType::IMPLIES, 2, 3, 0, 0};
-        DenseNode root_always{empty(holder), empty(holder), NodeType::ALWAYS, 0, 4, 0, B_INFINITY};
-        std::vector<DenseNode> nodes{q, p, r, inner_always, implies_node, root_always};
-
-        for (int i = 1; i < allInputs.size(); i++)
-        {
-            run_evaluation(nodes, holder, allInputs[i - 1].time, allInputs[i].time, {allInputs[i - 1].q, allInputs[i - 1].p, allInputs[i - 1].r});
-            swapBuffers(holder);
-        }
-        destroyHolder(holder);
-    }
-    // RecurBQR: historically(({r} && !{q} && once{q}) -> ((once[:N]({p} or {q})) since {q}))
-    else if (strcmp(arguments.spec, "historically(({r} && !{q} && once{q}) -> ((once[:10]({p} or {q})) since {q}))") == 0)
-    {
-        IntervalSetHolder holder = newHolder(1000);
-        DenseNode q{empty(holder), empty(holder), NodeType::PROPOSITION, 0, 0, 0, 0};
-        DenseNode p{empty(holder), empty(holder), NodeType::PROPOSITION, 0, 0, 0, 0};
-        DenseNode r{empty(holder), empty(holder), NodeType::PROPOSITION, 0, 0, 0, 0};
-        DenseNode not_q{empty(holder), empty(holder), NodeType::NOT, 0, 0, 0, 0};
-        DenseNode once_q{empty(holder), empty(holder), NodeType::EVENTUALLY, 0, 0, 0, B_INFINITY};
-        DenseNode and1{empty(holder), empty(holder), NodeType::AND, 2, 3, 0, 0};
-        DenseNode and2{empty(holder), empty(holder), NodeType::AND, 5, 4, 0, 0};
-        DenseNode p_or_q{empty(holder), empty(holder), NodeType::OR, 1, 0, 0, 0};
-        DenseNode once_p_or_q{empty(holder), empty(holder), NodeType::EVENTUALLY, 0, 7, 0, 10};
-        DenseNode since_node{empty(holder), empty(holder), NodeType::SINCE, 8, 0, 0, B_INFINITY};
-        DenseNode implies_node{empty(holder), empty(holder), NodeType::IMPLIES, 6, 9, 0, 0};
-        DenseNode root_always{empty(holder), empty(holder), NodeType::ALWAYS, 0, 10, 0, B_INFINITY};
-        std::vector<DenseNode> nodes{q, p, r, not_q, once_q, and1, and2, p_or_q, once_p_or_q, since_node, implies_node, root_always};
-
-        for (int i = 1; i < allInputs.size(); i++)
-        {
-            run_evaluation(nodes, holder, allInputs[i - 1].time, allInputs[i].time, {allInputs[i - 1].q, allInputs[i - 1].p, allInputs[i - 1].r});
-            swapBuffers(holder);
-        }
-        destroyHolder(holder);
-    }
-    else if (strcmp(arguments.spec, "historically(({r} && !{q} && once{q}) -> ((once[:100]({p} or {q})) since {q}))") == 0)
-    {
-        IntervalSetHolder holder = newHolder(1000);
-        DenseNode q{empty(holder), empty(holder), NodeType::PROPOSITION, 0, 0, 0, 0};
-        DenseNode p{empty(holder), empty(holder), NodeType::PROPOSITION, 0, 0, 0, 0};
-        DenseNode r{empty(holder), empty(holder), NodeType::PROPOSITION, 0, 0, 0, 0};
-        DenseNode not_q{empty(holder), empty(holder), NodeType::NOT, 0, 0, 0, 0};
-        DenseNode once_q{empty(holder), empty(holder), NodeType::EVENTUALLY, 0, 0, 0, B_INFINITY};
-        DenseNode and1{empty(holder), empty(holder), NodeType::AND, 2, 3, 0, 0};
-        DenseNode and2{empty(holder), empty(holder), NodeType::AND, 5, 4, 0, 0};
-        DenseNode p_or_q{empty(holder), empty(holder), NodeType::OR, 1, 0, 0, 0};
-        DenseNode once_p_or_q{empty(holder), empty(holder), NodeType::EVENTUALLY, 0, 7, 0, 100};
-        DenseNode since_node{empty(holder), empty(holder), NodeType::SINCE, 8, 0, 0, B_INFINITY};
-        DenseNode implies_node{empty(holder), empty(holder), NodeType::IMPLIES, 6, 9, 0, 0};
-        DenseNode root_always{empty(holder), empty(holder), NodeType::ALWAYS, 0, 10, 0, B_INFINITY};
-        std::vector<DenseNode> nodes{q, p, r, not_q, once_q, and1, and2, p_or_q, once_p_or_q, since_node, implies_node, root_always};
-
-        for (int i = 1; i < allInputs.size(); i++)
-        {
-            run_evaluation(nodes, holder, allInputs[i - 1].time, allInputs[i].time, {allInputs[i - 1].q, allInputs[i - 1].p, allInputs[i - 1].r});
-            swapBuffers(holder);
-        }
-        destroyHolder(holder);
-    }
-    else if (strcmp(arguments.spec, "historically(({r} && !{q} && once{q}) -> ((once[:1000]({p} or {q})) since {q}))") == 0)
-    {
-        IntervalSetHolder holder = newHolder(1000);
-        DenseNode q{empty(holder), empty(holder), NodeType::PROPOSITION, 0, 0, 0, 0};
-        DenseNode p{empty(holder), empty(holder), NodeType::PROPOSITION, 0, 0, 0, 0};
-        DenseNode r{empty(holder), empty(holder), NodeType::PROPOSITION, 0, 0, 0, 0};
-        DenseNode not_q{empty(holder), empty(holder), NodeType::NOT, 0, 0, 0, 0};
-        DenseNode once_q{empty(holder), empty(holder), NodeType::EVENTUALLY, 0, 0, 0, B_INFINITY};
-        DenseNode and1{empty(holder), empty(holder), NodeType::AND, 2, 3, 0, 0};
-        DenseNode and2{empty(holder), empty(holder), NodeType::AND, 5, 4, 0, 0};
-        DenseNode p_or_q{empty(holder), empty(holder), NodeType::OR, 1, 0, 0, 0};
-        DenseNode once_p_or_q{empty(holder), empty(holder), NodeType::EVENTUALLY, 0, 7, 0, 1000};
-        DenseNode since_node{empty(holder), empty(holder), NodeType::SINCE, 8, 0, 0, B_INFINITY};
-        DenseNode implies_node{empty(holder), empty(holder), NodeType::IMPLIES, 6, 9, 0, 0};
-        DenseNode root_always{empty(holder), empty(holder), NodeType::ALWAYS, 0, 10, 0, B_INFINITY};
-        std::vector<DenseNode> nodes{q, p, r, not_q, once_q, and1, and2, p_or_q, once_p_or_q, since_node, implies_node, root_always};
-
-        for (int i = 1; i < allInputs.size(); i++)
-        {
-            run_evaluation(nodes, holder, allInputs[i - 1].time, allInputs[i].time, {allInputs[i - 1].q, allInputs[i - 1].p, allInputs[i - 1].r});
-            swapBuffers(holder);
-        }
-        destroyHolder(holder);
-    }
-    // RecurGLB: historically(once[:N]{p})
-    else if (strcmp(arguments.spec, "historically(once[:10]{p})") == 0)
-    {
-        IntervalSetHolder holder = newHolder(1000);
-        DenseNode p{empty(holder), empty(holder), NodeType::PROPOSITION, 0, 0, 0, 0};
-        DenseNode once{empty(holder), empty(holder), NodeType::EVENTUALLY, 0, 0, 0, 10};
-        DenseNode always{empty(holder), empty(holder), NodeType::ALWAYS, 0, 1, 0, B_INFINITY};
-        std::vector<DenseNode> nodes{p, once, always};
-
-        for (int i = 1; i < allInputs.size(); i++)
-        {
-            run_evaluation(nodes, holder, allInputs[i - 1].time, allInputs[i].time, {allInputs[i - 1].p});
-            swapBuffers(holder);
-        }
-        destroyHolder(holder);
-    }
-    else if (strcmp(arguments.spec, "historically(once[:100]{p})") == 0)
-    {
-        IntervalSetHolder holder = newHolder(1000);
-        DenseNode p{empty(holder), empty(holder), NodeType::PROPOSITION, 0, 0, 0, 0};
-        DenseNode once{empty(holder), empty(holder), NodeType::EVENTUALLY, 0, 0, 0, 100};
-        DenseNode always{empty(holder), empty(holder), NodeType::ALWAYS, 0, 1, 0, B_INFINITY};
-        std::vector<DenseNode> nodes{p, once, always};
+    std::cerr << "Holder peak usage: " << peakUsage(holder) << " transitions per step"
+              << ", buffer size: " << std::max(holder.bufferSize, holder.readBufferSize) << std::endl;
+}
 
-        for (int i = 1; i < allInputs.size(); i++)
-        {
-            run_evaluation(nodes, holder, allInputs[i - 1].time, allInputs[i].time, {allInputs[i - 1].p});
-            swapBuffers(holder);
-        }
-        destroyHolder(holder);
-    }
-    else if (strcmp(arguments.spec, "historically(once[:1000]{p})") == 0)
+static int batch_case(const spec_compiler::CompiledSpec &spec, const struct arguments &arguments, bool use_discrete)
+{
+    std::vector<std::string> paths = monitor::expandTracePaths(arguments.traces);
+    if (paths.empty())
     {
-        IntervalSetHolder holder = newHolder(1000);
-        DenseNode p{empty(holder), empty(holder), NodeType::PROPOSITION, 0, 0, 0, 0};
-        DenseNode once{empty(holder), empty(holder), NodeType::EVENTUALLY, 0, 0, 0, 1000};
-        DenseNode always{empty(holder), empty(holder), NodeType::ALWAYS, 0, 1, 0, B_INFINITY};
-        std::vector<DenseNode> nodes{p, once, always};
-
-        for (int i = 1; i < allInputs.size(); i++)
-        {
-            run_evaluation(nodes, holder, allInputs[i - 1].time, allInputs[i].time, {allInputs[i - 1].p});
-            swapBuffers(holder);
-        }
-        destroyHolder(holder);
+        std::cerr << "Error: --batch needs at least one trace" << std::endl;
+        return 1;
     }
-    // RespondBQR: historically(({r} && !{q} && once{q}) -> ( (({s} -> once[A:B]{p}) and not((not {s}) since[B:] {p})) since {q}))
-    else if (strcmp(arguments.spec, "historically(({r} && !{q} && once{q}) -> ( (({s} -> once[3:10]{p}) and not((not {s}) since[10:] {p})) since {q}))") == 0)
-    {
-        IntervalSetHolder holder = newHolder(1000);
-        DenseNode q{empty(holder), empty(holder), NodeType::PROPOSITION, 0, 0, 0, 0};
-        DenseNode p{empty(holder), empty(holder), NodeType::PROPOSITION, 0, 0, 0, 0};
-        DenseNode s{empty(holder), empty(holder), NodeType::PROPOSITION, 0, 0, 0, 0};
-        DenseNode r{empty(holder), empty(holder), NodeType::PROPOSITION, 0, 0, 0, 0};
-        DenseNode not_q{empty(holder), empty(holder), NodeType::NOT, 0, 0, 0, 0};
-        DenseNode once_q{empty(holder), empty(holder), NodeType::EVENTUALLY, 0, 0, 0, B_INFINITY};
-        DenseNode and_A1{empty(holder), empty(holder), NodeType::AND, 3, 4, 0, 0};
-        DenseNode and_A2{empty(holder), empty(holder), NodeType::AND, 6, 5, 0, 0};
-        DenseNode once_p{empty(holder), empty(holder), NodeType::EVENTUALLY, 0, 1, 3, 10};
-        DenseNode implies_D{empty(holder), empty(holder), NodeType::IMPLIES, 2, 8, 0, 0};
-        DenseNode not_s{empty(holder), empty(holder), NodeType::NOT, 0, 2, 0, 0};
-        DenseNode since_F{empty(holder), empty(holder), NodeType::SINCE, 10, 1, 10, B_INFINITY};
-        DenseNode not_F{empty(holder), empty(holder), NodeType::NOT, 0, 11, 0, 0};
-        DenseNode and_C{empty(holder), empty(holder), NodeType::AND, 9, 12, 0, 0};
-        DenseNode since_B{empty(holder), empty(holder), NodeType::SINCE, 13, 0, 0, B_INFINITY};
-        DenseNode implies_main{empty(holder), empty(holder), NodeType::IMPLIES, 7, 14, 0, 0};
-        DenseNode root_always{empty(holder), empty(holder), NodeType::ALWAYS, 0, 15, 0, B_INFINITY};
-        std::vector<DenseNode> nodes{q, p, s, r, not_q, once_q, and_A1, and_A2, once_p, implies_D, not_s, since_F, not_F, and_C, since_B, implies_main, root_always};
 
-        for (int i = 1; i < allInputs.size(); i++)
-        {
-            run_evaluation(nodes, holder, allInputs[i - 1].time, allInputs[i].time, {allInputs[i - 1].q, allInputs[i - 1].p, allInputs[i - 1].s, allInputs[i - 1].r});
-            swapBuffers(holder);
-        }
-        destroyHolder(holder);
-    }
-    else if (strcmp(arguments.spec, "historically(({r} && !{q} && once{q}) -> ( (({s} -> once[30:100]{p}) and not((not {s}) since[100:] {p})) since {q}))") == 0)
-    {
-        IntervalSetHolder holder = newHolder(1000);
-        DenseNode q{empty(holder), empty(holder), NodeType::PROPOSITION, 0, 0, 0, 0};
-        DenseNode p{empty(holder), empty(holder), NodeType::PROPOSITION, 0, 0, 0, 0};
-        DenseNode s{empty(holder), empty(holder), NodeType::PROPOSITION, 0, 0, 0, 0};
-        DenseNode r{empty(holder), empty(holder), NodeType::PROPOSITION, 0, 0, 0, 0};
-        DenseNode not_q{empty(holder), empty(holder), NodeType::NOT, 0, 0, 0, 0};
-        DenseNode once_q{empty(holder), empty(holder), NodeType::EVENTUALLY, 0, 0, 0, B_INFINITY};
-        DenseNode and_A1{empty(holder), empty(holder), NodeType::AND, 3, 4, 0, 0};
-        DenseNode and_A2{empty(holder), empty(holder), NodeType::AND, 6, 5, 0, 0};
-        DenseNode once_p{empty(holder), empty(holder), NodeType::EVENTUALLY, 0, 1, 30, 100};
-        DenseNode implies_D{empty(holder), empty(holder), NodeType::IMPLIES, 2, 8, 0, 0};
-        DenseNode not_s{empty(holder), empty(holder), NodeType::NOT, 0, 2, 0, 0};
-        DenseNode since_F{empty(holder), empty(holder), NodeType::SINCE, 10, 1, 100, B_INFINITY};
-        DenseNode not_F{empty(holder), empty(holder), NodeType::NOT, 0, 11, 0, 0};
-        DenseNode and_C{empty(holder), empty(holder), NodeType::AND, 9, 12, 0, 0};
-        DenseNode since_B{empty(holder), empty(holder), NodeType::SINCE, 13, 0, 0, B_INFINITY};
-        DenseNode implies_main{empty(holder), empty(holder), NodeType::IMPLIES, 7, 14, 0, 0};
-        DenseNode root_always{empty(holder), empty(holder), NodeType::ALWAYS, 0, 15, 0, B_INFINITY};
-        std::vector<DenseNode> nodes{q, p, s, r, not_q, once_q, and_A1, and_A2, once_p, implies_D, not_s, since_F, not_F, and_C, since_B, implies_main, root_always};
+    auto start = std::chrono::steady_clock::now();
+    std::vector<monitor::TraceReport> reports = monitor::monitorTraces(spec, paths, use_discrete, arguments.threads);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
 
-        for (int i = 1; i < allInputs.size(); i++)
-        {
-            run_evaluation(nodes, holder, allInputs[i - 1].time, allInputs[i].time, {allInputs[i - 1].q, allInputs[i - 1].p, allInputs[i - 1].s, allInputs[i - 1].r});
-            swapBuffers(holder);
-        }
-        destroyHolder(holder);
-    }
-    else if (strcmp(arguments.spec, "historically(({r} && !{q} && once{q}) -> ( (({s} -> once[300:1000]{p}) and not((not {s}) since[1000:] {p})) since {q}))") == 0)
+    std::ofstream output_file;
+    bool to_stdout = arguments.output == nullptr || std::string(arguments.output) == "-";
+    if (!to_stdout)
     {
-        IntervalSetHolder holder = newHolder(1000);
-        DenseNode q{empty(holder), empty(holder), NodeType::PROPOSITION, 0, 0, 0, 0};
-        DenseNode p{empty(holder), empty(holder), NodeType::PROPOSITION, 0, 0, 0, 0};
-        DenseNode s{empty(holder), empty(holder), NodeType::PROPOSITION, 0, 0, 0, 0};
-        DenseNode r{empty(holder), empty(holder), NodeType::PROPOSITION, 0, 0, 0, 0};
-        DenseNode not_q{empty(holder), empty(holder), NodeType::NOT, 0, 0, 0, 0};
-        DenseNode once_q{empty(holder), empty(holder), NodeType::EVENTUALLY, 0, 0, 0, B_INFINITY};
-        DenseNode and_A1{empty(holder), empty(holder), NodeType::AND, 3, 4, 0, 0};
-        DenseNode and_A2{empty(holder), empty(holder), NodeType::AND, 6, 5, 0, 0};
-        DenseNode once_p{empty(holder), empty(holder), NodeType::EVENTUALLY, 0, 1, 300, 1000};
-        DenseNode implies_D{empty(holder), empty(holder), NodeType::IMPLIES, 2, 8, 0, 0};
-        DenseNode not_s{empty(holder), empty(holder), NodeType::NOT, 0, 2, 0, 0};
-        DenseNode since_F{empty(holder), empty(holder), NodeType::SINCE, 10, 1, 1000, B_INFINITY};
-        DenseNode not_F{empty(holder), empty(holder), NodeType::NOT, 0, 11, 0, 0};
-        DenseNode and_C{empty(holder), empty(holder), NodeType::AND, 9, 12, 0, 0};
-        DenseNode since_B{empty(holder), empty(holder), NodeType::SINCE, 13, 0, 0, B_INFINITY};
-        DenseNode implies_main{empty(holder), empty(holder), NodeType::IMPLIES, 7, 14, 0, 0};
-        DenseNode root_always{empty(holder), empty(holder), NodeType::ALWAYS, 0, 15, 0, B_INFINITY};
-        std::vector<DenseNode> nodes{q, p, s, r, not_q, once_q, and_A1, and_A2, once_p, implies_D, not_s, since_F, not_F, and_C, since_B, implies_main, root_always};
-
-        for (int i = 1; i < allInputs.size(); i++)
+        output_file.open(arguments.output);
+        if (!output_file)
         {
-            run_evaluation(nodes, holder, allInputs[i - 1].time, allInputs[i].time, {allInputs[i - 1].q, allInputs[i - 1].p, allInputs[i - 1].s, allInputs[i - 1].r});
-            swapBuffers(holder);
+            std::cerr << "Error opening output file: " << arguments.output << std::endl;
+            return 1;
         }
-        destroyHolder(holder);
     }
-    // RespondGLB: historically(({s} -> once[A:B]{p}) and not((not {s}) since[B:] {p}))
-    else if (strcmp(arguments.spec, "historically(({s} -> once[3:10]{p}) and not((not {s}) since[10:] {p}))") == 0)
-    {
-        IntervalSetHolder holder = newHolder(1000);
-        DenseNode p{empty(holder), empty(holder), NodeType::PROPOSITION, 0, 0, 0, 0};
-        DenseNode s{empty(holder), empty(holder), NodeType::PROPOSITION, 0, 0, 0, 0};
-        DenseNode once_p{empty(holder), empty(holder), NodeType::EVENTUALLY, 0, 0, 3, 10};
-        DenseNode implies_D{empty(holder), empty(holder), NodeType::IMPLIES, 1, 2, 0, 0};
-        DenseNode not_s{empty(holder), empty(holder), NodeType::NOT, 0, 1, 0, 0};
-        DenseNode since_F{empty(holder), empty(holder), NodeType::SINCE, 4, 0, 10, B_INFINITY};
-        DenseNode not_F{empty(holder), empty(holder), NodeType::NOT, 0, 5, 0, 0};
-        DenseNode and_C{empty(holder), empty(holder), NodeType::AND, 3, 6, 0, 0};
-        DenseNode root_always{empty(holder), empty(holder), NodeType::ALWAYS, 0, 7, 0, B_INFINITY};
-        std::vector<DenseNode> nodes{p, s, once_p, implies_D, not_s, since_F, not_F, and_C, root_always};
+    monitor::writeReport(to_stdout ? std::cout : output_file, reports);
 
-        for (int i = 1; i < allInputs.size(); i++)
-        {
-            run_evaluation(nodes, holder, allInputs[i - 1].time, allInputs[i].time, {allInputs[i - 1].p, allInputs[i - 1].s});
-            swapBuffers(holder);
-        }
-        destroyHolder(holder);
-    }
-    else if (strcmp(arguments.spec, "historically(({s} -> once[30:100]{p}) and not((not {s}) since[100:] {p}))") == 0)
+    if (arguments.stats)
     {
-        IntervalSetHolder holder = newHolder(1000);
-        DenseNode p{empty(holder), empty(holder), NodeType::PROPOSITION, 0, 0, 0, 0};
-        DenseNode s{empty(holder), empty(holder), NodeType::PROPOSITION, 0, 0, 0, 0};
-        DenseNode once_p{empty(holder), empty(holder), NodeType::EVENTUALLY, 0, 0, 30, 100};
-        DenseNode implies_D{empty(holder), empty(holder), NodeType::IMPLIES, 1, 2, 0, 0};
-        DenseNode not_s{empty(holder), empty(holder), NodeType::NOT, 0, 1, 0, 0};
-        DenseNode since_F{empty(holder), empty(holder), NodeType::SINCE, 4, 0, 100, B_INFINITY};
-        DenseNode not_F{empty(holder), empty(holder), NodeType::NOT, 0, 5, 0, 0};
-        DenseNode and_C{empty(holder), empty(holder), NodeType::AND, 3, 6, 0, 0};
-        DenseNode root_always{empty(holder), empty(holder), NodeType::ALWAYS, 0, 7, 0, B_INFINITY};
-        std::vector<DenseNode> nodes{p, s, once_p, implies_D, not_s, since_F, not_F, and_C, root_always};
-
-        for (int i = 1; i < allInputs.size(); i++)
+        int peak = 0;
+        size_t events = 0;
+        for (const monitor::TraceReport &report : reports)
         {
-            run_evaluation(nodes, holder, allInputs[i - 1].time, allInputs[i].time, {allInputs[i - 1].p, allInputs[i - 1].s});
-            swapBuffers(holder);
+            peak = std::max(peak, report.peakUsage);
+            events += report.summary.events;
         }
-        destroyHolder(holder);
+        std::cerr << "Holder peak usage: " << peak << " transitions per step" << std::endl;
+        std::cerr << "Monitored " << events << " events in " << seconds << " s" << std::endl;
     }
-    else if (strcmp(arguments.spec, "historically(({s} -> once[300:1000]{p}) and not((not {s}) since[1000:] {p}))") == 0)
-    {
-        IntervalSetHolder holder = newHolder(1000);
-        DenseNode p{empty(holder), empty(holder), NodeType::PROPOSITION, 0, 0, 0, 0};
-        DenseNode s{empty(holder), empty(holder), NodeType::PROPOSITION, 0, 0, 0, 0};
-        DenseNode once_p{empty(holder), empty(holder), NodeType::EVENTUALLY, 0, 0, 300, 1000};
-        DenseNode implies_D{empty(holder), empty(holder), NodeType::IMPLIES, 1, 2, 0, 0};
-        DenseNode not_s{empty(holder), empty(holder), NodeType::NOT, 0, 1, 0, 0};
-        DenseNode since_F{empty(holder), empty(holder), NodeType::SINCE, 4, 0, 1000, B_INFINITY};
-        DenseNode not_F{empty(holder), empty(holder), NodeType::NOT, 0, 5, 0, 0};
-        DenseNode and_C{empty(holder), empty(holder), NodeType::AND, 3, 6, 0, 0};
-        DenseNode root_always{empty(holder), empty(holder), NodeType::ALWAYS, 0, 7, 0, B_INFINITY};
-        std::vector<DenseNode> nodes{p, s, once_p, implies_D, not_s, since_F, not_F, and_C, root_always};
-
-        for (int i = 1; i < allInputs.size(); i++)
-        {
-            run_evaluation(nodes, holder, allInputs[i - 1].time, allInputs[i].time, {allInputs[i - 1].p, allInputs[i - 1].s});
-            swapBuffers(holder);
-        }
-        destroyHolder(holder);
-    }
-    else
-    {
-        std::cout << "Error: Can't find code for spec: " << arguments.spec << std::endl;
-    }
-
-}
\ No newline at end of file
+    bool any_failed = std::any_of(reports.begin(), reports.end(),
+                                  [](const monitor::TraceReport &report) { return !report.error.empty(); });
+    return any_failed ? 1 : 0;
+}
@@ -0,0 +1,462 @@
+#include "do-verify/monitor.hpp"
+
+#include <algorithm>
+#include <deque>
+#include <filesystem>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "do-verify/json_reader.hpp"
+#include "do-verify/MTLEngine.hpp"
+
+namespace monitor {
+
+using db_interval_set::Time;
+
+namespace {
+
+void fillInputs(const char *row, const InputSlots &slots, std::vector<bool> &inputs) {
+    for (size_t j = 0; j < slots.size(); j++) {
+        inputs[j] = binary_row_reader::rowValue(row, slots[j]);
+    }
+}
+
+// Row 'index' of the batch's time. Version 2 traces hold 64-bit times,
+// which only fit a 32-bit build while they stay within its range.
+Time rowTime(const binary_row_reader::RowBatch &batch, size_t index) {
+    const int64_t time = batch.time(index);
+    if (sizeof(Time) < sizeof(int64_t) && time != static_cast<Time>(time)) {
+        throw binary_row_reader::TraceFormatError("Row time " + std::to_string(time) +
+                                                  " needs a build with DO_VERIFY_TIME64");
+    }
+    return static_cast<Time>(time);
+}
+
+// Records the first point of [startTime, endTime) the dense output misses.
+void checkCoverage(TraceSummary &summary, const db_interval_set::IntervalSet &output, Time startTime, Time endTime) {
+    if (summary.violated) {
+        return;
+    }
+    Time covered = startTime;
+    for (int i = output.startIndex; i <= output.endIndex; i++) {
+        const db_interval_set::Transition &t = output.buffer[i];
+        if (t.isStart && t.time > covered) {
+            break;
+        }
+        if (!t.isStart) {
+            covered = std::max(covered, t.time);
+        }
+    }
+    if (covered < endTime) {
+        summary.violated = true;
+        summary.firstViolation = covered;
+    }
+}
+
+// The verdicts in a step's output of a spec delayed by 'delay', moved back
+// to the times they are about. Those from before 'origin', the trace's
+// first time, speak about times the trace doesn't have and are dropped.
+db_interval_set::IntervalSet releaseDelayed(db_interval_set::IntervalSetHolder &holder, const db_interval_set::IntervalSet &output,
+                                            Time delay, Time origin) {
+    auto released = db_interval_set::clipToInterval(holder, output, {do_verify::add_with_inf(origin, delay), B_INFINITY});
+    for (int i = released.startIndex; i <= released.endIndex; i++) {
+        released.buffer[i].time -= delay;
+    }
+    return released;
+}
+
+bool checkpointDue(const Checkpointing *checkpointing, size_t rows) {
+    return checkpointing != nullptr && checkpointing->every > 0 && rows % checkpointing->every == 0;
+}
+
+// Everything but the program states and the dense carry-over
+checkpoint::Snapshot snapshotOf(verdict_writer::VerdictMode mode, uint64_t fingerprint, const TraceSummary &summary,
+                                verdict_writer::VerdictWriter *verdicts) {
+    checkpoint::Snapshot snapshot{};
+    snapshot.mode = static_cast<uint16_t>(mode);
+    snapshot.fingerprint = fingerprint;
+    snapshot.rows = summary.events;
+    snapshot.violated = summary.violated;
+    snapshot.firstViolation = summary.firstViolation;
+    snapshot.outputOffset = -1;
+    if (verdicts != nullptr) {
+        // Closed runs go to the sink now, so its length marks where a
+        // resumed monitor continues writing.
+        verdict_writer::flushVerdicts(*verdicts);
+        snapshot.outputOffset = lseek(verdicts->fd, 0, SEEK_CUR);
+        snapshot.hasRun = verdicts->hasRun;
+        snapshot.runStart = verdicts->runStart;
+        snapshot.runEnd = verdicts->runEnd;
+        snapshot.runValue = verdicts->runValue;
+    }
+    return snapshot;
+}
+
+// Takes over the summary and the open verdict run of a snapshot
+void resumeFrom(const checkpoint::Snapshot &snapshot, verdict_writer::VerdictMode mode, uint64_t fingerprint,
+                TraceSummary &summary, verdict_writer::VerdictWriter *verdicts) {
+    if (snapshot.mode != static_cast<uint16_t>(mode)) {
+        throw checkpoint::CheckpointError("Checkpoint was taken in the other time model");
+    }
+    if (snapshot.fingerprint != fingerprint) {
+        throw checkpoint::CheckpointError("Checkpoint was taken with a different spec");
+    }
+    summary = TraceSummary{snapshot.rows, snapshot.violated, snapshot.firstViolation};
+    if (verdicts != nullptr) {
+        verdicts->hasRun = snapshot.hasRun;
+        verdicts->runStart = snapshot.runStart;
+        verdicts->runEnd = snapshot.runEnd;
+        verdicts->runValue = snapshot.runValue;
+    }
+}
+
+// Rows of 'batch' still to be skipped on resume, taken off 'skip'
+size_t skipRows(size_t &skip, const binary_row_reader::RowBatch &batch) {
+    size_t skipped = std::min(skip, batch.count);
+    skip -= skipped;
+    return skipped;
+}
+
+// The window kernels need time to move forward. A dense row may share the
+// previous row's time, which gives an empty segment; a discrete one may not.
+void checkTimeOrder(Time previous, Time time, bool discrete) {
+    if (time < previous || (discrete && time == previous)) {
+        throw binary_row_reader::TraceFormatError("Row time " + std::to_string(time) +
+                                                  (discrete ? " is not after" : " is before") +
+                                                  " the previous row's time " + std::to_string(previous));
+    }
+}
+
+bool endsWith(const std::string &text, const std::string &suffix) {
+    return text.size() >= suffix.size() && text.compare(text.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+TraceSummary run(const spec_compiler::CompiledSpec &spec, const InputSlots &slots, const RowSource &nextBatch,
+                 db_interval_set::IntervalSetHolder &holder, bool discrete) {
+    return discrete ? runDiscrete(spec, slots, nextBatch, holder, nullptr)
+                    : runDense(spec, slots, nextBatch, holder, nullptr);
+}
+
+TraceReport monitorPath(const spec_compiler::CompiledSpec &spec, const std::string &path, bool discrete,
+                        db_interval_set::IntervalSetHolder &holder) {
+    TraceReport report{path, TraceSummary{0, false, 0}, 0, ""};
+    resetPeakUsage(holder);
+    try {
+        if (endsWith(path, ".jsonl")) {
+            int fd = open(path.c_str(), O_RDONLY);
+            if (fd < 0) {
+                report.error = "Can't open file";
+                return report;
+            }
+            json_reader::JsonlStream stream = json_reader::openJsonlStream(fd, json_reader::newJsonlParser(spec.propositions), 4096);
+            InputSlots slots = binary_row_reader::bindPropositions(json_reader::jsonlHeader(stream.parser), spec.propositions);
+            try {
+                report.summary = run(spec, slots, [&]() { return json_reader::readBatch(stream); }, holder, discrete);
+            } catch (...) {
+                close(fd);
+                throw;
+            }
+            close(fd);
+            if (stream.failed) {
+                report.error = "Read error";
+            }
+        } else {
+            binary_row_reader::MappedTrace mapped = binary_row_reader::mapTraceFile(path);
+            if (mapped.mapping == nullptr) {
+                report.error = "Can't open file or file is empty";
+                return report;
+            }
+            try {
+                InputSlots slots = binary_row_reader::bindPropositions(mapped.header, spec.propositions);
+                bool handedOut = false;
+                report.summary = run(spec, slots, [&]() {
+                    if (handedOut) return binary_row_reader::RowBatch{nullptr, 0, 1};
+                    handedOut = true;
+                    return mapped.rows;
+                }, holder, discrete);
+            } catch (...) {
+                binary_row_reader::unmapTraceFile(mapped);
+                throw;
+            }
+            binary_row_reader::unmapTraceFile(mapped);
+        }
+    } catch (const std::exception &e) {
+        report.error = e.what();
+    }
+    report.peakUsage = peakUsage(holder);
+    return report;
+}
+
+// One worker's share of the traces. The owner pops from the back, thieves
+// take from the front, so they rarely contend for the same end.
+struct WorkQueue {
+    std::mutex mutex;
+    std::deque<size_t> items;
+};
+
+bool takeOwn(WorkQueue &queue, size_t &item) {
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (queue.items.empty()) return false;
+    item = queue.items.back();
+    queue.items.pop_back();
+    return true;
+}
+
+bool steal(WorkQueue &queue, size_t &item) {
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (queue.items.empty()) return false;
+    item = queue.items.front();
+    queue.items.pop_front();
+    return true;
+}
+
+} // namespace
+
+TraceSummary runDiscrete(const spec_compiler::CompiledSpec &spec, const InputSlots &slots, const RowSource &nextBatch,
+                         db_interval_set::IntervalSetHolder &holder, verdict_writer::VerdictWriter *verdicts,
+                         const Checkpointing *checkpointing) {
+    if (spec_compiler::needsDenseTime(spec)) {
+        throw std::invalid_argument("Specs with future operators need the dense time model");
+    }
+    do_verify::DiscreteProgram program = spec_compiler::makeDiscreteProgram(spec, holder);
+    std::vector<bool> inputs(slots.size());
+    TraceSummary summary{0, false, 0};
+
+    const uint64_t fingerprint = checkpointing != nullptr ? checkpoint::specFingerprint(spec) : 0;
+    size_t skip = 0;
+    if (checkpointing != nullptr && checkpointing->resume != nullptr) {
+        resumeFrom(*checkpointing->resume, verdict_writer::VerdictMode::DISCRETE, fingerprint, summary, verdicts);
+        checkpoint::restoreProgram(program, holder, *checkpointing->resume);
+        skip = summary.events;
+    }
+
+    Time previousTime = 0;
+    bool hasPrevious = false;
+    for (binary_row_reader::RowBatch batch = nextBatch(); batch.count > 0; batch = nextBatch()) {
+        const size_t first = skipRows(skip, batch);
+        if (first > 0) {
+            // The rows consumed before the checkpoint are handed out again
+            previousTime = rowTime(batch, first - 1);
+            hasPrevious = true;
+        }
+        for (size_t i = first; i < batch.count; i++) {
+            const char *row = batch.row(i);
+            fillInputs(row, slots, inputs);
+            Time time = rowTime(batch, i);
+            if (hasPrevious) {
+                checkTimeOrder(previousTime, time, true);
+            }
+            previousTime = time;
+            hasPrevious = true;
+            bool verdict = do_verify::run_evaluation(program, holder, time, inputs);
+            if (!verdict && !summary.violated) {
+                summary.violated = true;
+                summary.firstViolation = time;
+            }
+            if (verdicts != nullptr) {
+                verdict_writer::writeDiscrete(*verdicts, time, verdict);
+            }
+            db_interval_set::swapBuffers(holder);
+            summary.events++;
+            if (checkpointDue(checkpointing, summary.events)) {
+                checkpoint::Snapshot snapshot = snapshotOf(verdict_writer::VerdictMode::DISCRETE, fingerprint, summary, verdicts);
+                checkpoint::captureProgram(program, snapshot);
+                checkpoint::saveSnapshot(checkpointing->path, snapshot);
+            }
+        }
+    }
+    return summary;
+}
+
+TraceSummary runDense(const spec_compiler::CompiledSpec &spec, const InputSlots &slots, const RowSource &nextBatch,
+                      db_interval_set::IntervalSetHolder &holder, verdict_writer::VerdictWriter *verdicts,
+                      const Checkpointing *checkpointing) {
+    if (spec_compiler::needsDiscreteTime(spec)) {
+        throw std::invalid_argument("Specs with pre, rise, fall or delay need the discrete time model");
+    }
+    do_verify::DenseProgram program = spec_compiler::makeDenseProgram(spec, holder);
+    std::vector<bool> inputs(slots.size());
+    TraceSummary summary{0, false, 0};
+
+    // Each row holds until the next one starts. Its values are decoded as
+    // soon as it arrives, so only the open segment's start time and inputs
+    // are carried across batch boundaries and the batch buffer can be reused.
+    Time previousTime = 0;
+    bool hasPrevious = false;
+
+    const uint64_t fingerprint = checkpointing != nullptr ? checkpoint::specFingerprint(spec) : 0;
+    size_t skip = 0;
+    if (checkpointing != nullptr && checkpointing->resume != nullptr) {
+        const checkpoint::Snapshot &snapshot = *checkpointing->resume;
+        resumeFrom(snapshot, verdict_writer::VerdictMode::DENSE, fingerprint, summary, verdicts);
+        if (snapshot.hasPrevious && snapshot.previousInputs.size() != inputs.size()) {
+            throw checkpoint::CheckpointError("Checkpoint was taken with a different spec");
+        }
+        checkpoint::restoreProgram(program, holder, snapshot);
+        previousTime = snapshot.previousTime;
+        hasPrevious = snapshot.hasPrevious;
+        if (hasPrevious) {
+            inputs = snapshot.previousInputs;
+        }
+        skip = summary.events;
+    }
+
+    // A spec with future operators reports each time 'delay' late. The
+    // trace's first row is handed out on resume too, so it is always known.
+    const Time delay = spec.delay;
+    Time origin = 0;
+    bool hasOrigin = false;
+
+    // Evaluates the open segment [previousTime, endTime). The output lives
+    // in the holder, so it is used before swapping.
+    auto evaluateSegment = [&](Time endTime) {
+        auto output = do_verify::run_evaluation(program, holder, previousTime, endTime, inputs);
+        if (delay == 0) {
+            checkCoverage(summary, output, previousTime, endTime);
+        } else {
+            output = releaseDelayed(holder, output, delay, origin);
+            const Time releasedFrom = std::max(previousTime, do_verify::add_with_inf(origin, delay)) - delay;
+            checkCoverage(summary, output, releasedFrom, endTime - delay);
+        }
+        if (verdicts != nullptr) {
+            verdict_writer::writeDense(*verdicts, output);
+        }
+        db_interval_set::swapBuffers(holder);
+    };
+
+    // A row that repeats the inputs of the open segment only extends it, so
+    // the program steps once per input change rather than once per row.
+    // 'previousTime' is where the segment started and 'lastTime' the last
+    // row's time.
+    std::vector<bool> rowInputs(slots.size());
+    Time lastTime = previousTime;
+    for (binary_row_reader::RowBatch batch = nextBatch(); batch.count > 0; batch = nextBatch()) {
+        if (!hasOrigin) {
+            origin = rowTime(batch, 0);
+            hasOrigin = true;
+        }
+        const size_t first = skipRows(skip, batch);
+        if (first > 0) {
+            lastTime = rowTime(batch, first - 1);
+        }
+        for (size_t i = first; i < batch.count; i++) {
+            Time time = rowTime(batch, i);
+            if (hasPrevious) {
+                checkTimeOrder(lastTime, time, false);
+            }
+            fillInputs(batch.row(i), slots, rowInputs);
+            if (!hasPrevious || rowInputs != inputs) {
+                if (hasPrevious) {
+                    evaluateSegment(time);
+                }
+                inputs.swap(rowInputs);
+                previousTime = time;
+                hasPrevious = true;
+            }
+            lastTime = time;
+            summary.events++;
+            if (checkpointDue(checkpointing, summary.events)) {
+                checkpoint::Snapshot snapshot = snapshotOf(verdict_writer::VerdictMode::DENSE, fingerprint, summary, verdicts);
+                snapshot.previousTime = previousTime;
+                snapshot.hasPrevious = hasPrevious;
+                snapshot.previousInputs = inputs;
+                checkpoint::captureProgram(program, snapshot);
+                checkpoint::saveSnapshot(checkpointing->path, snapshot);
+            }
+        }
+    }
+    // The last row ends the trace, so the segment still open runs up to it
+    if (hasPrevious && lastTime > previousTime) {
+        evaluateSegment(lastTime);
+    }
+    return summary;
+}
+
+std::vector<std::string> expandTracePaths(const std::vector<std::string> &paths) {
+    std::vector<std::string> expanded;
+    for (const std::string &path : paths) {
+        std::error_code error;
+        if (!std::filesystem::is_directory(path, error)) {
+            expanded.push_back(path);
+            continue;
+        }
+        std::vector<std::string> files;
+        for (const auto &entry : std::filesystem::directory_iterator(path, error)) {
+            if (entry.is_regular_file(error)) {
+                files.push_back(entry.path().string());
+            }
+        }
+        std::sort(files.begin(), files.end());
+        expanded.insert(expanded.end(), files.begin(), files.end());
+    }
+    return expanded;
+}
+
+std::vector<TraceReport> monitorTraces(const spec_compiler::CompiledSpec &spec, const std::vector<std::string> &paths,
+                                       bool discrete, unsigned int threads) {
+    std::vector<TraceReport> reports(paths.size());
+    if (threads == 0) {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    threads = static_cast<unsigned int>(std::max<size_t>(1, std::min<size_t>(threads, paths.size())));
+
+    std::vector<WorkQueue> queues(threads);
+    for (size_t i = 0; i < paths.size(); i++) {
+        queues[i % threads].items.push_back(i);
+    }
+
+    auto worker = [&](unsigned int self) {
+        db_interval_set::IntervalSetHolder holder = db_interval_set::newHolder(spec_compiler::holderSizeHint(spec));
+        while (true) {
+            size_t item;
+            bool found = takeOwn(queues[self], item);
+            // No work is added once started, so finding every queue empty
+            // means this worker is done.
+            for (unsigned int k = 1; !found && k < threads; k++) {
+                found = steal(queues[(self + k) % threads], item);
+            }
+            if (!found) break;
+            reports[item] = monitorPath(spec, paths[item], discrete, holder);
+        }
+        db_interval_set::destroyHolder(holder);
+    };
+
+    std::vector<std::thread> pool;
+    for (unsigned int t = 1; t < threads; t++) {
+        pool.emplace_back(worker, t);
+    }
+    worker(0);
+    for (std::thread &thread : pool) {
+        thread.join();
+    }
+    return reports;
+}
+
+void writeReport(std::ostream &out, const std::vector<TraceReport> &reports) {
+    size_t satisfied = 0, violated = 0, failed = 0, events = 0;
+    out << "# trace\tevents\tverdict\tfirst_violation\n";
+    for (const TraceReport &report : reports) {
+        out << report.path << '\t';
+        if (!report.error.empty()) {
+            out << "-\terror\t" << report.error << '\n';
+            failed++;
+            continue;
+        }
+        events += report.summary.events;
+        out << report.summary.events << '\t';
+        if (report.summary.violated) {
+            out << "violated\t" << report.summary.firstViolation << '\n';
+            violated++;
+        } else {
+            out << "satisfied\t-\n";
+            satisfied++;
+        }
+    }
+    out << "# traces: " << reports.size() << ", satisfied: " << satisfied << ", violated: " << violated
+        << ", failed: " << failed << ", events: " << events << '\n';
+}
+
+} // namespace monitor
@@ -0,0 +1,585 @@
+#include "do-verify/spec_compiler.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <limits>
+#include <map>
+#include <unordered_map>
+#include <utility>
+
+namespace spec_compiler {
+
+using do_verify::NodeType;
+using db_interval_set::Time;
+
+SpecParseError::SpecParseError(const std::string &message, size_t position)
+    : std::runtime_error(message + " at position " + std::to_string(position)), position(position) {}
+
+namespace {
+
+bool isIdentifierChar(char c) {
+    return std::isalnum(static_cast<unsigned char>(c)) || c == '_';
+}
+
+// Recursive descent parser over the raw spec string. Every parseX function
+// returns the index of the FormulaNode it created.
+struct Parser {
+    const std::string &text;
+    size_t pos;
+    Formula formula;
+
+    void skipWhitespace() {
+        while (pos < text.size() && std::isspace(static_cast<unsigned char>(text[pos]))) {
+            pos++;
+        }
+    }
+
+    bool acceptSymbol(const char *symbol) {
+        skipWhitespace();
+        size_t length = std::char_traits<char>::length(symbol);
+        if (text.compare(pos, length, symbol) == 0) {
+            pos += length;
+            return true;
+        }
+        return false;
+    }
+
+    bool acceptKeyword(const char *keyword) {
+        skipWhitespace();
+        size_t length = std::char_traits<char>::length(keyword);
+        if (text.compare(pos, length, keyword) == 0 &&
+            (pos + length >= text.size() || !isIdentifierChar(text[pos + length]))) {
+            pos += length;
+            return true;
+        }
+        return false;
+    }
+
+    void expectSymbol(const char *symbol) {
+        if (!acceptSymbol(symbol)) {
+            throw SpecParseError(std::string("Expected '") + symbol + "'", pos);
+        }
+    }
+
+    int addNode(NodeType type, int left, int right, Time a, Time b, std::string name = "") {
+        formula.nodes.push_back(FormulaNode{type, std::move(name), left, right, a, b});
+        return static_cast<int>(formula.nodes.size()) - 1;
+    }
+
+    bool parseNumber(Time &value) {
+        skipWhitespace();
+        size_t start = pos;
+        Time parsed = 0;
+        while (pos < text.size() && std::isdigit(static_cast<unsigned char>(text[pos]))) {
+            // B_INFINITY itself is reserved for an open upper bound
+            if (parsed > (B_INFINITY - 1 - (text[pos] - '0')) / 10) {
+                throw SpecParseError("Bound is too large", start);
+            }
+            parsed = parsed * 10 + (text[pos] - '0');
+            pos++;
+        }
+        value = parsed;
+        return pos != start;
+    }
+
+    // bound := '[' int? ':' int? ']'   (optional, defaults to [0:inf))
+    void parseBound(Time &a, Time &b) {
+        a = 0;
+        b = B_INFINITY;
+        if (!acceptSymbol("[")) {
+            return;
+        }
+        size_t boundStart = pos;
+        parseNumber(a);
+        expectSymbol(":");
+        Time upper;
+        if (parseNumber(upper)) {
+            b = upper;
+        }
+        expectSymbol("]");
+        if (a > b) {
+            throw SpecParseError("Empty bound: lower bound exceeds upper bound", boundStart);
+        }
+    }
+
+    // implies := disjunct ( '->' implies )?
+    int parseImplies() {
+        int left = parseDisjunct();
+        if (acceptSymbol("->") || acceptKeyword("implies")) {
+            int right = parseImplies();
+            return addNode(NodeType::IMPLIES, left, right, 0, 0);
+        }
+        return left;
+    }
+
+    // disjunct := conjunct ( ('or' | '||') conjunct )*
+    int parseDisjunct() {
+        int left = parseConjunct();
+        while (acceptSymbol("||") || acceptKeyword("or")) {
+            int right = parseConjunct();
+            left = addNode(NodeType::OR, left, right, 0, 0);
+        }
+        return left;
+    }
+
+    // conjunct := since ( ('and' | '&&') since )*
+    int parseConjunct() {
+        int left = parseSince();
+        while (acceptSymbol("&&") || acceptKeyword("and")) {
+            int right = parseSince();
+            left = addNode(NodeType::AND, left, right, 0, 0);
+        }
+        return left;
+    }
+
+    // A future operator's verdicts wait for its upper bound to pass, so it
+    // has to be finite
+    void parseFutureBound(Time &a, Time &b) {
+        size_t boundStart = pos;
+        parseBound(a, b);
+        if (b == B_INFINITY) {
+            throw SpecParseError("Future operators need a finite upper bound", boundStart);
+        }
+    }
+
+    // since := unary ( ('since' bound | 'until' future_bound) unary )*
+    int parseSince() {
+        int left = parseUnary();
+        while (true) {
+            Time a, b;
+            NodeType type;
+            if (acceptKeyword("since")) {
+                parseBound(a, b);
+                type = NodeType::SINCE;
+            } else if (acceptKeyword("until")) {
+                parseFutureBound(a, b);
+                type = NodeType::UNTIL;
+            } else {
+                return left;
+            }
+            int right = parseUnary();
+            left = addNode(type, left, right, a, b);
+        }
+    }
+
+    // Number of steps in 'delay[k]', k >= 1. The ring keeps k bits.
+    Time parseSteps() {
+        expectSymbol("[");
+        size_t stepsStart = pos;
+        Time steps;
+        if (!parseNumber(steps)) {
+            throw SpecParseError("Expected a number of steps", pos);
+        }
+        if (steps < 1 || static_cast<uint64_t>(steps) > std::numeric_limits<unsigned int>::max()) {
+            throw SpecParseError("A delay must be from 1 to " + std::to_string(std::numeric_limits<unsigned int>::max()) +
+                                 " steps", stepsStart);
+        }
+        expectSymbol("]");
+        return steps;
+    }
+
+    // unary := ('not' | '!') unary
+    //        | ('pre' | 'rise' | 'fall') unary
+    //        | 'delay' '[' int ']' unary
+    //        | ('once' | 'historically') bound unary
+    //        | ('eventually' | 'always') future_bound unary
+    //        | '(' implies ')'
+    //        | '{' name '}'
+    int parseUnary() {
+        if (acceptKeyword("not") || acceptSymbol("!")) {
+            int operand = parseUnary();
+            return addNode(NodeType::NOT, -1, operand, 0, 0);
+        }
+        if (acceptKeyword("pre")) {
+            int operand = parseUnary();
+            return addNode(NodeType::PREVIOUS, -1, operand, 1, 1);
+        }
+        if (acceptKeyword("rise")) {
+            int operand = parseUnary();
+            return addNode(NodeType::RISE, -1, operand, 1, 1);
+        }
+        if (acceptKeyword("fall")) {
+            int operand = parseUnary();
+            return addNode(NodeType::FALL, -1, operand, 1, 1);
+        }
+        if (acceptKeyword("delay")) {
+            Time steps = parseSteps();
+            int operand = parseUnary();
+            return addNode(NodeType::DELAY, -1, operand, steps, steps);
+        }
+        if (acceptKeyword("once")) {
+            Time a, b;
+            parseBound(a, b);
+            int operand = parseUnary();
+            return addNode(NodeType::EVENTUALLY, -1, operand, a, b);
+        }
+        if (acceptKeyword("historically")) {
+            Time a, b;
+            parseBound(a, b);
+            int operand = parseUnary();
+            return addNode(NodeType::ALWAYS, -1, operand, a, b);
+        }
+        if (acceptKeyword("eventually")) {
+            Time a, b;
+            parseFutureBound(a, b);
+            int operand = parseUnary();
+            return addNode(NodeType::FUTURE_EVENTUALLY, -1, operand, a, b);
+        }
+        if (acceptKeyword("always")) {
+            Time a, b;
+            parseFutureBound(a, b);
+            int operand = parseUnary();
+            return addNode(NodeType::FUTURE_ALWAYS, -1, operand, a, b);
+        }
+        if (acceptSymbol("(")) {
+            int inner = parseImplies();
+            expectSymbol(")");
+            return inner;
+        }
+        if (acceptSymbol("{")) {
+            skipWhitespace();
+            size_t start = pos;
+            while (pos < text.size() && isIdentifierChar(text[pos])) {
+                pos++;
+            }
+            if (pos == start) {
+                throw SpecParseError("Expected a proposition name", pos);
+            }
+            std::string name = text.substr(start, pos - start);
+            expectSymbol("}");
+            return addNode(NodeType::PROPOSITION, -1, -1, 0, 0, name);
+        }
+        skipWhitespace();
+        if (pos >= text.size()) {
+            throw SpecParseError("Unexpected end of spec", pos);
+        }
+        throw SpecParseError(std::string("Unexpected character '") + text[pos] + "'", pos);
+    }
+};
+
+// Structural identity of a lowered node. Two formula subtrees with the same
+// key compute the same output, so they can share one node.
+struct NodeKey {
+    NodeType type;
+    unsigned int left;
+    unsigned int right;
+    Time a;
+    Time b;
+
+    bool operator==(const NodeKey &other) const {
+        return type == other.type && left == other.left && right == other.right && a == other.a && b == other.b;
+    }
+};
+
+struct NodeKeyHash {
+    size_t operator()(const NodeKey &key) const {
+        size_t h = static_cast<size_t>(key.type);
+        for (size_t part : {static_cast<size_t>(key.left), static_cast<size_t>(key.right),
+                            static_cast<size_t>(key.a), static_cast<size_t>(key.b)}) {
+            h ^= part + 0x9e3779b97f4a7c15ULL + (h << 6) + (h >> 2);
+        }
+        return h;
+    }
+};
+
+// Future operators are evaluated over delayed timelines: a node with delay
+// d outputs at t what its formula says about t - d. eventually[a:b] p at t
+// is once[0:b-a] p at t + b, so it is that once b later than p, and always
+// likewise. Past operators keep their operand's delay, the connectives and
+// since delay the less delayed operand by once[k:k] to line both up, and
+// until is evaluated b late by its own kernel.
+struct Lowering {
+    const Formula &formula;
+    std::vector<int> lowered; // FormulaNode index -> SpecNode index, -1 if not yet lowered
+    std::unordered_map<NodeKey, unsigned int, NodeKeyHash> existing;
+    std::vector<Time> delays; // Per SpecNode
+    CompiledSpec out;
+
+    // Appends a node unless an identical one was already appended.
+    unsigned int addNode(NodeType type, unsigned int left, unsigned int right, Time a, Time b, Time delay) {
+        NodeKey key{type, left, right, a, b};
+        if ((type == NodeType::AND || type == NodeType::OR) && key.left > key.right) {
+            std::swap(key.left, key.right); // Commutative, so {p} && {q} shares with {q} && {p}
+        }
+        auto found = existing.find(key);
+        if (found == existing.end()) {
+            out.nodes.push_back(SpecNode{type, left, right, a, b});
+            delays.push_back(delay);
+            found = existing.emplace(key, static_cast<unsigned int>(out.nodes.size()) - 1).first;
+        }
+        return found->second;
+    }
+
+    Time addDelays(Time a, Time b) {
+        Time sum = do_verify::add_with_inf(a, b);
+        if (sum == B_INFINITY) {
+            throw SpecParseError("Future operators reach past the largest time", 0);
+        }
+        return sum;
+    }
+
+    // 'node' as seen 'by' time units later
+    unsigned int delayed(unsigned int node, Time by) {
+        return by == 0 ? node : addNode(NodeType::EVENTUALLY, 0, node, by, by, addDelays(delays[node], by));
+    }
+
+    void align(unsigned int &left, unsigned int &right) {
+        const Time delay = std::max(delays[left], delays[right]);
+        left = delayed(left, delay - delays[left]);
+        right = delayed(right, delay - delays[right]);
+    }
+
+    // A delayed node's first 'delay' time units speak about times before
+    // the trace. Past operators must not look at them, so over those units
+    // once sees its operand false and historically sees it true.
+    // once[delay:]({p} -> {p}) marks where the operand's own times begin.
+    unsigned int masked(unsigned int node, bool forAlways) {
+        const Time delay = delays[node];
+        if (delay == 0) {
+            return node;
+        }
+        const unsigned int always = addNode(NodeType::IMPLIES, 0, 0, 0, 0, 0); // Node 0 is a proposition
+        const unsigned int begun = addNode(NodeType::EVENTUALLY, 0, always, delay, B_INFINITY, 0);
+        return forAlways ? addNode(NodeType::IMPLIES, begun, node, 0, 0, delay)
+                         : addNode(NodeType::AND, node, begun, 0, 0, delay);
+    }
+
+    // Appends the non-proposition nodes of the subtree in post-order,
+    // reusing an existing node when an identical subtree was already lowered.
+    unsigned int lowerNode(int index) {
+        if (lowered[index] >= 0) {
+            return static_cast<unsigned int>(lowered[index]);
+        }
+        const FormulaNode &node = formula.nodes[index];
+        unsigned int left = node.left >= 0 ? lowerNode(node.left) : 0;
+        unsigned int right = node.right >= 0 ? lowerNode(node.right) : 0;
+
+        unsigned int result;
+        switch (node.type) {
+        case NodeType::FUTURE_EVENTUALLY:
+        case NodeType::FUTURE_ALWAYS:
+            result = addNode(node.type == NodeType::FUTURE_EVENTUALLY ? NodeType::EVENTUALLY : NodeType::ALWAYS,
+                             0, right, 0, node.b - node.a, addDelays(delays[right], node.b));
+            break;
+        case NodeType::UNTIL:
+            align(left, right);
+            result = addNode(NodeType::UNTIL, left, right, node.a, node.b, addDelays(delays[right], node.b));
+            break;
+        case NodeType::EVENTUALLY:
+        case NodeType::ALWAYS:
+            right = masked(right, node.type == NodeType::ALWAYS);
+            result = addNode(node.type, 0, right, node.a, node.b, delays[right]);
+            break;
+        case NodeType::SINCE:
+            align(left, right);
+            right = masked(right, false);
+            result = addNode(NodeType::SINCE, left, right, node.a, node.b, delays[right]);
+            break;
+        case NodeType::NOT:
+        case NodeType::PREVIOUS:
+        case NodeType::RISE:
+        case NodeType::FALL:
+        case NodeType::DELAY:
+            result = addNode(node.type, 0, right, node.a, node.b, delays[right]);
+            break;
+        default:
+            align(left, right);
+            result = addNode(node.type, left, right, node.a, node.b, delays[right]);
+            break;
+        }
+        lowered[index] = static_cast<int>(result);
+        return result;
+    }
+};
+
+bool isStepOperator(NodeType type) {
+    return type == NodeType::PREVIOUS || type == NodeType::RISE || type == NodeType::FALL || type == NodeType::DELAY;
+}
+
+// Windows grow when full, so wide bounds over sparse traces don't reserve
+// their worst case up front.
+unsigned int initialWindowCapacity(const SpecNode &node) {
+    return std::min(do_verify::discreteWindowCapacity(node.a, node.b), 1024u);
+}
+
+} // namespace
+
+Formula parse(const std::string &spec) {
+    Parser parser{spec, 0, {}};
+    parser.formula.root = parser.parseImplies();
+    parser.skipWhitespace();
+    if (parser.pos != spec.size()) {
+        throw SpecParseError(std::string("Unexpected character '") + spec[parser.pos] + "'", parser.pos);
+    }
+    return parser.formula;
+}
+
+CompiledSpec lower(const Formula &formula) {
+    Lowering lowering{formula, std::vector<int>(formula.nodes.size(), -1), {}, {}, {}};
+    CompiledSpec &out = lowering.out;
+
+    // Propositions go first, in order of first appearance, one node per name.
+    std::map<std::string, int> propositionIndex;
+    for (size_t i = 0; i < formula.nodes.size(); i++) {
+        const FormulaNode &node = formula.nodes[i];
+        if (node.type != NodeType::PROPOSITION) continue;
+        auto found = propositionIndex.find(node.name);
+        if (found == propositionIndex.end()) {
+            out.nodes.push_back(SpecNode{NodeType::PROPOSITION, 0, 0, 0, 0});
+            out.propositions.push_back(node.name);
+            lowering.delays.push_back(0);
+            found = propositionIndex.emplace(node.name, static_cast<int>(out.nodes.size()) - 1).first;
+        }
+        lowering.lowered[i] = found->second;
+    }
+
+    // The root can never equal one of its own subtrees, so it is always
+    // appended last, where run_evaluation reads the verdict from.
+    lowering.lowerNode(formula.root);
+    out.delay = lowering.delays.back();
+    return out;
+}
+
+CompiledSpec compile(const std::string &spec) {
+    return lower(parse(spec));
+}
+
+bool needsDenseTime(const CompiledSpec &spec) {
+    return spec.delay > 0 || std::any_of(spec.nodes.begin(), spec.nodes.end(),
+                                         [](const SpecNode &node) { return node.type == NodeType::UNTIL; });
+}
+
+bool needsDiscreteTime(const CompiledSpec &spec) {
+    return std::any_of(spec.nodes.begin(), spec.nodes.end(), [](const SpecNode &node) { return isStepOperator(node.type); });
+}
+
+int holderSizeHint(const CompiledSpec &spec) {
+    int size = 0;
+    for (const SpecNode &node : spec.nodes) {
+        switch (node.type) {
+        case NodeType::EVENTUALLY:
+        case NodeType::ALWAYS:
+        case NodeType::SINCE:
+            size += 64;
+            break;
+        default:
+            size += 8;
+            break;
+        }
+    }
+    // Round up to a power of two, the holder doubles from there
+    int rounded = 64;
+    while (rounded < size) {
+        rounded *= 2;
+    }
+    return rounded;
+}
+
+std::vector<do_verify::DenseNode> makeDenseNodes(const CompiledSpec &spec, db_interval_set::IntervalSetHolder &holder) {
+    std::vector<do_verify::DenseNode> nodes;
+    nodes.reserve(spec.nodes.size());
+    for (const SpecNode &node : spec.nodes) {
+        do_verify::DenseNode dense{db_interval_set::empty(holder), db_interval_set::empty(holder), node.type,
+            node.leftOperandIndex, node.rightOperandIndex, node.a, node.b, {}};
+        // once/historically states only grow at the back and expire at the
+        // front, which the window does without sweeping the whole state.
+        if (node.type == NodeType::EVENTUALLY || node.type == NodeType::ALWAYS) {
+            dense.type = node.type == NodeType::EVENTUALLY ? NodeType::EVENTUALLY_WINDOW : NodeType::ALWAYS_WINDOW;
+            dense.window = do_verify::newWindow(initialWindowCapacity(node));
+        }
+        if (node.type == NodeType::UNTIL) {
+            dense.window = do_verify::newWindow(initialWindowCapacity(node));
+        }
+        nodes.push_back(std::move(dense));
+    }
+    return nodes;
+}
+
+std::vector<do_verify::DiscreteNode> makeDiscreteNodes(const CompiledSpec &spec, db_interval_set::IntervalSetHolder &holder) {
+    std::vector<do_verify::DiscreteNode> nodes;
+    nodes.reserve(spec.nodes.size());
+    for (const SpecNode &node : spec.nodes) {
+        do_verify::DiscreteNode discrete{db_interval_set::empty(holder), false, node.type,
+            node.leftOperandIndex, node.rightOperandIndex, node.a, node.b, {}, {}};
+        // With integer time, once/historically only need the sliding window
+        // of shifted intervals, which gives an O(1), allocation-free step.
+        if (node.type == NodeType::EVENTUALLY || node.type == NodeType::ALWAYS) {
+            discrete.type = node.type == NodeType::EVENTUALLY ? NodeType::EVENTUALLY_WINDOW : NodeType::ALWAYS_WINDOW;
+            discrete.window = do_verify::newWindow(initialWindowCapacity(node));
+        }
+        if (isStepOperator(node.type)) {
+            discrete.ring = do_verify::newBitRing(static_cast<unsigned int>(node.a));
+        }
+        nodes.push_back(std::move(discrete));
+    }
+    return nodes;
+}
+
+do_verify::DenseProgram makeDenseProgram(const CompiledSpec &spec, db_interval_set::IntervalSetHolder &holder) {
+    do_verify::DenseProgram program = do_verify::newDenseProgram(spec.nodes.size(), holder);
+    for (size_t i = 0; i < spec.nodes.size(); i++) {
+        const SpecNode &node = spec.nodes[i];
+        program.opcodes[i] = node.type;
+        program.leftOperands[i] = node.leftOperandIndex;
+        program.rightOperands[i] = node.rightOperandIndex;
+        program.lowerBounds[i] = node.a;
+        program.upperBounds[i] = node.b;
+        if (node.type == NodeType::EVENTUALLY || node.type == NodeType::ALWAYS) {
+            program.opcodes[i] = node.type == NodeType::EVENTUALLY ? NodeType::EVENTUALLY_WINDOW : NodeType::ALWAYS_WINDOW;
+            program.windows[i] = do_verify::newWindow(initialWindowCapacity(node));
+        }
+        if (node.type == NodeType::UNTIL) {
+            program.windows[i] = do_verify::newWindow(initialWindowCapacity(node));
+        }
+    }
+    return program;
+}
+
+do_verify::DiscreteProgram makeDiscreteProgram(const CompiledSpec &spec, db_interval_set::IntervalSetHolder &holder) {
+    do_verify::DiscreteProgram program = do_verify::newDiscreteProgram(spec.nodes.size(), holder);
+    for (size_t i = 0; i < spec.nodes.size(); i++) {
+        const SpecNode &node = spec.nodes[i];
+        program.opcodes[i] = node.type;
+        program.leftOperands[i] = node.leftOperandIndex;
+        program.rightOperands[i] = node.rightOperandIndex;
+        program.lowerBounds[i] = node.a;
+        program.upperBounds[i] = node.b;
+        if (node.type == NodeType::EVENTUALLY || node.type == NodeType::ALWAYS) {
+            program.opcodes[i] = node.type == NodeType::EVENTUALLY ? NodeType::EVENTUALLY_WINDOW : NodeType::ALWAYS_WINDOW;
+            program.windows[i] = do_verify::newWindow(initialWindowCapacity(node));
+        }
+        if (isStepOperator(node.type)) {
+            program.rings[i] = do_verify::newBitRing(static_cast<unsigned int>(node.a));
+        }
+    }
+    return program;
+}
+
+do_verify::LaneProgram makeLaneProgram(const CompiledSpec &spec) {
+    do_verify::LaneProgram program = do_verify::newLaneProgram(spec.nodes.size());
+    for (size_t i = 0; i < spec.nodes.size(); i++) {
+        const SpecNode &node = spec.nodes[i];
+        program.opcodes[i] = node.type;
+        program.leftOperands[i] = node.leftOperandIndex;
+        program.rightOperands[i] = node.rightOperandIndex;
+        program.lowerBounds[i] = node.a;
+        program.upperBounds[i] = node.b;
+    }
+    return program;
+}
+
+do_verify::BlockProgram makeBlockProgram(const CompiledSpec &spec) {
+    do_verify::BlockProgram program = do_verify::newBlockProgram(spec.nodes.size());
+    for (size_t i = 0; i < spec.nodes.size(); i++) {
+        const SpecNode &node = spec.nodes[i];
+        program.opcodes[i] = node.type;
+        program.leftOperands[i] = node.leftOperandIndex;
+        program.rightOperands[i] = node.rightOperandIndex;
+        program.lowerBounds[i] = node.a;
+        program.upperBounds[i] = node.b;
+    }
+    do_verify::resetBlockStates(program);
+    return program;
+}
+
+} // namespace spec_compiler
@@ -0,0 +1,140 @@
+#include "do-verify/verdict_writer.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <unistd.h>
+
+namespace verdict_writer {
+
+namespace {
+
+// Large enough for any single record in either format
+constexpr size_t MAX_RECORD_BYTES = 64;
+
+void flush(VerdictWriter &writer) {
+    size_t written = 0;
+    while (!writer.failed && written < writer.used) {
+        ssize_t count = write(writer.fd, writer.buffer.data() + written, writer.used - written);
+        if (count < 0) {
+            if (errno == EINTR) continue;
+            writer.failed = true;
+            break;
+        }
+        written += static_cast<size_t>(count);
+    }
+    writer.used = 0;
+}
+
+char *reserve(VerdictWriter &writer, size_t bytes) {
+    if (writer.used + bytes > writer.buffer.size()) {
+        flush(writer);
+    }
+    return writer.buffer.data() + writer.used;
+}
+
+template <typename T>
+void append(VerdictWriter &writer, const T &value) {
+    char *out = reserve(writer, sizeof(value));
+    std::memcpy(out, &value, sizeof(value));
+    writer.used += sizeof(value);
+}
+
+void emitRun(VerdictWriter &writer) {
+    if (writer.format == VerdictFormat::BINARY) {
+        append(writer, writer.runStart);
+        append(writer, writer.runEnd);
+        if (writer.mode == VerdictMode::DISCRETE) {
+            append(writer, static_cast<uint8_t>(writer.runValue));
+        }
+        return;
+    }
+
+    char *out = reserve(writer, MAX_RECORD_BYTES);
+    int length;
+    if (writer.mode == VerdictMode::DENSE) {
+        length = std::snprintf(out, MAX_RECORD_BYTES, "[%lld, %lld)\n", static_cast<long long>(writer.runStart),
+                               static_cast<long long>(writer.runEnd));
+    } else {
+        length = std::snprintf(out, MAX_RECORD_BYTES, "[%lld, %lld] %s\n", static_cast<long long>(writer.runStart),
+                               static_cast<long long>(writer.runEnd), writer.runValue ? "true" : "false");
+    }
+    writer.used += static_cast<size_t>(length);
+}
+
+void extendDense(VerdictWriter &writer, db_interval_set::Time start, db_interval_set::Time end) {
+    if (start >= end) {
+        return;
+    }
+    if (writer.hasRun && start <= writer.runEnd) {
+        writer.runEnd = std::max(writer.runEnd, end);
+        return;
+    }
+    if (writer.hasRun) {
+        emitRun(writer);
+    }
+    writer.hasRun = true;
+    writer.runStart = start;
+    writer.runEnd = end;
+}
+
+} // namespace
+
+VerdictWriter newVerdictWriter(int fd, VerdictFormat format, VerdictMode mode, size_t bufferBytes) {
+    VerdictWriter writer{fd, format, mode, std::vector<char>(std::max(bufferBytes, MAX_RECORD_BYTES)), 0,
+                         false, 0, 0, false, false};
+    if (format == VerdictFormat::BINARY) {
+        char *out = reserve(writer, sizeof(VERDICT_MAGIC));
+        std::memcpy(out, VERDICT_MAGIC, sizeof(VERDICT_MAGIC));
+        writer.used += sizeof(VERDICT_MAGIC);
+        append(writer, sizeof(db_interval_set::Time) == sizeof(int64_t) ? VERDICT_VERSION_TIME64 : VERDICT_VERSION);
+        append(writer, static_cast<uint16_t>(mode));
+    }
+    return writer;
+}
+
+VerdictWriter continueVerdictWriter(int fd, VerdictFormat format, VerdictMode mode, size_t bufferBytes) {
+    return VerdictWriter{fd, format, mode, std::vector<char>(std::max(bufferBytes, MAX_RECORD_BYTES)), 0,
+                         false, 0, 0, false, false};
+}
+
+void writeDense(VerdictWriter &writer, const db_interval_set::IntervalSet &output) {
+    db_interval_set::Time start = 0;
+    for (int i = output.startIndex; i <= output.endIndex; i++) {
+        const db_interval_set::Transition &t = output.buffer[i];
+        if (t.isStart) {
+            start = t.time;
+        } else {
+            extendDense(writer, start, t.time);
+        }
+    }
+}
+
+void writeDiscrete(VerdictWriter &writer, db_interval_set::Time time, bool verdict) {
+    if (writer.hasRun && writer.runValue == verdict) {
+        writer.runEnd = time;
+        return;
+    }
+    if (writer.hasRun) {
+        emitRun(writer);
+    }
+    writer.hasRun = true;
+    writer.runStart = time;
+    writer.runEnd = time;
+    writer.runValue = verdict;
+}
+
+void flushVerdicts(VerdictWriter &writer) {
+    flush(writer);
+}
+
+void finishVerdicts(VerdictWriter &writer) {
+    if (writer.hasRun) {
+        emitRun(writer);
+        writer.hasRun = false;
+    }
+    flush(writer);
+}
+
+} // namespace verdict_writer
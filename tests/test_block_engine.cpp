@@ -0,0 +1,60 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/catch_all.hpp>
+
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+#include "do-verify/block_engine.hpp"
+#include "do-verify/spec_compiler.hpp"
+
+using namespace do_verify;
+
+TEST_CASE("Block Discrete Evaluation", "[block_engine]") {
+    using namespace db_interval_set;
+
+    auto spec_text = GENERATE(as<std::string>{},
+        "historically(({r} && !{q} && once{q}) -> ({p} since[3:40] {q}))",
+        "({p} since[0:5] {q}) || once[2:6]{r}",
+        "historically[:10]{p} -> once[1:20]{q}",
+        "{p} since {q}",
+        "{p} since[4:] {q}",
+        "once[70:200]{p} && historically[64:64]{q}",
+        "once[3:]{p} && historically[2:7]{q} && once[:100]{r}",
+        "rise{p} -> once[1:5] fall{q}",
+        "delay[70]{p} || (pre{q} && !{r})");
+
+    SECTION("Columns match the scalar engine step by step") {
+        spec_compiler::CompiledSpec spec = spec_compiler::compile(spec_text);
+        BlockProgram block = spec_compiler::makeBlockProgram(spec);
+
+        IntervalSetHolder holder = newHolder(spec_compiler::holderSizeHint(spec));
+        std::vector<DiscreteNode> scalar = spec_compiler::makeDiscreteNodes(spec, holder);
+
+        // 20 full blocks and a partial one
+        const int STEPS = 64 * 20 + 37;
+        std::mt19937_64 rng(7);
+        bool allEqual = true;
+        for (int start = 0; start < STEPS; start += 64) {
+            unsigned int steps = static_cast<unsigned int>(std::min(64, STEPS - start));
+            std::vector<uint64_t> columns(spec.nodes.size(), 0);
+            for (size_t i = 0; i < spec.propositions.size(); i++) {
+                // Long runs of true keep since chains alive across blocks.
+                columns[i] = rng() | rng() | (start % 256 == 0 ? ~uint64_t(0) : 0);
+            }
+            uint64_t verdicts = run_evaluation(block, columns, steps);
+
+            for (unsigned int k = 0; k < steps; k++) {
+                std::vector<bool> inputs(spec.nodes.size(), false);
+                for (size_t i = 0; i < spec.propositions.size(); i++) {
+                    inputs[i] = (columns[i] >> k) & 1;
+                }
+                bool expected = run_evaluation(scalar, holder, start + static_cast<int>(k), inputs);
+                allEqual &= static_cast<bool>((verdicts >> k) & 1) == expected;
+                swapBuffers(holder);
+            }
+        }
+        destroyHolder(holder);
+        REQUIRE(allEqual);
+    }
+}
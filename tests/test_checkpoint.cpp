@@ -0,0 +1,157 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/catch_all.hpp>
+
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+#include <fcntl.h>
+#include <unistd.h>
+#include "do-verify/checkpoint.hpp"
+#include "do-verify/monitor.hpp"
+
+using namespace monitor;
+
+// Packed rows over {p, q, r} with a mix of short and long runs, at uneven
+// but increasing times
+static std::vector<char> makeRows(int rows) {
+    std::vector<char> bytes(rows * (sizeof(int32_t) + 1));
+    for (int i = 0; i < rows; i++) {
+        binary_row_reader::encodeRow(i * 5 + (i % 5), {i % 7 != 3, i % 11 < 2, i % 4 == 0},
+                                     bytes.data() + i * (sizeof(int32_t) + 1));
+    }
+    return bytes;
+}
+
+// Hands out 'rows' rows of 'bytes' in batches of 100
+static RowSource batchesOf(const std::vector<char> &bytes, size_t rows) {
+    size_t next = 0;
+    return [&bytes, rows, next]() mutable {
+        size_t count = std::min<size_t>(100, rows - next);
+        binary_row_reader::RowBatch batch{bytes.data() + next * (sizeof(int32_t) + 1), count, sizeof(int32_t) + 1};
+        next += count;
+        return batch;
+    };
+}
+
+// Runs the trace to its end, optionally stopping after 'stopRows' rows and
+// resuming from the last checkpoint. Returns the verdict text.
+static std::string monitorText(const spec_compiler::CompiledSpec &spec, bool discrete, const std::vector<char> &bytes,
+                               size_t rows, size_t stopRows, TraceSummary &summary) {
+    const std::string checkpointPath = "checkpoint_test.ckpt";
+    const std::string outputPath = "checkpoint_test.out";
+    InputSlots slots{{4, 1}, {4, 2}, {4, 4}};
+    auto mode = discrete ? verdict_writer::VerdictMode::DISCRETE : verdict_writer::VerdictMode::DENSE;
+
+    auto runOnce = [&](size_t available, const checkpoint::Snapshot *resume, int fd) {
+        auto writer = resume == nullptr
+            ? verdict_writer::newVerdictWriter(fd, verdict_writer::VerdictFormat::TEXT, mode, 256)
+            : verdict_writer::continueVerdictWriter(fd, verdict_writer::VerdictFormat::TEXT, mode, 256);
+        Checkpointing checkpointing{97, checkpointPath, resume};
+        db_interval_set::IntervalSetHolder holder = db_interval_set::newHolder(64);
+        summary = discrete ? runDiscrete(spec, slots, batchesOf(bytes, available), holder, &writer, &checkpointing)
+                           : runDense(spec, slots, batchesOf(bytes, available), holder, &writer, &checkpointing);
+        verdict_writer::finishVerdicts(writer);
+        db_interval_set::destroyHolder(holder);
+    };
+
+    int fd = open(outputPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    runOnce(stopRows, nullptr, fd);
+    close(fd);
+    if (stopRows < rows) {
+        // Whatever the first run wrote past its last checkpoint is dropped.
+        checkpoint::Snapshot snapshot = checkpoint::loadSnapshot(checkpointPath);
+        fd = open(outputPath.c_str(), O_WRONLY);
+        REQUIRE(ftruncate(fd, snapshot.outputOffset) == 0);
+        lseek(fd, snapshot.outputOffset, SEEK_SET);
+        runOnce(rows, &snapshot, fd);
+        close(fd);
+    }
+
+    std::ifstream input(outputPath);
+    std::string text((std::istreambuf_iterator<char>(input)), std::istreambuf_iterator<char>());
+    std::remove(outputPath.c_str());
+    std::remove(checkpointPath.c_str());
+    return text;
+}
+
+TEST_CASE("Checkpoints", "[checkpoint]") {
+
+    SECTION("Snapshots round-trip") {
+        checkpoint::Snapshot snapshot{};
+        snapshot.mode = 1;
+        snapshot.fingerprint = 0x1234567890ABCDEFull;
+        snapshot.rows = 42;
+        snapshot.violated = true;
+        snapshot.firstViolation = -7;
+        snapshot.previousInputs = {true, false, true};
+        snapshot.hasRun = true;
+        snapshot.runStart = 3;
+        snapshot.runEnd = 9;
+        snapshot.outputOffset = 1000;
+        snapshot.states = {{}, {{1, 4}, {6, B_INFINITY}}};
+        snapshot.windows = {{{2, 3}}, {}};
+
+        std::vector<char> bytes = checkpoint::encodeSnapshot(snapshot);
+        checkpoint::Snapshot decoded = checkpoint::decodeSnapshot(bytes.data(), bytes.size());
+        REQUIRE(decoded.fingerprint == snapshot.fingerprint);
+        REQUIRE(decoded.rows == 42);
+        REQUIRE(decoded.violated);
+        REQUIRE(decoded.firstViolation == -7);
+        REQUIRE(decoded.previousInputs == snapshot.previousInputs);
+        REQUIRE(decoded.runEnd == 9);
+        REQUIRE(decoded.outputOffset == 1000);
+        REQUIRE(decoded.states[1] == snapshot.states[1]);
+        REQUIRE(decoded.windows[0] == snapshot.windows[0]);
+
+        REQUIRE_THROWS_AS(checkpoint::decodeSnapshot(bytes.data(), bytes.size() - 3), checkpoint::CheckpointError);
+        bytes[0] = 'X';
+        REQUIRE_THROWS_AS(checkpoint::decodeSnapshot(bytes.data(), bytes.size()), checkpoint::CheckpointError);
+    }
+
+    SECTION("A resumed monitor matches an uninterrupted one") {
+        auto spec = spec_compiler::compile("historically(({r} && !{q} && once{q}) -> ({p} since[3:40] {q})) || once[2:9]{q}");
+        const size_t ROWS = 2000;
+        std::vector<char> bytes = makeRows(ROWS);
+
+        for (bool discrete : {true, false}) {
+            TraceSummary full;
+            TraceSummary resumed;
+            std::string expected = monitorText(spec, discrete, bytes, ROWS, ROWS, full);
+            std::string actual = monitorText(spec, discrete, bytes, ROWS, 1234, resumed);
+            REQUIRE(actual == expected);
+            REQUIRE(resumed.events == full.events);
+            REQUIRE(resumed.violated == full.violated);
+            REQUIRE(resumed.firstViolation == full.firstViolation);
+        }
+
+        // Delayed verdicts, with until's open left run and the verdicts it
+        // worked out ahead of time carried over
+        spec = spec_compiler::compile("historically({r} -> ({p} until[2:30] {q})) && always[1:7]{p}");
+        TraceSummary full;
+        TraceSummary resumed;
+        std::string expected = monitorText(spec, false, bytes, ROWS, ROWS, full);
+        REQUIRE(monitorText(spec, false, bytes, ROWS, 1234, resumed) == expected);
+        REQUIRE(resumed.firstViolation == full.firstViolation);
+
+        // Step operators carry their last rows over, here across a ring word
+        spec = spec_compiler::compile("delay[70]{p} || (rise{q} && !pre{r}) || fall{p}");
+        expected = monitorText(spec, true, bytes, ROWS, ROWS, full);
+        REQUIRE(monitorText(spec, true, bytes, ROWS, 1234, resumed) == expected);
+        REQUIRE(resumed.firstViolation == full.firstViolation);
+    }
+
+    SECTION("Mismatched specs are rejected") {
+        auto spec = spec_compiler::compile("once[:5]{p}");
+        checkpoint::Snapshot snapshot{};
+        snapshot.mode = static_cast<uint16_t>(verdict_writer::VerdictMode::DISCRETE);
+        snapshot.fingerprint = checkpoint::specFingerprint(spec_compiler::compile("once[:6]{p}"));
+        Checkpointing checkpointing{0, "", &snapshot};
+        InputSlots slots{{4, 1}};
+        db_interval_set::IntervalSetHolder holder = db_interval_set::newHolder(64);
+        RowSource none = []() { return binary_row_reader::RowBatch{nullptr, 0, 1}; };
+        REQUIRE_THROWS_AS(runDiscrete(spec, slots, none, holder, nullptr, &checkpointing), checkpoint::CheckpointError);
+        db_interval_set::destroyHolder(holder);
+    }
+}
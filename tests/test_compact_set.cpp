@@ -0,0 +1,116 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_all.hpp>
+
+#include <random>
+#include <vector>
+#include "do-verify/compact_set.hpp"
+#include "do-verify/MTLEngine.hpp"
+
+using namespace db_interval_set;
+
+// Random normalised set with gaps and lengths in [1, 20]
+static std::vector<Interval> randomIntervals(std::mt19937 &rng, int count, Time start) {
+    std::vector<Interval> intervals;
+    Time t = start;
+    for (int i = 0; i < count; i++) {
+        t += 1 + rng() % 20;
+        Time end = t + 1 + rng() % 20;
+        intervals.push_back({t, end});
+        t = end;
+    }
+    return intervals;
+}
+
+static CompactSet compactOf(const std::vector<Interval> &intervals) {
+    CompactSet set;
+    for (const Interval &interval : intervals) {
+        set.times.push_back(interval.start);
+        set.times.push_back(interval.end);
+    }
+    return set;
+}
+
+TEST_CASE("Compact Sets", "[interval_set][compact]") {
+    auto holder = newHolder(4096);
+
+    SECTION("Round trip through the holder") {
+        std::vector<Interval> intervals{{-5, 3}, {10, 20}, {21, 22}};
+        IntervalSet set = createSetFromIntervals(holder, intervals);
+        CompactSet compact = toCompactSet(set);
+        REQUIRE(compact.times == std::vector<Time>{-5, 3, 10, 20, 21, 22});
+        REQUIRE(toVectorIntervals(compact) == intervals);
+        REQUIRE(toVectorIntervals(fromCompactSet(holder, compact)) == intervals);
+
+        REQUIRE(includes(compact, -5) == true);
+        REQUIRE(includes(compact, 3) == false);
+        REQUIRE(includes(compact, 20) == false);
+        REQUIRE(includes(compact, 21) == true);
+        REQUIRE(includes(compact, 100) == false);
+    }
+
+    SECTION("Touching and shared endpoints") {
+        CompactSet a = compactOf({{0, 10}, {20, 30}});
+        CompactSet b = compactOf({{10, 20}, {30, 40}});
+        CompactSet out;
+        unionSets(a, b, out);
+        REQUIRE(toVectorIntervals(out) == std::vector<Interval>{{0, 40}});
+        intersectSets(a, b, out);
+        REQUIRE(out.times.empty());
+        intersectSets(a, a, out);
+        REQUIRE(out.times == a.times);
+        // One long interval cuts out more intervals than it has itself
+        intersectSets(compactOf({{-100, 100}}), compactOf({{0, 1}, {2, 3}, {4, 5}}), out);
+        REQUIRE(toVectorIntervals(out) == std::vector<Interval>{{0, 1}, {2, 3}, {4, 5}});
+        negateSet(a, {0, 30}, out);
+        REQUIRE(toVectorIntervals(out) == std::vector<Interval>{{10, 20}});
+        negateSet(a, {5, 5}, out);
+        REQUIRE(out.times.empty());
+        negateSet(CompactSet{}, {5, 8}, out);
+        REQUIRE(toVectorIntervals(out) == std::vector<Interval>{{5, 8}});
+    }
+
+    SECTION("Matches the transition sweeps") {
+        std::mt19937 rng(7);
+        bool allEqual = true;
+        CompactSet out;
+        for (int round = 0; round < 200; round++) {
+            holder.writeIndex = 0;
+            auto intervalsA = randomIntervals(rng, rng() % 40, -100);
+            auto intervalsB = randomIntervals(rng, rng() % 40, -100);
+            IntervalSet setA = createSetFromIntervals(holder, intervalsA);
+            IntervalSet setB = createSetFromIntervals(holder, intervalsB);
+            CompactSet a = compactOf(intervalsA);
+            CompactSet b = compactOf(intervalsB);
+            Interval domain{static_cast<Time>(-120 + rng() % 200), static_cast<Time>(100 + rng() % 400)};
+
+            unionSets(a, b, out);
+            allEqual &= toVectorIntervals(out) == toVectorIntervals(unionSets(holder, setA, setB));
+            intersectSets(a, b, out);
+            allEqual &= toVectorIntervals(out) == toVectorIntervals(intersectSets(holder, setA, setB));
+            negateSet(a, domain, out);
+            allEqual &= toVectorIntervals(out) == toVectorIntervals(negateSet(holder, setA, domain));
+        }
+        REQUIRE(allEqual == true);
+    }
+
+    SECTION("Packed sets") {
+        std::mt19937 rng(11);
+        CompactSet set = compactOf(randomIntervals(rng, 1000, -50));
+        set.times.push_back(set.times.back() + 100000);
+        set.times.push_back(B_INFINITY);
+        PackedSet packed = packSet(set);
+        REQUIRE(packed.count == set.times.size());
+        // Gaps up to 20 take one byte each
+        REQUIRE(packed.bytes.size() < set.times.size() + 16);
+
+        CompactSet unpacked;
+        unpackSet(packed, unpacked);
+        REQUIRE(unpacked.times == set.times);
+
+        unpackSet(packSet(CompactSet{}), unpacked);
+        REQUIRE(unpacked.times.empty());
+    }
+
+    destroyHolder(holder);
+}
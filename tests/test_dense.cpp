@@ -2,6 +2,9 @@
 #include <catch2/benchmark/catch_benchmark.hpp>
 #include <catch2/catch_all.hpp>
 
+#include <algorithm>
+#include <functional>
+#include <random>
 #include <string>
 #include <vector>
 #include <fstream>
@@ -11,6 +14,7 @@
 
 
 #include "do-verify/MTLEngine.hpp"
+#include "do-verify/spec_compiler.hpp"
 TEST_CASE("Dense Implementation tests", "[dense]") {
     using namespace std;
     using namespace do_verify;
@@ -57,6 +61,186 @@ TEST_CASE("Dense Implementation tests", "[dense]") {
 
 
 
+TEST_CASE("Dense bounds near the end of time", "[dense]") {
+    using namespace do_verify;
+    using namespace db_interval_set;
+
+    // once[5:100] shifts p past the largest Time, which has to saturate
+    // instead of wrapping around
+    const Time late = B_INFINITY - 20;
+    auto holder = newHolder(64);
+    std::vector<DenseNode> nodes;
+    nodes.push_back(DenseNode{empty(holder), createSetFromIntervals(holder, {{late, late + 5}}), NodeType::TEST, 0, 0, 0, 0});
+    nodes.push_back(DenseNode{empty(holder), empty(holder), NodeType::EVENTUALLY, 0, 0, 5, 100});
+
+    auto out = run_evaluation(nodes, holder, late, late + 10, {true});
+    REQUIRE(toVectorIntervals(out) == std::vector<Interval>{{late + 5, late + 10}});
+    REQUIRE(add_with_inf(late, 100) == B_INFINITY);
+    REQUIRE(add_with_inf(late, 5) == late + 5);
+    destroyHolder(holder);
+}
+
+TEST_CASE("Dense window kernels match the interval set kernels", "[dense]") {
+    using namespace do_verify;
+    using namespace db_interval_set;
+
+    // Operands with several intervals per step, and steps of irregular
+    // length so that windows expire mid-step too
+    std::vector<std::pair<Time, Time>> bounds = {{0, 0}, {0, 10}, {3, 10}, {10, 10}, {5, B_INFINITY}, {0, B_INFINITY}};
+    for (auto [a, b] : bounds) {
+        for (NodeType type : {NodeType::EVENTUALLY, NodeType::ALWAYS}) {
+            IntervalSetHolder holder = newHolder(1000);
+            NodeType windowType = type == NodeType::EVENTUALLY ? NodeType::EVENTUALLY_WINDOW : NodeType::ALWAYS_WINDOW;
+            std::vector<DenseNode> nodes;
+            nodes.push_back(DenseNode{empty(holder), empty(holder), NodeType::TEST, 0, 0, 0, 0});
+            nodes.push_back(DenseNode{empty(holder), empty(holder), type, 0, 0, a, b});
+            nodes.push_back(DenseNode{empty(holder), empty(holder), windowType, 0, 0, a, b, newWindow(1)});
+
+            std::mt19937 rng(3);
+            Time time = 0;
+            bool allCorrect = true;
+            for (int step = 0; step < 1000; step++) {
+                const Time next = time + 1 + rng() % 30;
+                std::vector<Interval> operand;
+                for (Time t = time; t < next; t += 1 + rng() % 4) {
+                    if (rng() % 2 == 0) {
+                        operand.push_back({t, std::min<Time>(t + 1 + rng() % 3, next)});
+                        t = operand.back().end;
+                    }
+                }
+                nodes[0].output = createSetFromIntervals(holder, operand);
+                run_evaluation(nodes, holder, time, next, {});
+                allCorrect &= toVectorIntervals(nodes[1].output) == toVectorIntervals(nodes[2].output);
+                swapBuffers(holder);
+                time = next;
+            }
+            destroyHolder(holder);
+            REQUIRE(allCorrect == true);
+        }
+    }
+}
+
+TEST_CASE("Dense future operators match a brute force reference", "[dense]") {
+    using namespace do_verify;
+    using namespace db_interval_set;
+
+    // Rows every 2 time units and even bounds, so every verdict changes on
+    // an even time and the odd times can be checked one by one.
+    const int rows = 300;
+    const int traceEnd = 2 * rows;
+    std::vector<bool> p(traceEnd), q(traceEnd);
+    std::mt19937 rng(5);
+    for (int i = 0; i < rows; i++) {
+        p[2 * i] = p[2 * i + 1] = rng() % 4 != 0;
+        q[2 * i] = q[2 * i + 1] = rng() % 3 == 0;
+    }
+    auto eventually = [&](int t, int a, int b) {
+        bool holds = false;
+        for (int s = t + a; s <= t + b; s++) holds |= s >= 0 && p[s];
+        return holds;
+    };
+    auto always = [&](int t, int a, int b) {
+        bool holds = true;
+        for (int s = t + a; s <= t + b; s++) holds &= s < 0 || p[s];
+        return holds;
+    };
+    // Checking whole time units is enough, since p and q only change on them
+    auto until = [&](int t, int a, int b) {
+        for (int s = t + a; s <= t + b; s++) {
+            bool leftHolds = true;
+            for (int u = t; u < s; u++) leftHolds &= p[u];
+            if (leftHolds && q[s]) return true;
+        }
+        return false;
+    };
+
+    std::vector<std::pair<std::string, std::function<bool(int)>>> specs = {
+        {"eventually[2:6]{p}", [&](int t) { return eventually(t, 2, 6); }},
+        {"always[0:4]{p}", [&](int t) { return always(t, 0, 4); }},
+        {"{p} until[2:6] {q}", [&](int t) { return until(t, 2, 6); }},
+        {"{p} until[0:4] {q}", [&](int t) { return until(t, 0, 4); }},
+        {"{p} until[4:4] {q}", [&](int t) { return until(t, 4, 4); }},
+        {"{q} && eventually[2:4]{p}", [&](int t) { return q[t] && eventually(t, 2, 4); }},
+        {"historically(eventually[0:4]{p})", [&](int t) {
+            bool holds = true;
+            for (int u = 0; u <= t; u++) holds &= eventually(u, 0, 4);
+            return holds;
+        }},
+        {"once[2:6] always[0:4]{p}", [&](int t) {
+            bool holds = false;
+            for (int u = std::max(t - 6, 0); u <= t - 2; u++) holds |= always(u, 0, 4);
+            return holds;
+        }},
+    };
+    for (const auto &[text, reference] : specs) {
+        auto spec = spec_compiler::compile(text);
+        IntervalSetHolder holder = newHolder(64);
+        auto nodes = spec_compiler::makeDenseNodes(spec, holder);
+        auto program = spec_compiler::makeDenseProgram(spec, holder);
+
+        std::vector<Interval> verdicts;
+        bool sameOutputs = true;
+        for (int i = 0; i < rows; i++) {
+            std::vector<bool> inputs;
+            for (const std::string &name : spec.propositions) {
+                inputs.push_back(name == "p" ? p[2 * i] : q[2 * i]);
+            }
+            auto expected = toVectorIntervals(run_evaluation(nodes, holder, 2 * i, 2 * i + 2, inputs));
+            auto output = toVectorIntervals(run_evaluation(program, holder, 2 * i, 2 * i + 2, inputs));
+            sameOutputs &= output == expected;
+            verdicts.insert(verdicts.end(), output.begin(), output.end());
+            swapBuffers(holder);
+        }
+        destroyHolder(holder);
+
+        bool allCorrect = true;
+        for (int t = 1; t + spec.delay < traceEnd; t += 2) {
+            const Time delayed = t + spec.delay;
+            bool output = std::any_of(verdicts.begin(), verdicts.end(),
+                                      [delayed](const Interval &interval) { return interval.start <= delayed && delayed < interval.end; });
+            allCorrect &= output == reference(t);
+        }
+        INFO(text);
+        REQUIRE(sameOutputs == true);
+        REQUIRE(allCorrect == true);
+    }
+}
+
+TEST_CASE("Dense evaluation with a growing holder", "[dense]") {
+    using namespace do_verify;
+    using namespace db_interval_set;
+
+    // A holder far too small for the spec must grow instead of overflowing
+    // and produce the same verdicts as a generously sized one.
+    auto spec = spec_compiler::compile("historically(({r} && !{q} && once{q}) -> ({p} since[3:40] {q}))");
+    IntervalSetHolder small = newHolder(2);
+    IntervalSetHolder large = newHolder(100000);
+    auto smallNodes = spec_compiler::makeDenseNodes(spec, small);
+    auto largeNodes = spec_compiler::makeDenseNodes(spec, large);
+
+    std::mt19937 rng(11);
+    int time = 0;
+    bool allCorrect = true;
+    for (int i = 0; i < 3000; i++) {
+        int next = time + 1 + rng() % 3;
+        const bool a = rng() % 3 == 0;
+        const bool b = rng() % 4 == 0;
+        const bool c = rng() % 2 == 0;
+        std::vector<bool> inputs{a, b, c};
+        auto smallOut = run_evaluation(smallNodes, small, time, next, inputs);
+        auto largeOut = run_evaluation(largeNodes, large, time, next, inputs);
+        allCorrect &= toVectorIntervals(smallOut) == toVectorIntervals(largeOut);
+        swapBuffers(small);
+        swapBuffers(large);
+        time = next;
+    }
+    REQUIRE(allCorrect == true);
+    REQUIRE(peakUsage(small) == peakUsage(large));
+    destroyHolder(small);
+    destroyHolder(large);
+}
+
+
 TEST_CASE("Dense Timescales Tests", "[dense][old]") {
 
     using namespace db_interval_set;
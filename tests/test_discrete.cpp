@@ -6,6 +6,7 @@
 #include <vector>
 #include <fstream>
 #include <iostream>
+#include <random>
 #include "do-verify/json_reader.hpp"
 #include "do-verify/binary_row_reader.hpp"
 
@@ -89,6 +90,94 @@ TEST_CASE("Discrete Implementation Tests", "[discrete]") {
         db_interval_set::destroyHolder(holder);
         REQUIRE(allCorrect == true);
     }
+
+    SECTION("Window kernels match the interval set kernels") {
+        using namespace do_verify;
+        // Irregular timestamps so that windows expire between samples too
+        std::vector<Time> times;
+        std::vector<bool> values;
+        std::mt19937 rng(7);
+        for (int i = 0, time = 0; i < 2000; i++) {
+            time += 1 + rng() % 4;
+            times.push_back(time);
+            values.push_back(rng() % 3 == 0);
+        }
+
+        std::vector<std::pair<Time, Time>> bounds = {{0, 0}, {0, 10}, {3, 10}, {10, 10}, {5, B_INFINITY}, {0, B_INFINITY}};
+        for (auto [a, b] : bounds) {
+            for (NodeType type : {NodeType::EVENTUALLY, NodeType::ALWAYS}) {
+                db_interval_set::IntervalSetHolder holder = db_interval_set::newHolder(1000);
+                NodeType windowType = type == NodeType::EVENTUALLY ? NodeType::EVENTUALLY_WINDOW : NodeType::ALWAYS_WINDOW;
+                std::vector<DiscreteNode> nodes;
+                nodes.push_back(DiscreteNode{db_interval_set::empty(holder), false, NodeType::PROPOSITION, 0, 0, 0, 0});
+                nodes.push_back(DiscreteNode{db_interval_set::empty(holder), false, type, 0, 0, a, b});
+                nodes.push_back(DiscreteNode{db_interval_set::empty(holder), false, windowType, 0, 0, a, b,
+                    newWindow(discreteWindowCapacity(a, b))});
+                nodes.push_back(DiscreteNode{db_interval_set::empty(holder), false, NodeType::AND, 1, 2, 0, 0});
+
+                bool allCorrect = true;
+                for (size_t i = 0; i < times.size(); i++) {
+                    run_evaluation(nodes, holder, times[i], {values[i]});
+                    allCorrect &= nodes[1].output == nodes[2].output;
+                    db_interval_set::swapBuffers(holder);
+                }
+                // The ring never had to grow past its precomputed capacity
+                allCorrect &= nodes[2].window.buffer.size() == std::max(discreteWindowCapacity(a, b), 1u);
+                db_interval_set::destroyHolder(holder);
+                REQUIRE(allCorrect == true);
+            }
+        }
+        // The widest bounds a spec can write don't overflow the bound
+        static_assert(discreteWindowCapacity(0, B_INFINITY - 1) == 2);
+        REQUIRE(discreteWindowCapacity(1, B_INFINITY - 1) == 2);
+    }
+
+    SECTION("Step operators look back by rows") {
+        using namespace do_verify;
+        // Timestamps jump around so that only the row count can matter
+        std::vector<Time> times;
+        std::vector<bool> values;
+        std::mt19937 rng(11);
+        for (int i = 0, time = 0; i < 500; i++) {
+            time += 1 + rng() % 50;
+            times.push_back(time);
+            values.push_back(rng() % 3 == 0);
+        }
+        auto lookBack = [&](size_t i, int steps) { return i >= static_cast<size_t>(steps) && values[i - steps]; };
+
+        // delay[100] spans two ring words
+        for (int steps : {1, 5, 64, 100}) {
+            for (NodeType type : {NodeType::PREVIOUS, NodeType::RISE, NodeType::FALL, NodeType::DELAY}) {
+                if (type != NodeType::DELAY && steps != 1) {
+                    continue;
+                }
+                db_interval_set::IntervalSetHolder holder = db_interval_set::newHolder(1000);
+                std::vector<DiscreteNode> nodes;
+                nodes.push_back(DiscreteNode{db_interval_set::empty(holder), false, NodeType::PROPOSITION, 0, 0, 0, 0});
+                nodes.push_back(DiscreteNode{db_interval_set::empty(holder), false, type, 0, 0, steps, steps});
+                nodes[1].ring = newBitRing(steps);
+                DiscreteProgram program = newDiscreteProgram(2, holder);
+                program.opcodes = {NodeType::PROPOSITION, type};
+                program.lowerBounds[1] = program.upperBounds[1] = steps;
+                program.rings[1] = newBitRing(steps);
+
+                bool allCorrect = true;
+                for (size_t i = 0; i < times.size(); i++) {
+                    bool expected = lookBack(i, steps);
+                    if (type == NodeType::RISE) {
+                        expected = values[i] && !expected;
+                    } else if (type == NodeType::FALL) {
+                        expected = !values[i] && expected;
+                    }
+                    allCorrect &= run_evaluation(nodes, holder, times[i], {values[i]}) == expected;
+                    allCorrect &= run_evaluation(program, holder, times[i], {values[i]}) == expected;
+                    db_interval_set::swapBuffers(holder);
+                }
+                db_interval_set::destroyHolder(holder);
+                REQUIRE(allCorrect == true);
+            }
+        }
+    }
 }
 
 
@@ -6,6 +6,7 @@
 
 #include "do-verify/interval_set.hpp"
 #include <ostream>
+#include <random>
 
 // Use the namespace for cleaner tests
 using namespace db_interval_set;
@@ -75,6 +76,53 @@ TEST_CASE("Basic Set Creation and Lifecycle", "[interval_set]") {
 }
 
 
+TEST_CASE("Holder Growth", "[interval_set]") {
+
+    SECTION("Overflowing writes grow the buffer and keep earlier sets valid") {
+        IntervalSetHolder holder = newHolder(4);
+        IntervalSet s1 = fromInterval(holder, {0, 10});
+        IntervalSet s2 = fromInterval(holder, {20, 30});
+        IntervalSet s3 = fromInterval(holder, {40, 50}); // Does not fit anymore
+        REQUIRE(holder.bufferSize >= 8);
+
+        IntervalSet u = unionSets(holder, unionSets(holder, s1, s2), s3);
+        REQUIRE(toVectorIntervals(s1) == std::vector<Interval>{{0, 10}});
+        REQUIRE(toVectorIntervals(s2) == std::vector<Interval>{{20, 30}});
+        REQUIRE(toVectorIntervals(u) == std::vector<Interval>{{0, 10}, {20, 30}, {40, 50}});
+
+        // Sets written before the swap are still readable during the next step
+        swapBuffers(holder);
+        IntervalSet clipped = intersectSets(holder, u, fromInterval(holder, {5, 45}));
+        REQUIRE(toVectorIntervals(clipped) == std::vector<Interval>{{5, 10}, {20, 30}, {40, 45}});
+        REQUIRE(toVectorIntervals(s1) == std::vector<Interval>{{0, 10}});
+
+        // The smaller side is brought up to size once its contents are dead
+        swapBuffers(holder);
+        REQUIRE(holder.bufferSize == holder.readBufferSize);
+        destroyHolder(holder);
+    }
+
+    SECTION("Peak usage") {
+        IntervalSetHolder holder = newHolder(4);
+        fromInterval(holder, {0, 10});
+        swapBuffers(holder);
+        REQUIRE(peakUsage(holder) == 2);
+
+        for (int i = 0; i < 10; i++) {
+            fromInterval(holder, {i * 10, i * 10 + 5});
+        }
+        REQUIRE(peakUsage(holder) == 20);
+        swapBuffers(holder);
+        fromInterval(holder, {0, 10});
+        swapBuffers(holder);
+        REQUIRE(peakUsage(holder) == 20);
+
+        resetPeakUsage(holder);
+        REQUIRE(peakUsage(holder) == 0);
+        destroyHolder(holder);
+    }
+}
+
 TEST_CASE("Union Operations (unionSets)", "[interval_set]") {
     IntervalSetHolder holder = newHolder(1024);
 
@@ -277,6 +325,210 @@ TEST_CASE("Intersection Operations (intersectSets)", "[interval_set]") {
 }
 
 
+// Whether 'set' alternates starts and ends at strictly increasing times
+static bool isNormalised(const IntervalSet &set) {
+    for (int i = set.startIndex; i <= set.endIndex; i++) {
+        const Transition &t = set.buffer[i];
+        if (t.isStart != ((i - set.startIndex) % 2 == 0)) {
+            return false;
+        }
+        if (i > set.startIndex && set.buffer[i - 1].time >= t.time) {
+            return false;
+        }
+    }
+    return (set.endIndex - set.startIndex + 1) % 2 == 0;
+}
+
+TEST_CASE("Set Operations on Random Sets", "[interval_set]") {
+    IntervalSetHolder holder = newHolder(1024);
+
+    // Random normalised sets on a coarse grid, so the two sets often share
+    // or touch endpoints
+    std::mt19937 rng(3);
+    auto randomSet = [&](int count) {
+        std::vector<Interval> intervals;
+        Time t = -50;
+        for (int i = 0; i < count; i++) {
+            t += 1 + rng() % 4;
+            Time end = t + 1 + rng() % 4;
+            intervals.push_back({t, end});
+            t = end;
+        }
+        if (count > 0 && rng() % 4 == 0) {
+            intervals.push_back({t + 1, std::numeric_limits<Time>::max()});
+        }
+        return intervals;
+    };
+
+    bool allMatch = true;
+    for (int round = 0; round < 300; round++) {
+        holder.writeIndex = 0;
+        IntervalSet setA = createSetFromIntervals(holder, randomSet(rng() % 40));
+        // Every other round B is tiny, which takes the galloping sweeps
+        IntervalSet setB = createSetFromIntervals(holder, randomSet(rng() % (round % 2 == 0 ? 40 : 3)));
+        Interval interval{static_cast<Time>(-60 + rng() % 300), static_cast<Time>(-60 + rng() % 300)};
+        IntervalSet unionSet = unionSets(holder, setA, setB);
+        IntervalSet intersection = intersectSets(holder, setA, setB);
+        IntervalSet clipped = clipToInterval(holder, setA, interval);
+        IntervalSet widened = unionWithInterval(holder, setA, interval);
+
+        allMatch &= isNormalised(unionSet) && isNormalised(intersection);
+        allMatch &= isNormalised(clipped) && isNormalised(widened);
+        for (Time t = -60; t < 400; t++) {
+            const bool inInterval = interval.start <= t && t < interval.end;
+            allMatch &= includes(unionSet, t) == (includes(setA, t) || includes(setB, t));
+            allMatch &= includes(intersection, t) == (includes(setA, t) && includes(setB, t));
+            allMatch &= includes(clipped, t) == (includes(setA, t) && inInterval);
+            allMatch &= includes(widened, t) == (includes(setA, t) || inInterval);
+        }
+        allMatch &= toVectorTransitions(unionSets(holder, setA, setA)) == toVectorTransitions(setA);
+        allMatch &= toVectorTransitions(intersectSets(holder, setA, setA)) == toVectorTransitions(setA);
+    }
+    REQUIRE(allMatch == true);
+
+    destroyHolder(holder);
+}
+
+
+TEST_CASE("In-Place Set Operations", "[interval_set]") {
+    IntervalSetHolder holder = newHolder(16);
+    std::mt19937 rng(9);
+    auto randomIntervals = [&](Time t, int count) {
+        std::vector<Interval> intervals;
+        for (int i = 0; i < count; i++) {
+            t += 1 + rng() % 4;
+            Time end = t + 1 + rng() % 4;
+            intervals.push_back({t, end});
+            t = end;
+        }
+        return intervals;
+    };
+    auto randomInterval = [&]() {
+        Time start = static_cast<Time>(-60 + rng() % 160);
+        return Interval{start, static_cast<Time>(start - 5 + rng() % 40)};
+    };
+
+    bool allMatch = true;
+    for (int round = 0; round < 300; round++) {
+        // A small holder, so the writes often move to a grown buffer
+        swapBuffers(holder);
+        auto intervals = randomIntervals(-50, rng() % 30);
+        Interval interval = randomInterval();
+        IntervalSet original = createSetFromIntervals(holder, intervals);
+        auto unionExpected = toVectorTransitions(unionWithInterval(holder, original, interval));
+        auto clipExpected = toVectorTransitions(clipToInterval(holder, original, interval));
+
+        IntervalSet set = createSetFromIntervals(holder, intervals);
+        unionWithIntervalInPlace(holder, set, interval);
+        allMatch &= toVectorTransitions(set) == unionExpected && isNormalised(set);
+        set = createSetFromIntervals(holder, intervals);
+        clipToIntervalInPlace(holder, set, interval);
+        allMatch &= toVectorTransitions(set) == clipExpected && isNormalised(set);
+
+        // appendClipped with the set directly after the output, the output
+        // last, and neither
+        auto outputIntervals = randomIntervals(-60, rng() % 10);
+        Time after = outputIntervals.empty() ? -60 : outputIntervals.back().end;
+        Interval cut{static_cast<Time>(after + rng() % 3), static_cast<Time>(after + rng() % 60)};
+        IntervalSet output = createSetFromIntervals(holder, outputIntervals);
+        auto appendExpected = toVectorIntervals(unionSets(holder, output, clipToInterval(holder, original, cut)));
+        for (int layout = 0; layout < 3; layout++) {
+            output = createSetFromIntervals(holder, outputIntervals);
+            set = createSetFromIntervals(holder, intervals);
+            if (layout == 1) {
+                output = copySet(holder, output);
+            }
+            if (layout == 2) {
+                fromInterval(holder, {0, 1});
+            }
+            appendClipped(holder, output, set, cut);
+            allMatch &= toVectorIntervals(output) == appendExpected && isNormalised(output);
+            allMatch &= output.buffer == holder.writeBuffer && output.endIndex == holder.writeIndex - 1;
+        }
+    }
+    REQUIRE(allMatch == true);
+
+    destroyHolder(holder);
+}
+
+
+TEST_CASE("Point Queries", "[interval_set]") {
+    IntervalSetHolder holder = newHolder(1024);
+
+    SECTION("Single points and next change") {
+        IntervalSet s = createSetFromIntervals(holder, {{10, 20}, {20, 25}, {30, 40}});
+        REQUIRE(includes(s, 9) == false);
+        REQUIRE(includes(s, 10) == true);
+        REQUIRE(includes(s, 24) == true);
+        REQUIRE(includes(s, 25) == false);
+        REQUIRE(includes(s, 40) == false);
+        REQUIRE(includes(empty(holder), 0) == false);
+
+        REQUIRE(nextChange(s, 0) == 10);
+        REQUIRE(nextChange(s, 10) == 25);
+        REQUIRE(nextChange(s, 27) == 30);
+        REQUIRE(nextChange(s, 40) == std::numeric_limits<Time>::max());
+        REQUIRE(nextChange(empty(holder), 0) == std::numeric_limits<Time>::max());
+
+        // negateSet leaves an empty [20, 20) here, which changes nothing
+        IntervalSet negated = negateSet(holder, fromInterval(holder, {10, 20}), {0, 20});
+        REQUIRE(nextChange(negated, 5) == 10);
+        REQUIRE(nextChange(negated, 10) == std::numeric_limits<Time>::max());
+
+        REQUIRE(includesEach(s, {}).empty());
+        REQUIRE(includesEach(s, {5, 10, 10, 22, 25, 35, 100}) ==
+                std::vector<bool>{false, true, true, true, false, true, false});
+    }
+
+    SECTION("Match a linear scan") {
+        // Random sets with zero-length intervals, as negateSet can leave
+        std::mt19937 rng(5);
+        auto inSet = [](const IntervalSet &set, Time time) {
+            bool state = false;
+            for (int i = set.startIndex; i <= set.endIndex && set.buffer[i].time <= time; i++) {
+                state = set.buffer[i].isStart;
+            }
+            return state;
+        };
+
+        bool allMatch = true;
+        for (int round = 0; round < 200; round++) {
+            holder.writeIndex = 0;
+            reserveTransitions(holder, 80);
+            IntervalSet set{holder.writeBuffer, holder.writeIndex, holder.writeIndex - 1};
+            Time t = -50;
+            for (int k = rng() % 40; k > 0; k--) {
+                t += rng() % 4;
+                holder.writeBuffer[holder.writeIndex++] = Transition{t, true};
+                t += rng() % 4;
+                holder.writeBuffer[holder.writeIndex++] = Transition{t, false};
+            }
+            set.endIndex = holder.writeIndex - 1;
+
+            std::vector<Time> times;
+            for (Time q = -60; q < 200; q += rng() % 3) {
+                times.push_back(q);
+            }
+            std::vector<bool> each = includesEach(set, times);
+            for (size_t k = 0; k < times.size(); k++) {
+                const Time q = times[k];
+                allMatch &= includes(set, q) == inSet(set, q) && each[k] == inSet(set, q);
+
+                Time change = q + 1;
+                while (change < 200 && inSet(set, change) == inSet(set, q)) {
+                    change++;
+                }
+                const Time next = nextChange(set, q);
+                allMatch &= change < 200 ? next == change : next >= 200;
+            }
+        }
+        REQUIRE(allMatch == true);
+    }
+
+    destroyHolder(holder);
+}
+
+
 TEST_CASE("Negation Operations (negateSet)", "[interval_set]") {
     IntervalSetHolder holder = newHolder(1024);
     Interval domain = {0, 100};
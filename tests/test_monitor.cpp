@@ -0,0 +1,240 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_all.hpp>
+
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <fcntl.h>
+#include <unistd.h>
+#include "do-verify/monitor.hpp"
+
+using namespace monitor;
+
+// Writes a packed trace over {p, q} where p drops at 'violationRow'.
+static std::string writeTrace(int index, int rows, int violationRow) {
+    std::string file_name = "monitor_test_" + std::to_string(index) + ".trace";
+    std::string bytes = binary_row_reader::encodeTraceHeader({"p", "q"}, 0);
+    char row[sizeof(int32_t) + 1];
+    for (int i = 0; i < rows; i++) {
+        binary_row_reader::encodeRow(i * 2, {i != violationRow, i % 2 == 0}, row);
+        bytes.append(row, sizeof(row));
+    }
+    std::ofstream(file_name, std::ios::binary).write(bytes.data(), bytes.size());
+    return file_name;
+}
+
+TEST_CASE("Batch Monitoring", "[monitor]") {
+    auto spec = spec_compiler::compile("historically[:4]{p}");
+
+    std::vector<std::string> paths;
+    for (int i = 0; i < 12; i++) {
+        // Every third trace violates the spec, at a trace-specific row
+        paths.push_back(writeTrace(i, 200 + i * 50, i % 3 == 0 ? 10 + i : -1));
+    }
+    paths.push_back("monitor_test_missing.trace");
+
+    for (bool discrete : {true, false}) {
+        auto serial = monitorTraces(spec, paths, discrete, 1);
+        auto parallel = monitorTraces(spec, paths, discrete, 4);
+        REQUIRE(serial.size() == paths.size());
+        REQUIRE(parallel.size() == paths.size());
+
+        bool allCorrect = true;
+        for (size_t i = 0; i + 1 < paths.size(); i++) {
+            allCorrect &= serial[i].path == paths[i] && serial[i].error.empty();
+            allCorrect &= serial[i].summary.events == static_cast<size_t>(200 + i * 50);
+            allCorrect &= serial[i].summary.violated == (i % 3 == 0);
+            if (i % 3 == 0) {
+                // p is false from 2 * (10 + i) until the next row
+                allCorrect &= serial[i].summary.firstViolation == static_cast<int>(2 * (10 + i));
+            }
+            allCorrect &= parallel[i].summary.events == serial[i].summary.events;
+            allCorrect &= parallel[i].summary.violated == serial[i].summary.violated;
+            allCorrect &= parallel[i].summary.firstViolation == serial[i].summary.firstViolation;
+        }
+        REQUIRE(allCorrect == true);
+        REQUIRE(!serial.back().error.empty());
+        REQUIRE(!parallel.back().error.empty());
+
+        std::ostringstream report;
+        writeReport(report, parallel);
+        REQUIRE(report.str().find("# traces: 13, satisfied: 8, violated: 4, failed: 1") != std::string::npos);
+    }
+
+    for (size_t i = 0; i + 1 < paths.size(); i++) {
+        std::remove(paths[i].c_str());
+    }
+}
+
+TEST_CASE("Epoch timestamps", "[monitor]") {
+    // Nanosecond timestamps 1ms apart, with p dropping at row 30
+    const int64_t start = 1700000000000000000LL;
+    const std::string file_name = "monitor_test_epoch.trace";
+    std::string bytes = binary_row_reader::encodeTraceHeader({"p"}, 0, sizeof(int64_t));
+    char row[sizeof(int64_t) + 1];
+    for (int i = 0; i < 100; i++) {
+        binary_row_reader::encodeRow(start + i * 1000000LL, {i != 30}, row, sizeof(int64_t));
+        bytes.append(row, sizeof(row));
+    }
+    std::ofstream(file_name, std::ios::binary).write(bytes.data(), bytes.size());
+
+    auto spec = spec_compiler::compile("historically[:5000000]{p}");
+    for (bool discrete : {true, false}) {
+        auto reports = monitorTraces(spec, {file_name}, discrete, 1);
+        if (sizeof(db_interval_set::Time) == sizeof(int64_t)) {
+            REQUIRE(reports[0].error.empty());
+            REQUIRE(reports[0].summary.events == 100);
+            REQUIRE(reports[0].summary.violated == true);
+            REQUIRE(reports[0].summary.firstViolation == start + 30 * 1000000LL);
+        }
+        else {
+            // A 32-bit build refuses the times instead of truncating them
+            REQUIRE(!reports[0].error.empty());
+        }
+    }
+    std::remove(file_name.c_str());
+}
+
+// Writes a packed trace over {p} with the given row times and p always true
+static std::string writeTimes(const std::string &file_name, const std::vector<int32_t> &times) {
+    std::string bytes = binary_row_reader::encodeTraceHeader({"p"}, 0);
+    char row[sizeof(int32_t) + 1];
+    for (int32_t time : times) {
+        binary_row_reader::encodeRow(time, {true}, row);
+        bytes.append(row, sizeof(row));
+    }
+    std::ofstream(file_name, std::ios::binary).write(bytes.data(), bytes.size());
+    return file_name;
+}
+
+TEST_CASE("Row times must not go back", "[monitor]") {
+    auto spec = spec_compiler::compile("once[0:2]{p}");
+    std::vector<std::string> paths = {writeTimes("monitor_test_backwards.trace", {5, 7, 3, 9, 12}),
+                                      writeTimes("monitor_test_repeated.trace", {5, 7, 7, 9, 12})};
+    for (bool discrete : {true, false}) {
+        auto reports = monitorTraces(spec, paths, discrete, 1);
+        REQUIRE(reports[0].error.find("Row time 3") != std::string::npos);
+        // A dense row may repeat the previous time, a discrete one may not
+        REQUIRE(reports[1].error.empty() == !discrete);
+    }
+    for (const std::string &path : paths) {
+        std::remove(path.c_str());
+    }
+}
+
+TEST_CASE("Delayed verdicts", "[monitor]") {
+    // p drops for one row, 2 time units, so always[0:4]{p} fails from 4
+    // before the drop until its end
+    auto spec = spec_compiler::compile("always[0:4]{p}");
+    std::vector<std::string> paths = {writeTrace(100, 50, 10), writeTrace(101, 50, 1), writeTrace(102, 50, -1)};
+
+    auto reports = monitorTraces(spec, paths, false, 1);
+    REQUIRE(reports[0].error.empty());
+    REQUIRE(reports[0].summary.violated == true);
+    REQUIRE(reports[0].summary.firstViolation == 16);
+    // Nothing is reported for the times before the trace
+    REQUIRE(reports[1].summary.violated == true);
+    REQUIRE(reports[1].summary.firstViolation == 0);
+    REQUIRE(reports[2].summary.violated == false);
+
+    // Discrete time would need a row at every time unit
+    reports = monitorTraces(spec, paths, true, 1);
+    REQUIRE(!reports[0].error.empty());
+
+    for (const std::string &path : paths) {
+        std::remove(path.c_str());
+    }
+}
+
+// Runs 'rows' packed rows over {p, q} through runDense and returns the
+// verdict text
+static std::string denseVerdicts(const spec_compiler::CompiledSpec &spec, const std::vector<char> &rows, TraceSummary &summary) {
+    const std::string outputPath = "monitor_test_verdicts.out";
+    const size_t rowSize = sizeof(int32_t) + 1;
+    bool handedOut = false;
+    RowSource source = [&]() {
+        binary_row_reader::RowBatch batch{rows.data(), handedOut ? 0 : rows.size() / rowSize, rowSize};
+        handedOut = true;
+        return batch;
+    };
+    int fd = open(outputPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    auto writer = verdict_writer::newVerdictWriter(fd, verdict_writer::VerdictFormat::TEXT, verdict_writer::VerdictMode::DENSE, 256);
+    db_interval_set::IntervalSetHolder holder = db_interval_set::newHolder(64);
+    summary = runDense(spec, {{4, 1}, {4, 2}}, source, holder, &writer);
+    verdict_writer::finishVerdicts(writer);
+    db_interval_set::destroyHolder(holder);
+    close(fd);
+
+    std::ifstream input(outputPath);
+    std::string text((std::istreambuf_iterator<char>(input)), std::istreambuf_iterator<char>());
+    std::remove(outputPath.c_str());
+    return text;
+}
+
+TEST_CASE("Repeated rows", "[monitor]") {
+    // The same signals sampled at every time unit and only where they change
+    const int END = 600;
+    std::vector<char> sampled;
+    std::vector<char> changes;
+    char row[sizeof(int32_t) + 1];
+    bool p = true;
+    bool q = false;
+    std::mt19937 rng(5);
+    for (int time = 0; time <= END; time++) {
+        const bool changed = time == 0 || time == END || rng() % 9 == 0;
+        if (changed && time > 0 && time < END) {
+            p = rng() % 4 != 0;
+            q = !q;
+        }
+        binary_row_reader::encodeRow(time, {p, q}, row);
+        sampled.insert(sampled.end(), row, row + sizeof(row));
+        if (changed) {
+            changes.insert(changes.end(), row, row + sizeof(row));
+        }
+    }
+
+    auto spec_text = GENERATE(as<std::string>{},
+        "historically[:4]{p}",
+        "{p} since[2:30] {q}",
+        "once[3:]{q} && historically[2:7]{p}",
+        "always[0:5]{p} || ({q} until[1:9] !{p})");
+    auto spec = spec_compiler::compile(spec_text);
+    TraceSummary sampledSummary;
+    TraceSummary changesSummary;
+    std::string expected = denseVerdicts(spec, changes, changesSummary);
+    REQUIRE(denseVerdicts(spec, sampled, sampledSummary) == expected);
+    REQUIRE(sampledSummary.events == END + 1);
+    REQUIRE(sampledSummary.violated == changesSummary.violated);
+    REQUIRE(sampledSummary.firstViolation == changesSummary.firstViolation);
+
+    if (spec.delay == 0) {
+        // Against the program stepped once per row of the sparse trace
+        const std::string referencePath = "monitor_test_reference.out";
+        int fd = open(referencePath.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        auto writer = verdict_writer::newVerdictWriter(fd, verdict_writer::VerdictFormat::TEXT, verdict_writer::VerdictMode::DENSE, 256);
+        db_interval_set::IntervalSetHolder holder = db_interval_set::newHolder(64);
+        do_verify::DenseProgram program = spec_compiler::makeDenseProgram(spec, holder);
+        binary_row_reader::RowBatch batch{changes.data(), changes.size() / sizeof(row), sizeof(row)};
+        for (size_t i = 1; i < batch.count; i++) {
+            std::vector<bool> inputs = {binary_row_reader::rowValue(batch.row(i - 1), {4, 1}),
+                                        binary_row_reader::rowValue(batch.row(i - 1), {4, 2})};
+            auto output = do_verify::run_evaluation(program, holder, static_cast<db_interval_set::Time>(batch.time(i - 1)),
+                                                    static_cast<db_interval_set::Time>(batch.time(i)), inputs);
+            verdict_writer::writeDense(writer, output);
+            db_interval_set::swapBuffers(holder);
+        }
+        verdict_writer::finishVerdicts(writer);
+        db_interval_set::destroyHolder(holder);
+        close(fd);
+
+        std::ifstream input(referencePath);
+        std::string reference((std::istreambuf_iterator<char>(input)), std::istreambuf_iterator<char>());
+        std::remove(referencePath.c_str());
+        REQUIRE(expected == reference);
+    }
+}
@@ -2,7 +2,10 @@
 #include <catch2/benchmark/catch_benchmark.hpp>
 #include <catch2/catch_all.hpp>
 
+#include <cstdio>
+#include <iterator>
 #include <string>
+#include <unistd.h>
 #include <vector>
 #include <fstream>
 #include <iostream>
@@ -24,4 +27,370 @@ TEST_CASE("Readers Implementation Tests", "[reader]") {
         i++;
     }
 
-}
\ No newline at end of file
+}
+
+TEST_CASE("Memory-mapped row reader", "[reader]") {
+    using binary_row_reader::TimescalesInput;
+    const std::string file_name = "mapped_reader_test.row.bin";
+
+    std::vector<TimescalesInput> rows;
+    for (int32_t i = 0; i < 1000; i++) {
+        rows.push_back(TimescalesInput{i * 3, i % 2 == 0, i % 3 == 0, i % 5 == 0, i % 7 == 0});
+    }
+    {
+        std::ofstream out(file_name, std::ios::binary);
+        uint32_t count = static_cast<uint32_t>(rows.size());
+        out.write(reinterpret_cast<const char*>(&count), sizeof(count));
+        out.write(reinterpret_cast<const char*>(rows.data()), rows.size() * sizeof(TimescalesInput));
+    }
+
+    SECTION("Maps the same rows readInputFile reads") {
+        const auto &readRows = binary_row_reader::readInputFile(file_name);
+        auto mapped = binary_row_reader::mapInputFile(file_name);
+        REQUIRE(mapped.rows.size() == readRows.size());
+        bool allEqual = true;
+        for (size_t i = 0; i < readRows.size(); i++) {
+            const auto &a = mapped.rows[i];
+            const auto &b = readRows[i];
+            allEqual &= a.time == b.time && a.p == b.p && a.q == b.q && a.r == b.r && a.s == b.s;
+        }
+        REQUIRE(allEqual == true);
+        binary_row_reader::unmapInputFile(mapped);
+        REQUIRE(mapped.rows.empty());
+    }
+
+    SECTION("A truncated file only yields its complete rows") {
+        std::ifstream in(file_name, std::ios::binary);
+        std::string bytes((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+        in.close();
+        bytes.resize(bytes.size() - sizeof(TimescalesInput) - 3);
+        std::ofstream(file_name, std::ios::binary).write(bytes.data(), bytes.size());
+
+        auto mapped = binary_row_reader::mapInputFile(file_name);
+        REQUIRE(mapped.rows.size() == rows.size() - 2);
+        REQUIRE(mapped.rows.back().time == rows[rows.size() - 3].time);
+        binary_row_reader::unmapInputFile(mapped);
+    }
+
+    SECTION("A missing file yields no rows") {
+        auto mapped = binary_row_reader::mapInputFile("does_not_exist.row.bin");
+        REQUIRE(mapped.rows.empty());
+        REQUIRE(mapped.mapping == nullptr);
+    }
+
+    std::remove(file_name.c_str());
+}
+
+
+TEST_CASE("Streaming row reader", "[reader]") {
+    using binary_row_reader::TimescalesInput;
+
+    std::vector<TimescalesInput> rows;
+    for (int32_t i = 0; i < 10; i++) {
+        rows.push_back(TimescalesInput{i, i % 2 == 0, i % 3 == 0, false, true});
+    }
+    uint32_t count = 0; // Live producers don't know the count up front
+    std::string bytes(reinterpret_cast<const char*>(&count), sizeof(count));
+    bytes.append(reinterpret_cast<const char*>(rows.data()), rows.size() * sizeof(TimescalesInput));
+
+    int fds[2];
+    REQUIRE(pipe(fds) == 0);
+    auto stream = binary_row_reader::openRowStream(fds[0], 4);
+    auto sameRow = [](const char *row, const TimescalesInput &b) {
+        TimescalesInput a;
+        std::copy(row, row + sizeof(a), reinterpret_cast<char*>(&a));
+        return a.time == b.time && a.p == b.p && a.q == b.q && a.r == b.r && a.s == b.s;
+    };
+
+    // Header plus one and a half rows: only the complete row is handed out
+    size_t written = sizeof(count) + sizeof(TimescalesInput) * 3 / 2;
+    REQUIRE(write(fds[1], bytes.data(), written) == static_cast<ssize_t>(written));
+    auto batch = binary_row_reader::readBatch(stream);
+    REQUIRE(batch.count == 1);
+    REQUIRE(sameRow(batch.row(0), rows[0]));
+    REQUIRE(stream.header.propositions == std::vector<std::string>{"p", "q", "r", "s"});
+
+    // The rest arrives at once but comes out in batches of at most four
+    REQUIRE(write(fds[1], bytes.data() + written, bytes.size() - written) == static_cast<ssize_t>(bytes.size() - written));
+    close(fds[1]);
+    size_t received = 1;
+    bool allEqual = true;
+    for (batch = binary_row_reader::readBatch(stream); batch.count > 0; batch = binary_row_reader::readBatch(stream)) {
+        REQUIRE(batch.count <= 4);
+        for (size_t i = 0; i < batch.count; i++) {
+            allEqual &= received < rows.size() && sameRow(batch.row(i), rows[received]);
+            received++;
+        }
+    }
+    close(fds[0]);
+
+    REQUIRE(stream.finished == true);
+    REQUIRE(stream.failed == false);
+    REQUIRE(received == rows.size());
+    REQUIRE(allEqual == true);
+}
+
+
+TEST_CASE("Self-describing trace format", "[reader]") {
+    using namespace binary_row_reader;
+
+    std::vector<std::string> names;
+    for (int i = 0; i < 20; i++) {
+        names.push_back("signal_" + std::to_string(i));
+    }
+    std::string header = encodeTraceHeader(names, 0);
+
+    SECTION("Header round trip and bit-packed rows") {
+        TraceHeader parsed;
+        REQUIRE(parseTraceHeader(header.data(), header.size() - 1, parsed) == false);
+        REQUIRE(parseTraceHeader(header.data(), header.size(), parsed) == true);
+        REQUIRE(parsed.propositions == names);
+        REQUIRE(parsed.dataOffset == header.size());
+        REQUIRE(parsed.rowBytes == sizeof(int32_t) + 3);
+
+        std::vector<bool> values(names.size());
+        for (size_t i = 0; i < values.size(); i++) {
+            values[i] = i % 3 == 1;
+        }
+        std::vector<char> row(parsed.rowBytes);
+        encodeRow(-42, values, row.data());
+        REQUIRE(rowTime(row.data()) == -42);
+
+        // Binding picks slots in the order the spec asks for them
+        auto slots = bindPropositions(parsed, {"signal_19", "signal_1", "signal_0"});
+        REQUIRE(rowValue(row.data(), slots[0]) == values[19]);
+        REQUIRE(rowValue(row.data(), slots[1]) == true);
+        REQUIRE(rowValue(row.data(), slots[2]) == false);
+        REQUIRE_THROWS_AS(bindPropositions(parsed, {"missing"}), TraceFormatError);
+    }
+
+    SECTION("Version 2 rows hold 64-bit times") {
+        std::string wide = encodeTraceHeader(names, 0, sizeof(int64_t));
+        TraceHeader parsed;
+        REQUIRE(parseTraceHeader(wide.data(), wide.size(), parsed) == true);
+        REQUIRE(parsed.timeBytes == sizeof(int64_t));
+        REQUIRE(parsed.rowBytes == sizeof(int64_t) + 3);
+
+        std::vector<bool> values(names.size());
+        values[19] = true;
+        std::vector<char> row(parsed.rowBytes);
+        const int64_t epochNanos = 1700000000123456789LL;
+        encodeRow(epochNanos, values, row.data(), parsed.timeBytes);
+        REQUIRE(rowTime(row.data(), parsed.timeBytes) == epochNanos);
+        auto slots = bindPropositions(parsed, {"signal_19", "signal_0"});
+        REQUIRE(rowValue(row.data(), slots[0]) == true);
+        REQUIRE(rowValue(row.data(), slots[1]) == false);
+    }
+
+    SECTION("Unknown versions are rejected") {
+        std::string bad = header;
+        bad[4] = 7;
+        TraceHeader parsed;
+        REQUIRE_THROWS_AS(parseTraceHeader(bad.data(), bad.size(), parsed), TraceFormatError);
+    }
+
+    SECTION("Mapped and streamed traces agree") {
+        const std::string file_name = "packed_reader_test.trace";
+        std::string bytes = header;
+        std::vector<char> row(sizeof(int32_t) + 3);
+        for (int32_t t = 0; t < 100; t++) {
+            std::vector<bool> values(names.size());
+            values[t % names.size()] = true;
+            encodeRow(t * 5, values, row.data());
+            bytes.append(row.data(), row.size());
+        }
+        std::ofstream(file_name, std::ios::binary).write(bytes.data(), bytes.size());
+
+        auto mapped = mapTraceFile(file_name);
+        REQUIRE(mapped.rows.count == 100);
+        auto slots = bindPropositions(mapped.header, names);
+        bool allCorrect = true;
+        for (size_t i = 0; i < mapped.rows.count; i++) {
+            const char *r = mapped.rows.row(i);
+            allCorrect &= rowTime(r) == static_cast<int32_t>(i * 5);
+            for (size_t j = 0; j < names.size(); j++) {
+                allCorrect &= rowValue(r, slots[j]) == (j == i % names.size());
+            }
+        }
+        REQUIRE(allCorrect == true);
+
+        int fds[2];
+        REQUIRE(pipe(fds) == 0);
+        REQUIRE(write(fds[1], bytes.data(), bytes.size()) == static_cast<ssize_t>(bytes.size()));
+        close(fds[1]);
+        auto stream = openRowStream(fds[0], 16);
+        REQUIRE(readStreamHeader(stream) == true);
+        REQUIRE(stream.header.propositions == names);
+        size_t streamed = 0;
+        for (auto batch = readBatch(stream); batch.count > 0; batch = readBatch(stream)) {
+            REQUIRE(batch.count <= 16);
+            for (size_t i = 0; i < batch.count; i++) {
+                allCorrect &= std::equal(batch.row(i), batch.row(i) + row.size(), mapped.rows.row(streamed));
+                streamed++;
+            }
+        }
+        close(fds[0]);
+        REQUIRE(streamed == 100);
+        REQUIRE(allCorrect == true);
+
+        unmapTraceFile(mapped);
+        std::remove(file_name.c_str());
+    }
+}
+
+
+TEST_CASE("Vectorised JSONL parser", "[reader]") {
+    using namespace json_reader;
+    auto parser = newJsonlParser({"p", "q", "missing"});
+    REQUIRE(parser.rowBytes == parser.timeBytes + 1);
+    auto slots = binary_row_reader::bindPropositions(jsonlHeader(parser), {"p", "q", "missing"});
+    std::vector<char> rows(parser.rowBytes * 16);
+
+    SECTION("Any key order, whitespace, extra keys and lines longer than a block") {
+        std::string text =
+            "{\"time\": 5, \"q\": true, \"p\": false}\n"
+            "\n"
+            "{ \"p\" : true ,\"time\":-12,\"comment\":\"a, b: {c}\",\"q\":false }\r\n"
+            "{\"a_rather_long_unrelated_key_that_spans_blocks\": 123456789, \"another\": false, \"q\": true, \"time\": 70000}\n"
+            "{\"time\": 9, \"p\": true";
+        size_t consumed = 0;
+        size_t count = parseRows(parser, text.data(), text.size(), false, rows.data(), 16, consumed);
+        REQUIRE(count == 3);
+        REQUIRE(consumed == text.rfind('\n') + 1);
+
+        auto row = [&](size_t i) { return rows.data() + i * parser.rowBytes; };
+        REQUIRE(binary_row_reader::rowTime(row(0), parser.timeBytes) == 5);
+        REQUIRE(binary_row_reader::rowValue(row(0), slots[0]) == false);
+        REQUIRE(binary_row_reader::rowValue(row(0), slots[1]) == true);
+        REQUIRE(binary_row_reader::rowTime(row(1), parser.timeBytes) == -12);
+        REQUIRE(binary_row_reader::rowValue(row(1), slots[0]) == true);
+        REQUIRE(binary_row_reader::rowValue(row(1), slots[1]) == false);
+        REQUIRE(binary_row_reader::rowTime(row(2), parser.timeBytes) == 70000);
+        REQUIRE(binary_row_reader::rowValue(row(2), slots[1]) == true);
+        REQUIRE(binary_row_reader::rowValue(row(2), slots[2]) == false);
+
+        // The unterminated last line is only parsed once the input has ended
+        std::string rest = text.substr(consumed) + "}";
+        count = parseRows(parser, rest.data(), rest.size(), true, rows.data(), 16, consumed);
+        REQUIRE(count == 1);
+        REQUIRE(consumed == rest.size());
+        REQUIRE(binary_row_reader::rowTime(row(0), parser.timeBytes) == 9);
+    }
+
+    SECTION("Escaped quotes don't end a string") {
+        std::string text =
+            "{\"time\": 0, \"name\": \"a\\\"b, \\\"p\\\": false\", \"p\": true}\n"
+            "{\"time\": 1, \"path\": \"c:\\\\\", \"p\": true}\n";
+        size_t consumed = 0;
+        REQUIRE(parseRows(parser, text.data(), text.size(), true, rows.data(), 16, consumed) == 2);
+        REQUIRE(binary_row_reader::rowValue(rows.data(), slots[0]) == true);
+        REQUIRE(binary_row_reader::rowTime(rows.data() + parser.rowBytes, parser.timeBytes) == 1);
+        REQUIRE(binary_row_reader::rowValue(rows.data() + parser.rowBytes, slots[0]) == true);
+    }
+
+    SECTION("Stops after maxRows") {
+        std::string text = "{\"time\": 1, \"p\": true}\n{\"time\": 2, \"p\": true}\n{\"time\": 3, \"p\": true}\n";
+        size_t consumed = 0;
+        REQUIRE(parseRows(parser, text.data(), text.size(), true, rows.data(), 2, consumed) == 2);
+        REQUIRE(text.substr(consumed) == "{\"time\": 3, \"p\": true}\n");
+    }
+
+    SECTION("Agrees with read_line") {
+        std::string text;
+        std::vector<std::string> lines;
+        for (int i = 0; i < 200; i++) {
+            std::string line = "{\"time\": " + std::to_string(i * 7) + ", \"q\": " + (i % 3 == 0 ? "true" : "false") +
+                               ", \"p\": " + (i % 2 == 0 ? "true" : "false") + "}";
+            lines.push_back(line);
+            text += line + "\n";
+        }
+        auto qp = newJsonlParser({"q", "p"});
+        std::vector<char> out(qp.rowBytes * lines.size());
+        size_t consumed = 0;
+        REQUIRE(parseRows(qp, text.data(), text.size(), true, out.data(), lines.size(), consumed) == lines.size());
+        auto qpSlots = binary_row_reader::bindPropositions(jsonlHeader(qp), {"q", "p"});
+        bool allEqual = true;
+        for (size_t i = 0; i < lines.size(); i++) {
+            auto expected = read_line(lines[i]);
+            const char *r = out.data() + i * qp.rowBytes;
+            allEqual &= binary_row_reader::rowTime(r, qp.timeBytes) == expected.time;
+            allEqual &= binary_row_reader::rowValue(r, qpSlots[0]) == expected.propositions[0];
+            allEqual &= binary_row_reader::rowValue(r, qpSlots[1]) == expected.propositions[1];
+        }
+        REQUIRE(allEqual == true);
+    }
+
+    SECTION("Malformed lines are reported") {
+        size_t consumed = 0;
+        std::string missingColon = "{\"time\" 1}\n";
+        REQUIRE_THROWS_AS(parseRows(parser, missingColon.data(), missingColon.size(), true, rows.data(), 16, consumed), JsonlParseError);
+        std::string badTime = "{\"time\": \"soon\"}\n";
+        REQUIRE_THROWS_AS(parseRows(parser, badTime.data(), badTime.size(), true, rows.data(), 16, consumed), JsonlParseError);
+        std::string nested = "{\"time\": 1, \"p\": {\"x\": 1}}\n";
+        REQUIRE_THROWS_AS(parseRows(parser, nested.data(), nested.size(), true, rows.data(), 16, consumed), JsonlParseError);
+        for (std::string line : {"{\"p\": true}\n", "{}\n", "{\"time\": 1, \"p\": \"x\"}\n", "{\"time\": 1, \"p\": 1}\n",
+                                 "{\"time\": 1, \"q\": \"true\"}\n"}) {
+            REQUIRE_THROWS_AS(parseRows(parser, line.data(), line.size(), true, rows.data(), 16, consumed), JsonlParseError);
+        }
+    }
+
+    SECTION("Only whitespace between tokens") {
+        size_t consumed = 0;
+        for (std::string line : {"garbage{\"time\": 1}\n", "{ x \"time\": 1}\n", "{\"time\" x : 1}\n",
+                                 "{\"time\": 1, x \"p\": true}\n", "{\"time\": 1} junk\n", "{\"time\": 1}\nx\n",
+                                 "{\"time\": 1, \"s\": \"a\" x}\n", "{\"time\": 1, \"s\": x \"a\"}\n",
+                                 "{\"time\": 1, \"s\": \"a\" \"b\"}\n", "{\"time\": 1}\ntrailing"}) {
+            REQUIRE_THROWS_AS(parseRows(parser, line.data(), line.size(), true, rows.data(), 16, consumed), JsonlParseError);
+        }
+        std::string junk = "{\"time\": 1}\n{\"time\" nonsense : 2}\n";
+        REQUIRE_THROWS_WITH(parseRows(parser, junk.data(), junk.size(), true, rows.data(), 16, consumed),
+                            "Expected ':' at byte 20");
+        std::string spaced = " \t{ \"time\" :\t1 , \"s\" : \"a\" }\t\r\n  \n";
+        REQUIRE(parseRows(parser, spaced.data(), spaced.size(), true, rows.data(), 16, consumed) == 1);
+        REQUIRE(consumed == spaced.size());
+    }
+
+    SECTION("A repeated key takes its last value") {
+        std::string text = "{\"time\": 1, \"p\": true, \"q\": false, \"p\": false, \"q\": true, \"time\": 4}\n";
+        size_t consumed = 0;
+        REQUIRE(parseRows(parser, text.data(), text.size(), true, rows.data(), 16, consumed) == 1);
+        REQUIRE(binary_row_reader::rowTime(rows.data(), parser.timeBytes) == 4);
+        REQUIRE(binary_row_reader::rowValue(rows.data(), slots[0]) == false);
+        REQUIRE(binary_row_reader::rowValue(rows.data(), slots[1]) == true);
+    }
+
+    SECTION("Propositions no line has are reported") {
+        REQUIRE(missingPropositions(parser) == std::vector<std::string>{"p", "q", "missing"});
+        std::string text = "{\"time\": 1, \"p\": false}\n{\"time\": 2, \"q\": true, \"mising\": true}\n";
+        size_t consumed = 0;
+        REQUIRE(parseRows(parser, text.data(), text.size(), true, rows.data(), 16, consumed) == 2);
+        REQUIRE(missingPropositions(parser) == std::vector<std::string>{"missing"});
+    }
+
+    SECTION("Streams from a file descriptor") {
+        std::string text;
+        for (int i = 0; i < 50; i++) {
+            text += "{\"time\": " + std::to_string(i) + ", \"p\": " + (i % 2 == 0 ? "true" : "false") + "}\n";
+        }
+        int fds[2];
+        REQUIRE(pipe(fds) == 0);
+        REQUIRE(write(fds[1], text.data(), text.size()) == static_cast<ssize_t>(text.size()));
+        close(fds[1]);
+
+        auto stream = openJsonlStream(fds[0], newJsonlParser({"p"}), 8);
+        int expectedTime = 0;
+        bool allCorrect = true;
+        for (auto batch = readBatch(stream); batch.count > 0; batch = readBatch(stream)) {
+            REQUIRE(batch.count <= 8);
+            for (size_t i = 0; i < batch.count; i++) {
+                allCorrect &= batch.time(i) == expectedTime;
+                allCorrect &= (batch.row(i)[batch.timeBytes] & 1) == (expectedTime % 2 == 0);
+                expectedTime++;
+            }
+        }
+        close(fds[0]);
+        REQUIRE(expectedTime == 50);
+        REQUIRE(allCorrect == true);
+        REQUIRE(stream.failed == false);
+    }
+}
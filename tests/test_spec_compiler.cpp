@@ -0,0 +1,238 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_all.hpp>
+
+#include <string>
+#include <vector>
+#include "do-verify/spec_compiler.hpp"
+
+using namespace do_verify;
+using namespace spec_compiler;
+
+static bool sameNode(const SpecNode &node, NodeType type, unsigned int left, unsigned int right, db_interval_set::Time a, db_interval_set::Time b) {
+    return node.type == type && node.leftOperandIndex == left && node.rightOperandIndex == right &&
+        node.a == a && node.b == b;
+}
+
+TEST_CASE("Spec Parsing", "[spec_compiler]") {
+
+    SECTION("AbsentAQ matches the hand-built node array") {
+        CompiledSpec spec = compile("historically((once[:10]{q}) -> ((not{p}) since {q}))");
+
+        REQUIRE(spec.propositions == std::vector<std::string>{"q", "p"});
+        REQUIRE(spec.nodes.size() == 7);
+        REQUIRE(sameNode(spec.nodes[0], NodeType::PROPOSITION, 0, 0, 0, 0));
+        REQUIRE(sameNode(spec.nodes[1], NodeType::PROPOSITION, 0, 0, 0, 0));
+        REQUIRE(sameNode(spec.nodes[2], NodeType::EVENTUALLY, 0, 0, 0, 10));
+        REQUIRE(sameNode(spec.nodes[3], NodeType::NOT, 0, 1, 0, 0));
+        REQUIRE(sameNode(spec.nodes[4], NodeType::SINCE, 3, 0, 0, B_INFINITY));
+        REQUIRE(sameNode(spec.nodes[5], NodeType::IMPLIES, 2, 4, 0, 0));
+        REQUIRE(sameNode(spec.nodes[6], NodeType::ALWAYS, 0, 5, 0, B_INFINITY));
+    }
+
+    SECTION("Bounds") {
+        CompiledSpec spec = compile("once[3:10]{p} && historically[:5]{p} && ({p} since[10:] {p}) && once[:]{p}");
+        REQUIRE(spec.propositions == std::vector<std::string>{"p"});
+        REQUIRE(sameNode(spec.nodes[1], NodeType::EVENTUALLY, 0, 0, 3, 10));
+        REQUIRE(sameNode(spec.nodes[2], NodeType::ALWAYS, 0, 0, 0, 5));
+        REQUIRE(sameNode(spec.nodes[4], NodeType::SINCE, 0, 0, 10, B_INFINITY));
+        REQUIRE(sameNode(spec.nodes[6], NodeType::EVENTUALLY, 0, 0, 0, B_INFINITY));
+    }
+
+    SECTION("Precedence and associativity") {
+        // '->' binds loosest and associates to the right; 'and' binds tighter than 'or'.
+        Formula f = parse("{a} or {b} and {c} -> {d} -> {e}");
+        const FormulaNode &root = f.nodes[f.root];
+        REQUIRE(root.type == NodeType::IMPLIES);
+        REQUIRE(f.nodes[root.left].type == NodeType::OR);
+        REQUIRE(f.nodes[f.nodes[root.left].right].type == NodeType::AND);
+        REQUIRE(f.nodes[root.right].type == NodeType::IMPLIES);
+
+        // Prefix operators bind tighter than 'since' and the connectives.
+        f = parse("not {a} since historically {b} && {c}");
+        const FormulaNode &conj = f.nodes[f.root];
+        REQUIRE(conj.type == NodeType::AND);
+        REQUIRE(f.nodes[conj.left].type == NodeType::SINCE);
+        REQUIRE(f.nodes[f.nodes[conj.left].left].type == NodeType::NOT);
+        REQUIRE(f.nodes[f.nodes[conj.left].right].type == NodeType::ALWAYS);
+    }
+
+    SECTION("Keywords need a word boundary") {
+        CompiledSpec spec = compile("{notice} or {order}");
+        REQUIRE(spec.propositions == std::vector<std::string>{"notice", "order"});
+        REQUIRE(sameNode(spec.nodes[2], NodeType::OR, 0, 1, 0, 0));
+    }
+
+    SECTION("Common subexpressions share one node") {
+        CompiledSpec spec = compile("historically(({r} && !{q} && once{q}) -> ({p} since ({q} && {r})) && once{q} && ({r} && {q}))");
+        // r, q, p, !q, r&&!q, once{q}, (r&&!q)&&once{q}, q&&r, since, since&&once{q}, ...&&(q&&r), ->, historically
+        REQUIRE(spec.nodes.size() == 13);
+
+        int onceNodes = 0;
+        int notNodes = 0;
+        for (const SpecNode &node : spec.nodes) {
+            onceNodes += node.type == NodeType::EVENTUALLY;
+            notNodes += node.type == NodeType::NOT;
+        }
+        REQUIRE(onceNodes == 1);
+        REQUIRE(notNodes == 1);
+        REQUIRE(spec.nodes.back().type == NodeType::ALWAYS);
+
+        // Same operator but different bounds must not be merged.
+        spec = compile("once[:10]{p} and once[:20]{p} and once[:10]{p}");
+        REQUIRE(spec.nodes.size() == 5);
+    }
+
+    SECTION("Future operators run on delayed timelines") {
+        CompiledSpec spec = compile("eventually[2:5]{p}");
+        REQUIRE(spec.nodes.size() == 2);
+        REQUIRE(sameNode(spec.nodes[1], NodeType::EVENTUALLY, 0, 0, 0, 3));
+        REQUIRE(spec.delay == 5);
+
+        // p is lined up with the eventually by a 5 late copy of itself
+        spec = compile("{p} && always[2:5]{q}");
+        REQUIRE(spec.nodes.size() == 5);
+        REQUIRE(sameNode(spec.nodes[2], NodeType::ALWAYS, 0, 1, 0, 3));
+        REQUIRE(sameNode(spec.nodes[3], NodeType::EVENTUALLY, 0, 0, 5, 5));
+        REQUIRE(sameNode(spec.nodes[4], NodeType::AND, 3, 2, 0, 0));
+        REQUIRE(spec.delay == 5);
+
+        spec = compile("{p} until[1:4] eventually[0:2]{q}");
+        REQUIRE(sameNode(spec.nodes.back(), NodeType::UNTIL, 3, 2, 1, 4));
+        REQUIRE(sameNode(spec.nodes[3], NodeType::EVENTUALLY, 0, 0, 2, 2));
+        REQUIRE(spec.delay == 6);
+
+        // historically doesn't look at the first 4 time units, which are
+        // about times before the trace
+        spec = compile("historically[1:3] eventually[:4]{p}");
+        REQUIRE(spec.nodes.size() == 6);
+        REQUIRE(sameNode(spec.nodes[2], NodeType::IMPLIES, 0, 0, 0, 0));
+        REQUIRE(sameNode(spec.nodes[3], NodeType::EVENTUALLY, 0, 2, 4, B_INFINITY));
+        REQUIRE(sameNode(spec.nodes[4], NodeType::IMPLIES, 3, 1, 0, 0));
+        REQUIRE(sameNode(spec.nodes[5], NodeType::ALWAYS, 0, 4, 1, 3));
+        REQUIRE(spec.delay == 4);
+
+        REQUIRE(needsDenseTime(compile("once[:3] eventually[1:2]{p}")) == true);
+        REQUIRE(needsDenseTime(compile("{p} until[0:0] {q}")) == true);
+        REQUIRE(needsDenseTime(compile("eventually[0:0]{p} since {q}")) == false);
+        REQUIRE(compile("historically({p} since {q})").delay == 0);
+
+        REQUIRE_THROWS_AS(parse("eventually{p}"), SpecParseError);
+        REQUIRE_THROWS_AS(parse("always[3:]{p}"), SpecParseError);
+        REQUIRE_THROWS_AS(parse("{p} until {q}"), SpecParseError);
+        const std::string half = std::to_string(B_INFINITY / 2 + 1);
+        REQUIRE_THROWS_AS(compile("eventually[:" + half + "] eventually[:" + half + "]{p}"), SpecParseError);
+    }
+
+    SECTION("Step operators") {
+        CompiledSpec spec = compile("rise{p} && delay[3]{q} || fall pre{p}");
+        REQUIRE(spec.nodes.size() == 8);
+        REQUIRE(sameNode(spec.nodes[2], NodeType::RISE, 0, 0, 1, 1));
+        REQUIRE(sameNode(spec.nodes[3], NodeType::DELAY, 0, 1, 3, 3));
+        REQUIRE(sameNode(spec.nodes[4], NodeType::AND, 2, 3, 0, 0));
+        REQUIRE(sameNode(spec.nodes[5], NodeType::PREVIOUS, 0, 0, 1, 1));
+        REQUIRE(sameNode(spec.nodes[6], NodeType::FALL, 0, 5, 1, 1));
+        REQUIRE(spec.delay == 0);
+        REQUIRE(needsDiscreteTime(spec) == true);
+        REQUIRE(needsDiscreteTime(compile("once[1:1]{p}")) == false);
+
+        spec = compile("{pre} or {delay}");
+        REQUIRE(spec.propositions == std::vector<std::string>{"pre", "delay"});
+        REQUIRE(needsDiscreteTime(spec) == false);
+
+        REQUIRE_THROWS_AS(parse("delay{p}"), SpecParseError);
+        REQUIRE_THROWS_AS(parse("delay[0]{p}"), SpecParseError);
+        REQUIRE_THROWS_AS(parse("delay[1:2]{p}"), SpecParseError);
+        REQUIRE_THROWS_AS(parse("pre"), SpecParseError);
+    }
+
+    SECTION("Malformed specs") {
+        REQUIRE_THROWS_AS(parse(""), SpecParseError);
+        REQUIRE_THROWS_AS(parse("{p"), SpecParseError);
+        REQUIRE_THROWS_AS(parse("{}"), SpecParseError);
+        REQUIRE_THROWS_AS(parse("({p} and {q}"), SpecParseError);
+        REQUIRE_THROWS_AS(parse("{p} {q}"), SpecParseError);
+        REQUIRE_THROWS_AS(parse("once[10:3]{p}"), SpecParseError);
+        REQUIRE_THROWS_AS(parse("once[3 10]{p}"), SpecParseError);
+        REQUIRE_THROWS_AS(parse("{p} since"), SpecParseError);
+        // The largest Time stands for an open bound, so it can't be written out
+        REQUIRE_THROWS_AS(parse("once[:" + std::to_string(B_INFINITY) + "]{p}"), SpecParseError);
+        REQUIRE(compile("once[:" + std::to_string(B_INFINITY - 1) + "]{p}").nodes[1].b == B_INFINITY - 1);
+    }
+}
+
+TEST_CASE("Compiled Spec Evaluation", "[spec_compiler]") {
+    using namespace db_interval_set;
+
+    SECTION("Discrete since matches the hand-built nodes") {
+        std::vector<std::vector<bool>> propositionInputs = {
+        {false, false, true, true, true, false},    // p
+        {false, true, false, false, true, false},   // q
+        };
+        std::vector<bool> expectedOutput = {false, false, false, true, true, false};
+
+        IntervalSetHolder holder = newHolder(1000);
+        CompiledSpec spec = compile("{p} since[2:3] {q}");
+        std::vector<DiscreteNode> nodes = makeDiscreteNodes(spec, holder);
+
+        bool allCorrect = true;
+        for (int time = 0; time < propositionInputs[0].size(); time++) {
+            bool output = run_evaluation(nodes, holder, time, {propositionInputs[0][time], propositionInputs[1][time]});
+            allCorrect &= output == expectedOutput[time];
+            swapBuffers(holder);
+        }
+        destroyHolder(holder);
+        REQUIRE(allCorrect == true);
+    }
+
+    SECTION("Dense once") {
+        IntervalSetHolder holder = newHolder(1000);
+        CompiledSpec spec = compile("once[2:4]{p}");
+        std::vector<DenseNode> nodes = makeDenseNodes(spec, holder);
+
+        auto out = run_evaluation(nodes, holder, 0, 10, {true});
+        REQUIRE(toVectorIntervals(out) == std::vector<Interval>{{2, 10}});
+        swapBuffers(holder);
+
+        out = run_evaluation(nodes, holder, 10, 20, {false});
+        REQUIRE(toVectorIntervals(out) == std::vector<Interval>{{10, 14}});
+        swapBuffers(holder);
+        destroyHolder(holder);
+    }
+
+    SECTION("Programs match the node arrays") {
+        // More than 64 nodes so the output bitset spans several words.
+        std::string text = "{p}";
+        for (int i = 1; i <= 40; i++) {
+            text = "(" + text + " since[:" + std::to_string(i) + "] once[1:" + std::to_string(i + 2) + "]{q})";
+        }
+        text = "historically(" + text + " -> !{q})";
+
+        IntervalSetHolder holder = newHolder(1 << 12);
+        CompiledSpec spec = compile(text);
+        REQUIRE(spec.nodes.size() > 64);
+
+        std::vector<DiscreteNode> discreteNodes = makeDiscreteNodes(spec, holder);
+        do_verify::DiscreteProgram discreteProgram = makeDiscreteProgram(spec, holder);
+        std::vector<DenseNode> denseNodes = makeDenseNodes(spec, holder);
+        do_verify::DenseProgram denseProgram = makeDenseProgram(spec, holder);
+
+        bool allEqual = true;
+        for (int time = 0; time < 200; time++) {
+            std::vector<bool> inputs(spec.nodes.size(), false);
+            inputs[0] = (time * 7) % 5 < 3;
+            inputs[1] = (time * 3) % 11 < 2;
+            bool expected = run_evaluation(discreteNodes, holder, time, inputs);
+            allEqual &= run_evaluation(discreteProgram, holder, time, inputs) == expected;
+            for (unsigned int node = 0; node < spec.nodes.size(); node++) {
+                allEqual &= nodeOutput(discreteProgram, node) == discreteNodes[node].output;
+            }
+
+            auto denseExpected = toVectorIntervals(run_evaluation(denseNodes, holder, time * 10, time * 10 + 10, inputs));
+            allEqual &= toVectorIntervals(run_evaluation(denseProgram, holder, time * 10, time * 10 + 10, inputs)) == denseExpected;
+            swapBuffers(holder);
+        }
+        destroyHolder(holder);
+        REQUIRE(allEqual);
+    }
+}
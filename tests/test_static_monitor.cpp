@@ -0,0 +1,67 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/catch_all.hpp>
+
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+#include "do-verify/spec_compiler.hpp"
+#include "do-verify/static_monitor.hpp"
+
+using namespace static_monitor;
+
+// Steps a static monitor and the interpreter over the same pseudo-random
+// trace, inputs are given in the order of the compiled spec's propositions.
+template <class Formula>
+static bool matchesInterpreter(const std::string &text) {
+    using namespace db_interval_set;
+    spec_compiler::CompiledSpec spec = spec_compiler::compile(text);
+    IntervalSetHolder holder = newHolder(spec_compiler::holderSizeHint(spec));
+    std::vector<do_verify::DiscreteNode> nodes = spec_compiler::makeDiscreteNodes(spec, holder);
+    Formula monitor{};
+
+    std::mt19937_64 rng(7);
+    bool allEqual = true;
+    int time = 0;
+    for (int step = 0; step < 3000; step++) {
+        time += 1 + (step % 13 == 0 ? 5 : 0);
+        std::vector<bool> inputs(spec.nodes.size(), false);
+        for (size_t i = 0; i < spec.propositions.size(); i++) {
+            inputs[i] = (rng() & 3) != 0;
+        }
+        bool expected = run_evaluation(nodes, holder, time, inputs);
+        allEqual &= monitor.step(time, inputs) == expected;
+        swapBuffers(holder);
+    }
+    destroyHolder(holder);
+    return allEqual;
+}
+
+TEST_CASE("Static Monitors", "[static_monitor]") {
+
+    SECTION("AbsentAQ") {
+        // Propositions: q, p
+        using AbsentAQ = Historically<0, INF, Implies<Once<0, 10, P<0>>, Since<0, INF, Not<P<1>>, P<0>>>>;
+        REQUIRE(matchesInterpreter<AbsentAQ>("historically((once[:10]{q}) -> ((not{p}) since {q}))"));
+    }
+
+    SECTION("RespondBQR") {
+        // Propositions: r, q, p
+        using RespondBQR = Historically<0, INF,
+            Implies<And<And<P<0>, Not<P<1>>>, Once<0, INF, P<1>>>, Since<3, 40, P<2>, P<1>>>>;
+        REQUIRE(matchesInterpreter<RespondBQR>("historically(({r} && !{q} && once{q}) -> ({p} since[3:40] {q}))"));
+    }
+
+    SECTION("Bounded windows") {
+        // Propositions: p, q
+        using Windows = Or<Since<0, 5, P<0>, P<1>>, And<Historically<2, 7, P<0>>, Once<1, 20, P<1>>>>;
+        REQUIRE(matchesInterpreter<Windows>("({p} since[0:5] {q}) || (historically[2:7]{p} && once[1:20]{q})"));
+    }
+
+    SECTION("Bounds next to infinity") {
+        // Propositions: p, q. The window ends saturate instead of overflowing.
+        using Wide = And<Once<0, INF - 1, P<0>>, Historically<3, INF - 1, P<1>>>;
+        const std::string bound = std::to_string(INF - 1);
+        REQUIRE(matchesInterpreter<Wide>("once[:" + bound + "]{p} && historically[3:" + bound + "]{q}"));
+    }
+}
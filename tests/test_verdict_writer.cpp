@@ -0,0 +1,94 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_all.hpp>
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+#include <fcntl.h>
+#include <unistd.h>
+#include "do-verify/verdict_writer.hpp"
+
+using namespace verdict_writer;
+
+static const char *VERDICT_FILE = "verdict_writer_test.out";
+
+static int openVerdictFile() {
+    return open(VERDICT_FILE, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+}
+
+static std::string readVerdictFile() {
+    std::ifstream in(VERDICT_FILE, std::ios::binary);
+    std::string contents((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    in.close();
+    std::remove(VERDICT_FILE);
+    return contents;
+}
+
+TEST_CASE("Verdict Writer", "[verdict_writer]") {
+    using namespace db_interval_set;
+
+    SECTION("Dense intervals are merged across steps") {
+        IntervalSetHolder holder = newHolder(64);
+        int fd = openVerdictFile();
+        // A tiny buffer forces several flushes along the way
+        VerdictWriter writer = newVerdictWriter(fd, VerdictFormat::TEXT, VerdictMode::DENSE, 8);
+
+        writeDense(writer, createSetFromIntervals(holder, {{0, 3}, {5, 10}}));
+        writeDense(writer, createSetFromIntervals(holder, {{10, 12}}));
+        writeDense(writer, empty(holder));
+        writeDense(writer, createSetFromIntervals(holder, {{20, 25}}));
+        writeDense(writer, createSetFromIntervals(holder, {{25, 30}, {31, 32}}));
+        finishVerdicts(writer);
+        close(fd);
+
+        REQUIRE(writer.failed == false);
+        REQUIRE(readVerdictFile() == "[0, 3)\n[5, 12)\n[20, 30)\n[31, 32)\n");
+        destroyHolder(holder);
+    }
+
+    SECTION("Discrete verdicts are run-length encoded") {
+        int fd = openVerdictFile();
+        VerdictWriter writer = newVerdictWriter(fd, VerdictFormat::TEXT, VerdictMode::DISCRETE, 1024);
+        std::vector<bool> verdicts{true, true, true, false, false, true};
+        for (size_t i = 0; i < verdicts.size(); i++) {
+            writeDiscrete(writer, static_cast<int>(i * 10), verdicts[i]);
+        }
+        finishVerdicts(writer);
+        close(fd);
+
+        REQUIRE(readVerdictFile() == "[0, 20] true\n[30, 40] false\n[50, 50] true\n");
+    }
+
+    SECTION("Binary records") {
+        int fd = openVerdictFile();
+        VerdictWriter writer = newVerdictWriter(fd, VerdictFormat::BINARY, VerdictMode::DISCRETE, 16);
+        for (int time = 0; time < 1000; time++) {
+            writeDiscrete(writer, time, time >= 400);
+        }
+        finishVerdicts(writer);
+        close(fd);
+
+        // Records are two times and a verdict byte, the times as wide as Time
+        const size_t timeBytes = sizeof(db_interval_set::Time);
+        const size_t recordBytes = 2 * timeBytes + 1;
+        std::string bytes = readVerdictFile();
+        REQUIRE(bytes.size() == 8 + 2 * recordBytes);
+        REQUIRE(bytes.compare(0, 4, "DVVD") == 0);
+        uint16_t version, mode;
+        std::memcpy(&version, bytes.data() + 4, sizeof(version));
+        std::memcpy(&mode, bytes.data() + 6, sizeof(mode));
+        REQUIRE(version == (timeBytes == sizeof(int64_t) ? VERDICT_VERSION_TIME64 : VERDICT_VERSION));
+        REQUIRE(mode == static_cast<uint16_t>(VerdictMode::DISCRETE));
+
+        db_interval_set::Time first, last;
+        std::memcpy(&first, bytes.data() + 8 + recordBytes, sizeof(first));
+        std::memcpy(&last, bytes.data() + 8 + recordBytes + timeBytes, sizeof(last));
+        REQUIRE(first == 400);
+        REQUIRE(last == 999);
+        REQUIRE(bytes[8 + 2 * recordBytes - 1] == 1);
+    }
+}